@@ -0,0 +1,119 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <MACE/Graphics/Components.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace mc;
+
+namespace {
+	//how many times each ease is evaluated per pass
+	const Size SAMPLES = 1 << 20;
+	const Size PASSES = 8;
+
+	//stops the compiler from throwing away eases whose results are never used
+	volatile float sink = 0.0f;
+
+	using Clock = std::chrono::steady_clock;
+
+	std::vector<float> progress = std::vector<float>();
+	std::vector<float> out = std::vector<float>();
+
+	double getNanoseconds(const Clock::time_point start) {
+		return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(SAMPLES * PASSES);
+	}
+
+	template<float(*Function)(float, const float, const float, const float), Size Resolution = 256>
+	void benchmark(const char* name) {
+		//the table is built outside of the timing
+		gfx::EaseTable<Function, Resolution>::getValues();
+
+		Clock::time_point start = Clock::now();
+		for (Index pass = 0; pass < PASSES; ++pass) {
+			for (Index i = 0; i < SAMPLES; ++i) {
+				out[i] = Function(progress[i], 0.0f, 1.0f, 1.0f);
+			}
+			sink = sink + out[pass];
+		}
+		const double exact = getNanoseconds(start);
+
+		start = Clock::now();
+		for (Index pass = 0; pass < PASSES; ++pass) {
+			gfx::EaseTable<Function, Resolution>::get(progress.data(), out.data(), SAMPLES);
+			sink = sink + out[pass];
+		}
+		const double table = getNanoseconds(start);
+
+		float error = 0.0f;
+		for (Index i = 0; i < SAMPLES; ++i) {
+			error = std::max(error, std::abs(gfx::EaseTable<Function, Resolution>::get(progress[i]) - Function(progress[i], 0.0f, 1.0f, 1.0f)));
+		}
+
+		std::cout << std::left << std::setw(20) << name << std::right << std::fixed
+			<< std::setprecision(2) << std::setw(12) << exact
+			<< std::setw(12) << table
+			<< std::setw(10) << exact / table << 'x'
+			<< std::scientific << std::setprecision(3) << std::setw(14) << error << std::endl;
+	}
+}//anon namespace
+
+#define MACE__BENCHMARK_EASE(name) benchmark<gfx::EaseFunctions::name>(#name)
+
+int main() {
+	progress.resize(SAMPLES);
+	out.resize(SAMPLES);
+
+	//shuffled so every lookup isn't next to the last one
+	for (Index i = 0; i < SAMPLES; ++i) {
+		progress[i] = static_cast<float>((i * 7919) % SAMPLES) / static_cast<float>(SAMPLES - 1);
+	}
+
+	std::cout << "Comparing every EaseFunction to an EaseTable with 256 segments, in nanoseconds per ease" << std::endl;
+	std::cout << std::left << std::setw(20) << "Function" << std::right
+		<< std::setw(12) << "Exact"
+		<< std::setw(12) << "Table"
+		<< std::setw(11) << "Speedup"
+		<< std::setw(14) << "Max error" << std::endl;
+
+	MACE__BENCHMARK_EASE(LINEAR);
+	MACE__BENCHMARK_EASE(BACK_IN);
+	MACE__BENCHMARK_EASE(BACK_OUT);
+	MACE__BENCHMARK_EASE(BACK_IN_OUT);
+	MACE__BENCHMARK_EASE(BOUNCE_OUT);
+	MACE__BENCHMARK_EASE(BOUNCE_IN);
+	MACE__BENCHMARK_EASE(BOUNCE_IN_OUT);
+	MACE__BENCHMARK_EASE(CIRCLE_IN);
+	MACE__BENCHMARK_EASE(CIRCLE_OUT);
+	MACE__BENCHMARK_EASE(CIRCLE_IN_OUT);
+	MACE__BENCHMARK_EASE(CUBIC_IN);
+	MACE__BENCHMARK_EASE(CUBIC_OUT);
+	MACE__BENCHMARK_EASE(CUBIC_IN_OUT);
+	MACE__BENCHMARK_EASE(ELASTIC_IN);
+	MACE__BENCHMARK_EASE(ELASTIC_OUT);
+	MACE__BENCHMARK_EASE(ELASTIC_IN_OUT);
+	MACE__BENCHMARK_EASE(EXPONENTIAL_IN);
+	MACE__BENCHMARK_EASE(EXPONENTIAL_OUT);
+	MACE__BENCHMARK_EASE(EXPONENTIAL_IN_OUT);
+	MACE__BENCHMARK_EASE(QUADRATIC_IN);
+	MACE__BENCHMARK_EASE(QUADRATIC_OUT);
+	MACE__BENCHMARK_EASE(QUADRATIC_IN_OUT);
+	MACE__BENCHMARK_EASE(QUARTIC_IN);
+	MACE__BENCHMARK_EASE(QUARTIC_OUT);
+	MACE__BENCHMARK_EASE(QUARTIC_IN_OUT);
+	MACE__BENCHMARK_EASE(QUINTIC_IN);
+	MACE__BENCHMARK_EASE(QUINTIC_OUT);
+	MACE__BENCHMARK_EASE(QUINTIC_IN_OUT);
+	MACE__BENCHMARK_EASE(SINUSOIDAL_IN);
+	MACE__BENCHMARK_EASE(SINUSOIDAL_OUT);
+	MACE__BENCHMARK_EASE(SINUSOIDAL_IN_OUT);
+
+	return sink == 0.0f ? 0 : 0;
+}
@@ -261,6 +261,15 @@ See LICENSE.md for full copyright information
 #	define MACE_OPENCV 1
 #endif
 
+//whether SSE2 intrinsics from <emmintrin.h> can be used
+#ifdef MACE_SSE
+#	if !MACE_SSE
+#		undef MACE_SSE
+#	endif
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(MACE__DOXYGEN_PASS)
+#	define MACE_SSE 1
+#endif
+
 //meaning doxygen is currently parsing this file
 #ifdef MACE__DOXYGEN_PASS
 #	define MACE_EXPOSE_ALL 1
@@ -11,6 +11,7 @@ See LICENSE.md for full copyright information
 #include <MACE/Core/Error.h>
 #include <MACE/Core/Interfaces.h>
 #include <MACE/Core/Instance.h>
+#include <MACE/Core/Jobs.h>
 #include <MACE/Core/System.h>
 
 #endif
\ No newline at end of file
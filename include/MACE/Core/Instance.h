@@ -9,6 +9,8 @@ See LICENSE.md for full copyright information
 
 #include <MACE/Core/Constants.h>
 #include <MACE/Core/Interfaces.h>
+#include <MACE/Core/Jobs.h>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -279,6 +281,27 @@ namespace mc {
 		*/
 		bool getFlag(const Flag flag) const;
 
+		/**
+		Retrieves the `JobSystem` shared by every `Module`. It is created by `init()` and stopped by `destroy()`, after
+		every `Module` was destroyed.
+		<p>
+		While `init()`, `update()` and `destroy()` run, it is also returned by `JobSystem::getCurrent()`, so code that doesn't
+		know about its `Instance` can use it.
+		@throw InitializationError if `init()` has not been called yet or `destroy()` has been called.
+		@see setJobConfig(const JobSystem::Config&)
+		*/
+		JobSystem& getJobSystem();
+		/**
+		@copydoc Instance::getJobSystem()
+		*/
+		const JobSystem& getJobSystem() const;
+
+		/**
+		Sets how the `JobSystem` is started by the next `init()`
+		*/
+		void setJobConfig(const JobSystem::Config& config);
+		const JobSystem::Config& getJobConfig() const;
+
 		/**
 		"Resets" the `MACE` to its default state. `Modules` are cleared, and all flags are set to 0.
 		*/
@@ -296,6 +319,9 @@ namespace mc {
 		Stores various flags for the MACE, like whether it is running, or a close is requested.
 		*/
 		Byte flags = 0;
+
+		std::unique_ptr<JobSystem> jobs = nullptr;
+		JobSystem::Config jobConfig = JobSystem::Config();
 	};
 }
 
@@ -0,0 +1,172 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#pragma once
+#ifndef MACE__CORE_JOBS_H
+#define MACE__CORE_JOBS_H
+
+#include <MACE/Core/Constants.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mc {
+	class JobSystem;
+
+	/**
+	A function that is run by a `JobSystem`.
+	<p>
+	A `Job` can have children, which are created with it as their parent. It is only done once its function
+	returned and every child is done, so waiting on a parent waits for everything below it.
+	@see JobSystem::create()
+	@see JobSystem::wait()
+	*/
+	class Job {
+		friend class JobSystem;
+	public:
+		using Function = std::function<void()>;
+
+		/**
+		@return Whether the function of this `Job` and those of all of its children have returned
+		*/
+		bool isDone() const;
+	private:
+		Function function;
+		std::shared_ptr<Job> parent;
+
+		//the function itself and every child that isn't done
+		std::atomic<Size> unfinished{1};
+
+		//the first exception thrown by it or a child, guarded by the errorMutex of its JobSystem
+		std::exception_ptr error{};
+	};//Job
+
+	using JobHandle = std::shared_ptr<Job>;
+
+	/**
+	Runs `Jobs` on a fixed set of worker threads, so every `Module` can share them instead of starting its own.
+	<p>
+	Every worker has its own queue. A worker runs the newest `Job` in its own queue first, as it is most likely to
+	still be in the cache, and takes the oldest `Job` from another queue when its own is empty. Threads that
+	aren't workers share a queue of their own.
+	<p>
+	`wait()` runs other `Jobs` until the one it is waiting on is done, instead of blocking. `Jobs` can therefore
+	wait on their children, and the thread that waits is one more thread doing work.
+	<p>
+	Every `Instance` owns one, which is started by `Instance::init()`.
+	@see Instance::getJobSystem()
+	@see JobSystem::getCurrent()
+	*/
+	class JobSystem {
+	public:
+		struct Config {
+			/**
+			How many threads to start. If it is `0`, there is one less worker than the hardware has threads, as the thread
+			calling `wait()` does work as well.
+			*/
+			unsigned int workers = 0;
+			/**
+			Whether every worker is pinned to its own core, so the operating system doesn't move it around. It is only
+			worth it when nothing else is competing for the cores.
+			*/
+			bool pinWorkers = false;
+		};
+
+		JobSystem();
+		explicit JobSystem(const Config& config);
+		/**
+		Stops and joins every worker. `Jobs` that haven't started are never run.
+		*/
+		~JobSystem();
+
+		JobSystem(const JobSystem& other) = delete;
+		JobSystem& operator=(const JobSystem& other) = delete;
+
+		/**
+		Creates a `Job` without running it, so children can be added to it first.
+		@param parent If it isn't `nullptr,` the new `Job` is a child of it. It must not be done yet.
+		@see run(const JobHandle&)
+		*/
+		JobHandle create(const Job::Function& function, const JobHandle& parent = nullptr);
+
+		/**
+		Queues a `Job` that was created by `create()`
+		*/
+		void run(const JobHandle& job);
+		/**
+		Creates and queues a `Job`
+		@return The new `Job,` which can be waited on
+		*/
+		JobHandle run(const Job::Function& function, const JobHandle& parent = nullptr);
+
+		/**
+		Runs other `Jobs` until `job` and all of its children are done.
+		@throws The first exception thrown by `job` or one of its children
+		*/
+		void wait(const JobHandle& job);
+
+		/**
+		Calls `function` with ranges that cover `begin` to `end`, in parallel, and waits for all of them.
+		@param batchSize The largest range that is given to `function` at once. Smaller batches balance better, but
+		every batch is a `Job`.
+		@param function Called with the beginning and end of a range
+		*/
+		void parallelFor(const Index begin, const Index end, const Size batchSize, const std::function<void(Index, Index)>& function);
+
+		/**
+		@return How many workers were started. Not counting threads that call `wait()`
+		*/
+		unsigned int getWorkerCount() const;
+
+		/**
+		@return The `JobSystem` of the worker calling this, or the one set with `setCurrent()` by a thread that isn't a worker,
+		or `nullptr` if there isn't any
+		*/
+		static JobSystem* getCurrent();
+		/**
+		Sets the `JobSystem` returned by `getCurrent()` on this thread. `Instance` does it for the thread it is updated on.
+		*/
+		static void setCurrent(JobSystem* jobs);
+	private:
+		struct Queue {
+			std::mutex mutex{};
+			std::deque<JobHandle> jobs{};
+		};
+
+		//the first queue is shared by every thread that isn't a worker
+		std::vector<std::unique_ptr<Queue>> queues{};
+		std::vector<std::thread> workers{};
+
+		//how many jobs are in all of the queues, only changed while holding the mutex of a queue
+		std::atomic<Size> queued{0};
+		std::atomic<bool> running{true};
+
+		std::mutex sleepMutex{};
+		std::condition_variable wake{};
+
+		std::mutex errorMutex{};
+
+		void work(const Index queue);
+
+		/**
+		@return The newest job in `queue,` or the oldest one in any other queue, or `nullptr` if every queue is empty
+		*/
+		JobHandle take(const Index queue);
+
+		void execute(const JobHandle& job);
+		void finish(Job* job);
+
+		Index getQueue() const;
+	};//JobSystem
+}//mc
+
+#endif//MACE__CORE_JOBS_H
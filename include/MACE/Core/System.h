@@ -82,6 +82,19 @@ namespace mc {
 
 		const char* strerror(char* buf, std::size_t bufsize, int errnum) MACE_EXPECTS(buf != nullptr);
 
+		/**
+		Maps a whole file into memory as read only. The system loads pages as they are read, so nothing is copied
+		up front, and the memory is shared with anything else that maps the same file.
+		<p>
+		Reads the whole file instead on systems without memory mapping.
+		@param size Where the size of the file in bytes is written
+		@return The contents of the file, which must be released with `unmapFile()`
+		@throws FileNotFound If the file can't be opened
+		@throws BadFile If the file is empty or can't be mapped
+		*/
+		const Byte* mapFile(const char* path, Size* size) MACE_EXPECTS(path != nullptr && size != nullptr) MACE_ENSURES(ret, ret != nullptr);
+		void unmapFile(const Byte* data, const Size size) MACE_EXPECTS(data != nullptr);
+
 		void clearError(const unsigned int lineNumber = 0, const char* filename = "Unknown file") MACE_EXPECTS(filename != nullptr);
 		void checkError(const unsigned int lineNumber = 0, const char* filename = "Unknown file", const std::string message = "Unknown message") MACE_EXPECTS(filename != nullptr && !message.empty());
 
@@ -0,0 +1,233 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#pragma once
+#ifndef MACE__GRAPHICS_COMPONENTSTORE_H
+#define MACE__GRAPHICS_COMPONENTSTORE_H
+
+#include <MACE/Core/Constants.h>
+#include <MACE/Core/Error.h>
+#include <MACE/Utility/Pool.h>
+
+#include <memory>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mc {
+	namespace gfx {
+		class Entity;
+
+		/**
+		Updates every component of a single type at once.
+		<p>
+		Unlike a `Component`, which is updated one virtual call at a time by its `Entity`, a system keeps all of its
+		components in contiguous arrays and goes over them in one pass. Systems are opt in, and live in a `ComponentStore`.
+		@see ComponentArray
+		@see ComponentStore
+		@see EaseSystem
+		@see TweenSystem
+		*/
+		class MACE_NOVTABLE ComponentSystem {
+		public:
+			virtual ~ComponentSystem() = default;
+
+			/**
+			Called once per frame by `ComponentStore::update()`
+			*/
+			virtual void update() = 0;
+
+			/**
+			@return How many components this system has
+			*/
+			virtual Size size() const = 0;
+		};//ComponentSystem
+
+		/**
+		Densely packed storage for the components of a `ComponentSystem`.
+		<p>
+		Components are kept in one `std::vector` in no particular order, with the `Entity` each one belongs to in another.
+		Removing one moves the last component into its place, so the arrays never have holes. Components are referred
+		to with a `PoolHandle`, which stays valid while they move around.
+		@tparam T The data of a component
+		*/
+		template<typename T>
+		class ComponentArray {
+		public:
+			using Handle = PoolHandle;
+
+			Handle add(Entity* owner, T value) {
+				Index slot;
+				if (freeSlots.empty()) {
+					slot = slots.size();
+					slots.push_back(Slot());
+				} else {
+					slot = freeSlots.back();
+					freeSlots.pop_back();
+				}
+
+				slots[slot].dense = data.size();
+
+				data.push_back(std::move(value));
+				owners.push_back(owner);
+				denseSlots.push_back(slot);
+
+				Handle out = Handle();
+				out.index = slot;
+				out.generation = slots[slot].generation;
+				return out;
+			}
+
+			/**
+			@throws ObjectNotFoundError If `handle` was already removed
+			*/
+			void remove(const Handle handle) {
+				if (!isValid(handle)) {
+					MACE__THROW(ObjectNotFound, "Handle passed to ComponentArray::remove() isn\'t valid");
+				}
+
+				removeAt(slots[handle.index].dense);
+			}
+
+			/**
+			Removes the component at `position` in `getData()`. The last component takes its place.
+			*/
+			void removeAt(const Index position) {
+				const Index last = data.size() - 1;
+				const Index slot = denseSlots[position];
+
+				if (position != last) {
+					data[position] = std::move(data[last]);
+					owners[position] = owners[last];
+					denseSlots[position] = denseSlots[last];
+					slots[denseSlots[position]].dense = position;
+				}
+
+				data.pop_back();
+				owners.pop_back();
+				denseSlots.pop_back();
+
+				slots[slot].dense = NONE;
+				++slots[slot].generation;
+				freeSlots.push_back(slot);
+			}
+
+			bool isValid(const Handle handle) const {
+				return handle.index < slots.size() && slots[handle.index].generation == handle.generation && slots[handle.index].dense != NONE;
+			}
+
+			/**
+			@return The component `handle` refers to, or `nullptr` if it was removed. The pointer is only valid until the
+			next time a component is added or removed.
+			*/
+			T* get(const Handle handle) {
+				return isValid(handle) ? &data[slots[handle.index].dense] : nullptr;
+			}
+
+			/**
+			@copydoc ComponentArray::get(const Handle)
+			*/
+			const T* get(const Handle handle) const {
+				return isValid(handle) ? &data[slots[handle.index].dense] : nullptr;
+			}
+
+			/**
+			@return Where the component `handle` refers to is in `getData()`
+			*/
+			Index getPosition(const Handle handle) const {
+				return slots[handle.index].dense;
+			}
+
+			/**
+			@return A handle to the component at `position` in `getData()`
+			*/
+			Handle getHandle(const Index position) const {
+				Handle out = Handle();
+				out.index = denseSlots[position];
+				out.generation = slots[out.index].generation;
+				return out;
+			}
+
+			std::vector<T>& getData() {
+				return data;
+			}
+
+			const std::vector<T>& getData() const {
+				return data;
+			}
+
+			/**
+			@return The `Entity` of every component, in the same order as `getData()`
+			*/
+			const std::vector<Entity*>& getOwners() const {
+				return owners;
+			}
+
+			Size size() const {
+				return data.size();
+			}
+		private:
+			static MACE_CONSTEXPR const Index NONE = static_cast<Index>(-1);
+
+			struct Slot {
+				Index dense = NONE;
+				unsigned int generation = 0;
+			};
+
+			std::vector<T> data{};
+			std::vector<Entity*> owners{};
+			//which slot every component belongs to, so the slot can be updated when it moves
+			std::vector<Index> denseSlots{};
+
+			std::vector<Slot> slots{};
+			std::vector<Index> freeSlots{};
+		};//ComponentArray
+
+		template<typename T>
+		MACE_CONSTEXPR const Index ComponentArray<T>::NONE;
+
+		/**
+		Owns a `ComponentSystem` of every type that was asked for, and updates all of them at once.
+		<p>
+		Every `WindowModule` has one, which is updated right before its `Entities`.
+		@see WindowModule::getComponentStore()
+		*/
+		class ComponentStore {
+		public:
+			/**
+			@return The system of type `S`. It is created the first time it is asked for.
+			*/
+			template<typename S>
+			S& getSystem() {
+				const std::type_index type = std::type_index(typeid(S));
+
+				std::unordered_map<std::type_index, ComponentSystem*>::iterator iter = types.find(type);
+				if (iter == types.end()) {
+					systems.push_back(std::unique_ptr<ComponentSystem>(new S()));
+					iter = types.emplace(type, systems.back().get()).first;
+				}
+
+				return *static_cast<S*>(iter->second);
+			}
+
+			/**
+			Updates every system, in the order they were created
+			*/
+			void update();
+
+			/**
+			@return How many components are in every system combined
+			*/
+			Size size() const;
+		private:
+			std::vector<std::unique_ptr<ComponentSystem>> systems{};
+			std::unordered_map<std::type_index, ComponentSystem*> types{};
+		};//ComponentStore
+	}//gfx
+}//mc
+
+#endif//MACE__GRAPHICS_COMPONENTSTORE_H
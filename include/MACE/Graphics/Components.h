@@ -10,10 +10,14 @@ See LICENSE.md for full copyright information
 #include <MACE/Graphics/Entity.h>
 #include <MACE/Graphics/Renderer.h>
 #include <MACE/Graphics/Context.h>
+#include <MACE/Graphics/ComponentStore.h>
 
+#include <algorithm>
 #include <chrono>
 #include <queue>
 #include <functional>
+#include <memory>
+#include <vector>
 
 namespace mc {
 	namespace gfx {
@@ -45,6 +49,7 @@ namespace mc {
 		/**
 		Different easing functions commonly found in applications
 		@see EaseFunction
+		@see EaseTable
 		*/
 		namespace EaseFunctions {
 			/*MACE__MAKE_EASE_FUNCTION creates function declaration for an ease function of name.
@@ -92,6 +97,82 @@ namespace mc {
 #endif
 		}
 
+		/**
+		Samples an ease function into a table once, and interpolates between the samples instead of calling it.
+		<p>
+		Functions such as `EaseFunctions::ELASTIC_OUT` call `std::pow` and `std::sin` every time they are evaluated.
+		The table is built the first time it is used, after which an ease is a lookup and a linear interpolation that
+		can be inlined. `ease()` has the same signature as the functions in `EaseFunctions`, so it can be used as
+		`EaseSettings::ease`, including with `TweenSystem`.
+		<p>
+		Only functions that are expensive to evaluate, such as the elastic, exponential and sinusoidal ones, are faster
+		as a table. Polynomials like `EaseFunctions::QUADRATIC_IN` take about as long to evaluate as to look up. The
+		error depends on how curved the function is between samples, so functions with sharp corners, such as
+		`EaseFunctions::BOUNCE_OUT`, need a higher `Resolution` to be as accurate as the rest. The `EaseBenchmark` demo
+		prints the speed and error of every function.
+		@tparam Function The function to sample, from `t = 0` to `t = 1`
+		@tparam Resolution How many segments the table is split into
+		@see EaseFunctions
+		*/
+		template<float(*Function)(float, const float, const float, const float), Size Resolution = 256>
+		class EaseTable {
+			static_assert(Resolution > 0, "An EaseTable needs at least 1 segment");
+		public:
+			/**
+			@copydoc EaseFunction
+			*/
+			static float ease(float t, const float b, const float c, const float d) {
+				return b + c * get(t / d);
+			}
+
+			/**
+			@param progress How far along the ease is. It is clamped from 0 to 1.
+			@return The same thing as `Function(progress, 0, 1, 1)`, give or take the error of the table
+			*/
+			static float get(const float progress) {
+				return lookup(getValues(), progress);
+			}
+
+			/**
+			Eases `count` values at once, without calling anything through a pointer
+			@see get(const float)
+			*/
+			static void get(const float* progress, float* out, const Size count) {
+				const float* values = getValues();
+				for (Index i = 0; i < count; ++i) {
+					out[i] = lookup(values, progress[i]);
+				}
+			}
+
+			/**
+			@return The `Resolution + 1` samples, from `t = 0` to `t = 1`
+			*/
+			static const float* getValues() {
+				//function statics are initialized once, even with multiple threads
+				static const Table table = Table();
+				return table.values;
+			}
+		private:
+			struct Table {
+				float values[Resolution + 1];
+
+				Table() {
+					for (Index i = 0; i <= Resolution; ++i) {
+						values[i] = Function(static_cast<float>(i) / static_cast<float>(Resolution), 0.0f, 1.0f, 1.0f);
+					}
+				}
+			};
+
+			static float lookup(const float* values, const float progress) {
+				const float position = std::min(std::max(progress, 0.0f), 1.0f) * static_cast<float>(Resolution);
+				//the last sample is only ever the end of a segment
+				const Index segment = std::min(static_cast<Index>(position), Resolution - 1);
+				const float fraction = position - static_cast<float>(segment);
+
+				return values[segment] + (values[segment + 1] - values[segment]) * fraction;
+			}
+		};//EaseTable
+
 		class MACE_NOVTABLE Progressable {
 		public:
 			virtual ~Progressable() = default;
@@ -237,6 +318,228 @@ namespace mc {
 			Entity* const entity;
 		};
 
+		/**
+		Does the same thing as many `EaseComponents`, but as a `ComponentSystem`.
+		<p>
+		Every ease is stored in one array and updated in a single pass, and the clock is only read once per update
+		instead of once per ease. Prefer this when there are a lot of eases at once.
+		@see ComponentStore::getSystem()
+		*/
+		class EaseSystem: public ComponentSystem {
+		public:
+			using Handle = PoolHandle;
+
+			/**
+			Starts an ease. `callback` is called with `entity` and the eased value every update, like `EaseComponent`.
+			@return A handle to the ease. It becomes invalid once the ease is done or removed.
+			*/
+			Handle add(Entity* const entity, const EaseComponent::EaseUpdateCallback callback, const EaseSettings settings = EaseSettings(), const float start = 0.0f, const float dest = 1.0f);
+
+			/**
+			Stops an ease without calling `EaseSettings::done`
+			@throws ObjectNotFoundError If the ease was already done or removed
+			*/
+			void remove(const Handle handle);
+
+			bool isEasing(const Handle handle) const;
+
+			/**
+			@return How far an ease is through its current repetition, from 0 to 1
+			@throws ObjectNotFoundError If the ease was already done or removed
+			*/
+			float getProgress(const Handle handle) const;
+
+			/**
+			Advances every ease by the time since the last update
+			*/
+			void update() override;
+
+			/**
+			Advances every ease by `seconds`. Eases added before the first call to `update()` start at the next call to
+			this, no matter how long ago the system last advanced.
+			*/
+			void advance(const float seconds);
+
+			Size size() const override;
+		private:
+			//settings and callbacks aren't needed to advance time, so they are kept out of the way in a Pool.
+			//that also means callbacks can add eases while they are running without moving themselves
+			struct Callbacks {
+				EaseSettings settings;
+				EaseComponent::EaseUpdateCallback update;
+			};
+
+			struct Ease {
+				float elapsed;
+				float duration;
+				float progress;
+				float start;
+				float destination;
+				signed long repetition;
+				PoolHandle callbacks;
+			};
+
+			ComponentArray<Ease> eases{};
+			Pool<Callbacks> callbacks;
+
+			std::chrono::time_point<std::chrono::steady_clock> lastUpdate = std::chrono::steady_clock::now();
+			//lastUpdate only means anything once update() drives the system, instead of calling advance() directly
+			bool updated = false;
+
+			//eases can't be moved around while advance() is running, so removing them waits until it finishes
+			std::vector<Handle> removed{};
+			bool advancing = false;
+
+			void erase(const Handle handle);
+		};//EaseSystem
+
+		/**
+		Tweens floats, `Progressables`, and the transformations of `Entities` in bulk, without any callbacks per frame.
+		<p>
+		Tweens are grouped by their ease function, and every group keeps its times and values in separate arrays which
+		are advanced with SIMD where it is available. The clock is read once per update, and the ease function of a
+		group is called directly instead of through a `std::function`. Finished tweens are swapped with the last one in
+		their group, and their handles are reused, so adding and removing tweens doesn't go through the heap once the
+		system has grown to its peak size.
+		<p>
+		Only plain functions, such as the ones in `EaseFunctions`, can be used as `EaseSettings::ease`. Use `EaseSystem`
+		for anything else. Whatever a tween writes to must outlive it, or be removed with `remove()` first.
+		@see ComponentStore::getSystem()
+		*/
+		class TweenSystem: public ComponentSystem {
+		public:
+			using Handle = PoolHandle;
+			using Curve = float(*)(float, const float, const float, const float);
+
+			/**
+			Tweens `*value` from `start` to `dest`
+			@return A handle to the tween. It becomes invalid once the tween is done or removed.
+			@throws InvalidTypeError If `settings.ease` isn't a plain function
+			*/
+			Handle add(float* const value, const float start, const float dest, const EaseSettings settings = EaseSettings());
+			/**
+			Tweens the progress of `progressable` from `start` to `dest` with `Progressable::setProgress()`
+			@copydetails TweenSystem::add(float* const, const float, const float, const EaseSettings)
+			*/
+			Handle add(Progressable* const progressable, const float start, const float dest, const EaseSettings settings = EaseSettings());
+			/**
+			Tweens the transformation of `entity`, like `TweenComponent`. `EaseSettings::done` is called with `entity`.
+			@copydetails TweenSystem::add(float* const, const float, const float, const EaseSettings)
+			*/
+			Handle add(Entity* const entity, const TransformMatrix& start, const TransformMatrix& dest, const EaseSettings settings = EaseSettings());
+			/**
+			Tweens the transformation of `entity` from what it is now
+			@copydetails TweenSystem::add(float* const, const float, const float, const EaseSettings)
+			*/
+			Handle add(Entity* const entity, const TransformMatrix& dest, const EaseSettings settings = EaseSettings());
+
+			/**
+			Stops a tween without calling `EaseSettings::done`
+			@throws ObjectNotFoundError If the tween was already done or removed
+			*/
+			void remove(const Handle handle);
+
+			bool isTweening(const Handle handle) const;
+
+			/**
+			@return How far a tween is through its current repetition, from 0 to 1
+			@throws ObjectNotFoundError If the tween was already done or removed
+			*/
+			float getProgress(const Handle handle) const;
+
+			/**
+			Advances every tween by the time since the last update
+			*/
+			void update() override;
+
+			/**
+			Advances every tween by `seconds`. Tweens added before the first call to `update()` start at the next call to
+			this, no matter how long ago the system last advanced.
+			*/
+			void advance(const float seconds);
+
+			Size size() const override;
+
+			/**
+			@return How many different ease functions have been used. Groups are kept once they are empty.
+			*/
+			Size getGroupCount() const;
+		private:
+			enum class Binding: Byte {
+				FLOAT,
+				PROGRESSABLE,
+				TRANSFORM
+			};
+
+			struct Transforms {
+				TransformMatrix start, destination;
+			};
+
+			//only needed once a value has been eased, so it is kept apart from the arrays that are advanced
+			struct Tween {
+				Binding binding = Binding::FLOAT;
+				float* value = nullptr;
+				Progressable* progressable = nullptr;
+				Entity* entity = nullptr;
+				PoolHandle transforms{};
+
+				signed long repetition = 0, repeats = 1;
+				bool reverseOnRepeat = false;
+
+				EaseSettings::EaseDoneCallback done;
+
+				Index slot;
+			};
+
+			struct Group {
+				Curve curve;
+
+				//every array has one element per tween, in the same order
+				std::vector<float> elapsed{};
+				std::vector<float> rate{};
+				std::vector<float> progress{};
+				std::vector<float> start{};
+				std::vector<float> change{};
+				std::vector<float> value{};
+
+				std::vector<Tween> tweens{};
+
+				Size size() const;
+				void removeAt(const Index position);
+			};
+
+			struct Slot {
+				Index group = static_cast<Index>(-1);
+				Index position = static_cast<Index>(-1);
+				unsigned int generation = 0;
+			};
+
+			std::vector<std::unique_ptr<Group>> groups{};
+
+			std::vector<Slot> slots{};
+			std::vector<Index> freeSlots{};
+			Size tweenCount = 0;
+
+			Pool<Transforms> transforms;
+
+			std::chrono::time_point<std::chrono::steady_clock> lastUpdate = std::chrono::steady_clock::now();
+			//lastUpdate only means anything once update() drives the system, instead of calling advance() directly
+			bool updated = false;
+
+			//tweens can't be moved around while advance() is running, so removing them waits until it finishes
+			std::vector<Handle> removed{};
+			bool advancing = false;
+			//kept between updates so finishing tweens doesn't allocate
+			std::vector<Handle> finished{};
+
+			Handle insert(Tween tween, const float start, const float dest, const EaseSettings& settings);
+			void erase(const Handle handle);
+
+			const Slot* getSlot(const Handle handle) const;
+
+			void apply(Group& group, const Index position);
+		};//TweenSystem
+
 		class CallbackComponent: public Component {
 		public:
 			using CallbackPtr = std::function<void(Entity*)>;
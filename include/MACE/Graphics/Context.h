@@ -12,9 +12,13 @@ See LICENSE.md for full copyright information
 #include <MACE/Graphics/Window.h>
 #include <MACE/Utility/Color.h>
 #include <memory>
-#include <map>
+#include <deque>
+#include <unordered_map>
 #include <string>
 #include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 
 #ifdef MACE_OPENCV
 #	include <opencv2/opencv.hpp>
@@ -23,6 +27,7 @@ See LICENSE.md for full copyright information
 namespace mc {
 	namespace gfx {
 		class Renderer;
+		class Path;
 
 		/**
 		Thrown when an error occured trying to read or write an image
@@ -97,6 +102,7 @@ namespace mc {
 		};
 
 		class Model: public Initializable, public Bindable {
+			friend class GraphicsContext;
 		public:
 			static Model& getQuad();
 
@@ -136,6 +142,16 @@ namespace mc {
 
 			bool isCreated() const;
 
+#ifdef MACE_EXPOSE_OPENGL
+			std::shared_ptr<ModelImpl> getImpl() {
+				return model;
+			}
+
+			const std::shared_ptr<ModelImpl> getImpl() const {
+				return model;
+			}
+#endif
+
 			bool operator==(const Model& other) const;
 			bool operator!=(const Model& other) const;
 		private:
@@ -250,6 +266,7 @@ namespace mc {
 			virtual bool isCreated() const = 0;
 
 			virtual void setData(const void* data, const int mipmap) = 0;
+			virtual void setSubData(const void* data, const unsigned int x, const unsigned int y, const unsigned int width, const unsigned int height, const int mipmap) = 0;
 
 			virtual void setUnpackStorageHint(const PixelStorage hint, const int value) = 0;
 			virtual void setPackStorageHint(const PixelStorage hint, const int value) = 0;
@@ -390,6 +407,13 @@ namespace mc {
 				setData(static_cast<const void*>(data[0]), mipmap);
 			}
 
+			/**
+			Replaces a rectangle of an existing `Texture` without reallocating it. `data` is in the format of the `TextureDesc`.
+			@param x Left edge of the region, in pixels
+			@param y Top edge of the region, in pixels
+			*/
+			void setSubData(const void* data, const unsigned int x, const unsigned int y, const unsigned int width, const unsigned int height, const int mipmap = 0);
+
 			void setUnpackStorageHint(const PixelStorage hint, const int value);
 			void setPackStorageHint(const PixelStorage hint, const int value);
 
@@ -414,6 +438,220 @@ namespace mc {
 
 		};//RenderTargetImpl
 
+		/**
+		Compact handle to a named resource in a `GraphicsContext`.
+		<p>
+		A name is hashed once when it is interned with `GraphicsContext::getTextureID()` or
+		`GraphicsContext::getModelID()`. Every lookup afterwards is a direct index into a dense table.
+		<p>
+		IDs are only valid for the `GraphicsContext` that created them.
+		*/
+		using ResourceID = Index;
+
+		/**
+		Dense storage of resources addressed by `ResourceID`
+		<p>
+		Slots are stored in a `std::deque` so references returned by `get()` stay valid when
+		new names are interned.
+		<p>
+		It can be iterated like the `std::map` that `GraphicsContext::getTextures()` and `GraphicsContext::getModels()`
+		used to return, where each element is a name and its resource. Names that were interned but never given a
+		resource are skipped:
+		{@code
+			for (auto& texture : context->getTextures()) {
+				std::cout << texture.first << std::endl;
+			}
+		}
+		`count()` and `at()` look resources up by name like a map does, but `find()` returns a `ResourceID` instead of an iterator.
+		*/
+		template<typename T>
+		class ResourceTable {
+		private:
+			struct Slot {
+				std::pair<const std::string, T> entry;
+				bool created = false;
+
+				Slot(const std::string& name) : entry(name, T()) {}
+			};
+
+			template<typename SlotIterator, typename Value>
+			class BasicIterator {
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = typename std::remove_const<Value>::type;
+				using difference_type = std::ptrdiff_t;
+				using pointer = Value*;
+				using reference = Value&;
+
+				BasicIterator(const SlotIterator current, const SlotIterator last) : current(current), last(last) {
+					skipEmpty();
+				}
+
+				reference operator*() const {
+					return current->entry;
+				}
+
+				pointer operator->() const {
+					return &current->entry;
+				}
+
+				BasicIterator& operator++() {
+					++current;
+					skipEmpty();
+					return *this;
+				}
+
+				BasicIterator operator++(int) {
+					BasicIterator out = *this;
+					operator++();
+					return out;
+				}
+
+				bool operator==(const BasicIterator& other) const {
+					return current == other.current;
+				}
+
+				bool operator!=(const BasicIterator& other) const {
+					return !operator==(other);
+				}
+			private:
+				SlotIterator current, last;
+
+				void skipEmpty() {
+					while (current != last && !current->created) {
+						++current;
+					}
+				}
+			};
+		public:
+			using value_type = std::pair<const std::string, T>;
+			using iterator = BasicIterator<typename std::deque<Slot>::iterator, value_type>;
+			using const_iterator = BasicIterator<typename std::deque<Slot>::const_iterator, const value_type>;
+
+			/**
+			Finds the `ResourceID` for a name, reserving an empty slot if the name has never been seen
+			*/
+			ResourceID intern(const std::string& name) {
+				const auto result = ids.emplace(name, static_cast<ResourceID>(slots.size()));
+				if (result.second) {
+					slots.emplace_back(name);
+				}
+				return result.first->second;
+			}
+
+			/**
+			Finds the `ResourceID` for a name without interning it
+			@throws ObjectNotFound If `name` has never been interned
+			*/
+			ResourceID find(const std::string& name) const {
+				const auto it = ids.find(name);
+				if (it == ids.end()) {
+					MACE__THROW(ObjectNotFound, "No resource exists with name " + name);
+				}
+				return it->second;
+			}
+
+			bool has(const ResourceID id) const {
+				return id < slots.size() && slots[id].created;
+			}
+
+			bool has(const std::string& name) const {
+				const auto it = ids.find(name);
+				return it != ids.end() && has(it->second);
+			}
+
+			/**
+			@return 1 if there is a resource with `name`, otherwise 0, like `std::map::count()`
+			*/
+			Size count(const std::string& name) const {
+				return has(name) ? 1 : 0;
+			}
+
+			T& get(const ResourceID id) {
+				if (!has(id)) {
+					MACE__THROW(ObjectNotFound, "No resource exists with ID " + std::to_string(id));
+				}
+
+				return slots[id].entry.second;
+			}
+
+			const T& get(const ResourceID id) const {
+				if (!has(id)) {
+					MACE__THROW(ObjectNotFound, "No resource exists with ID " + std::to_string(id));
+				}
+
+				return slots[id].entry.second;
+			}
+
+			/**
+			Looks up a resource by name, like `std::map::at()`
+			@throws ObjectNotFound If there is no resource with `name`
+			*/
+			T& at(const std::string& name) {
+				return get(find(name));
+			}
+
+			const T& at(const std::string& name) const {
+				return get(find(name));
+			}
+
+			/**
+			Stores a resource in the slot of an interned `ResourceID`, replacing whatever was there
+			@return A reference to the stored resource
+			@throws ObjectNotFound If `id` was never returned by `intern()`
+			*/
+			T& set(const ResourceID id, const T& resource) {
+				if (id >= slots.size()) {
+					MACE__THROW(ObjectNotFound, "No resource exists with ID " + std::to_string(id));
+				}
+
+				Slot& slot = slots[id];
+				slot.entry.second = resource;
+				slot.created = true;
+				return slot.entry.second;
+			}
+
+			template<typename F>
+			void forEach(F func) {
+				for (Slot& slot : slots) {
+					if (slot.created) {
+						func(slot.entry.second);
+					}
+				}
+			}
+
+			iterator begin() {
+				return iterator(slots.begin(), slots.end());
+			}
+
+			iterator end() {
+				return iterator(slots.end(), slots.end());
+			}
+
+			const_iterator begin() const {
+				return const_iterator(slots.begin(), slots.end());
+			}
+
+			const_iterator end() const {
+				return const_iterator(slots.end(), slots.end());
+			}
+
+			void clear() {
+				ids.clear();
+				slots.clear();
+			}
+
+			/**
+			@return How many names have been interned, including ones without a resource
+			*/
+			Size size() const {
+				return slots.size();
+			}
+		private:
+			std::unordered_map<std::string, ResourceID> ids{};
+			std::deque<Slot> slots{};
+		};//ResourceTable
+
 		class GraphicsContext: public Initializable {
 			friend class Texture;
 			friend class Model;
@@ -435,28 +673,84 @@ namespace mc {
 			gfx::WindowModule* getWindow();
 			const gfx::WindowModule* getWindow() const;
 
+			/**
+			Built-in quad spanning -1 to 1, created the first time it is requested.
+			@see Model::getQuad()
+			*/
+			Model& getQuad();
+			/**
+			@see Texture::getSolidColor()
+			*/
+			Texture& getSolidColor();
+			/**
+			@see Texture::getGradient()
+			*/
+			Texture& getGradient();
+
+			/**
+			Interns `name` into a `ResourceID`. Callers that look up the same Texture repeatedly should store the ID and use the `ResourceID` overloads.
+			*/
+			ResourceID getTextureID(const std::string& name);
+			/**
+			@copydoc GraphicsContext::getTextureID(const std::string&)
+			*/
+			ResourceID getModelID(const std::string& name);
+
+			Texture& createTexture(const ResourceID id, const Texture& texture = Texture());
 			Texture& createTexture(const std::string& name, const Texture& texture = Texture());
-			Texture& getOrCreateTexture(const std::string& name, const TextureCreateCallback create);
+			Texture& getOrCreateTexture(const ResourceID id, const TextureCreateCallback& create);
+			Texture& getOrCreateTexture(const std::string& name, const TextureCreateCallback& create);
 			Texture& getOrCreateTextureFromFile(const std::string& name, const std::string& path);
-			Model& createModel(const std::string& name, const Model& texture = Model());
-			Model& getOrCreateModel(const std::string& name, const ModelCreateCallback create);
+			Model& createModel(const ResourceID id, const Model& model = Model());
+			Model& createModel(const std::string& name, const Model& model = Model());
+			Model& getOrCreateModel(const ResourceID id, const ModelCreateCallback& create);
+			Model& getOrCreateModel(const std::string& name, const ModelCreateCallback& create);
 
+			bool hasTexture(const ResourceID id) const;
 			bool hasTexture(const std::string& name) const;
+			bool hasModel(const ResourceID id) const;
 			bool hasModel(const std::string& name) const;
 
+			void setTexture(const ResourceID id, const Texture& texture);
 			void setTexture(const std::string& name, const Texture& texture);
+			Texture& getTexture(const ResourceID id);
+			const Texture& getTexture(const ResourceID id) const;
 			Texture& getTexture(const std::string& name);
 			const Texture& getTexture(const std::string& name) const;
 
+			void setModel(const ResourceID id, const Model& model);
 			void setModel(const std::string& name, const Model& model);
+			Model& getModel(const ResourceID id);
+			const Model& getModel(const ResourceID id) const;
 			Model& getModel(const std::string& name);
 			const Model& getModel(const std::string& name) const;
 
-			std::map<std::string, Texture>& getTextures();
-			const std::map<std::string, Texture>& getTextures() const;
+			ResourceTable<Texture>& getTextures();
+			const ResourceTable<Texture>& getTextures() const;
 
-			std::map<std::string, Model>& getModels();
-			const std::map<std::string, Model>& getModels() const;
+			ResourceTable<Model>& getModels();
+			const ResourceTable<Model>& getModels() const;
+
+			/**
+			Looks up a tessellated `Path` previously stored with `storePathMesh()`
+			@param width How wide the outline is, or 0 for a fill
+			@param featherExponent The width of the anti-aliased fringe, as a power of 2
+			@param stroke Whether the mesh is of the outline or the inside
+			@return The cached `Model`, or `nullptr` if there isn't one
+			@see Painter::fillPath(const Path&)
+			*/
+			Model* findPathMesh(const Path& path, const float width, const int featherExponent, const bool stroke);
+			/**
+			Caches a tessellated `Path`. If the cache is full, every cached mesh is destroyed first.
+			@copydetails GraphicsContext::findPathMesh(const Path&, const float, const int, const bool)
+			@see MACE__PATH_MESH_CACHE_SIZE
+			*/
+			Model& storePathMesh(const Path& path, const float width, const int featherExponent, const bool stroke, const Model& model);
+			/**
+			Destroys every cached `Path` mesh
+			@opengl
+			*/
+			void clearPathMeshes();
 		protected:
 			gfx::WindowModule* window;
 
@@ -484,8 +778,17 @@ namespace mc {
 			virtual void onDestroy(gfx::WindowModule* win) = 0;
 
 		private:
-			std::map<std::string, Texture> textures{};
-			std::map<std::string, Model> models{};
+			ResourceTable<Texture> textures{};
+			ResourceTable<Model> models{};
+
+			//built-in resources are used every frame, so they skip the tables entirely
+			Model quad{};
+			Texture solidColor{}, gradient{};
+
+			//the path and settings are kept with each mesh, so paths with the same hash aren't mixed up
+			struct PathMeshEntry;
+
+			std::unordered_map<std::size_t, std::shared_ptr<PathMeshEntry>> pathMeshes{};
 		};
 	}
 }//mc
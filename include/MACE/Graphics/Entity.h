@@ -12,6 +12,7 @@ See LICENSE.md for full copyright information
 #include <MACE/Utility/Transform.h>
 #include <vector>
 #include <memory>
+#include <functional>
 
 namespace mc {
 	namespace gfx {
@@ -22,6 +23,7 @@ namespace mc {
 		class Texture;
 		class Painter;
 		class ComponentQueue;
+		class TransformHierarchy;
 
 		struct Metrics {
 			TransformMatrix transform{};
@@ -31,6 +33,43 @@ namespace mc {
 			bool operator!=(const Metrics& other) const;
 		};//Metrics
 
+		/**
+		Something the mouse did to an `Entity`, which the `Renderer` sends to `Entity::onInput()` on the render thread.
+		<p>
+		Events are only sent when something happened. `ENTER` and `LEAVE` are sent to every `Entity` that the mouse moved
+		onto or off of, including parents of the `Entity` under it, and don't bubble. The other types are sent to the
+		`Entity` under the mouse first, and then bubble up to every parent until one sets `bubbles` to `false`.
+		@see Entity::sendInput(InputEvent&)
+		*/
+		struct InputEvent {
+			enum Type: Byte {
+				//the mouse moved while it was over the Entity
+				MOVE,
+				ENTER,
+				LEAVE,
+				PRESS,
+				RELEASE,
+				SCROLL
+			};
+
+			Type type = MOVE;
+
+			//for PRESS and RELEASE, which mouse button it was, from Input::MOUSE_FIRST to Input::MOUSE_LAST
+			short int button = 0;
+			//the Input::MODIFIER flags of the keys that were held down
+			Byte modifiers = 0;
+
+			//where the mouse was, in pixels from the top left of the window. -1 if it isn't in the window
+			int x = -1, y = -1;
+
+			double scrollX = 0.0, scrollY = 0.0;
+
+			//the Entity under the mouse, which may be a child of the one receiving the event
+			Entity* target = nullptr;
+
+			bool bubbles = true;
+		};//InputEvent
+
 		/**
 		Can be plugged into an `Entity` to allow for additional functionality by listening to events. Instead of extending an existing
 		`Entity` subclass, you should prefer using a `Component` to not interfere with custom Entity::onRender() and similar functions.
@@ -46,7 +85,7 @@ namespace mc {
 		There is no function to remove a `Component` from an `Entity`. Instead, the `Component` decides when to be removed
 		from Component::update(Entity*). This makes sure that the `Component` completes whatever task it was trying to do.
 		@see Entity::addComponent(Component&)
-		@todo unit testing for clean() render() and hover()
+		@todo unit testing for clean() and render()
 		*/
 		class MACE_NOVTABLE Component: public Initializable {
 			friend class Entity;
@@ -94,11 +133,47 @@ namespace mc {
 			virtual void clean(Metrics& metrics);
 
 			/**
+			Called when the mouse moves onto the parent or one of its children.
 			@opengl
 			*/
 			virtual void hover();
 		};//Component
 
+		/**
+		Records changes to the tree of `Entities` that were made while it was being updated in parallel, so they can
+		be made once every task is done.
+		<p>
+		While `Entity::update()` runs a subtree on another thread, that thread has a current buffer. Adding or removing
+		children, killing an `Entity`, and making a root dirty are then pushed into it instead of happening immediately,
+		as they touch `Entities` that other threads may be using. Buffers are applied in the order of the children
+		they belong to, so the result doesn't depend on which thread finished first.
+		@see Entity::INDEPENDENT
+		@internal
+		*/
+		class EntityCommandBuffer {
+		public:
+			using Command = std::function<void()>;
+
+			void push(const Command& command);
+
+			/**
+			Runs every command in the order they were pushed, and clears them. Commands pushed while it is applying
+			are run as well.
+			*/
+			void apply();
+
+			bool isEmpty() const;
+			Size size() const;
+
+			/**
+			@return The buffer of the task running on this thread, or `nullptr` if changes can be made immediately
+			*/
+			static EntityCommandBuffer* getCurrent();
+			static void setCurrent(EntityCommandBuffer* buffer);
+		private:
+			std::vector<Command> commands{};
+		};//EntityCommandBuffer
+
 		/**
 		Abstract superclass for all graphical objects. Contains basic information like position, and provides a standard interface for communicating with graphical objects.
 		<p>
@@ -151,14 +226,54 @@ namespace mc {
 				*/
 				DIRTY,
 
+				/**
+				Property defining whether this `Entity` and everything below it can be updated on another thread, at the
+				same time as its siblings.
+				<p>
+				When an `Entity` has more than one independent child, they are updated in parallel before the rest of its
+				children. Their `update()` and `onUpdate()`, and those of their `Components`, must then only change their
+				own subtree. Structural changes, like `addChild()`, `removeChild()` and killing an `Entity`, are fine,
+				as they are deferred into an `EntityCommandBuffer` until every task is done.
+				@see Entity::getProperty(unsigned int)
+				*/
+				INDEPENDENT,
+
 				DEFAULT_PROPERTIES = 0x00
 			};//EntityProperty
 
+			/**
+			How `removeChild()` keeps the children of an `Entity` together. Every child knows its own index, so finding
+			it with `indexOf()`, `hasChild()` or `removeChild(const Entity&)` doesn't depend on this.
+			@see Entity::setChildOrder(const ChildOrder)
+			*/
+			enum class ChildOrder: Byte {
+				/**
+				Removing a child moves every child after it down by one, so the order never changes. Removing one is
+				linear in the amount of children after it.
+				*/
+				ORDERED,
+				/**
+				Removing a child moves the last one into its place. Removing one takes constant time, but the order of the
+				children changes.
+				*/
+				UNORDERED,
+				/**
+				Removing a child leaves a `nullptr` in its place, and every hole is closed at once by `compactChildren()`,
+				which `update()` calls. Removing one takes constant time and the order never changes, but `size()` and
+				`operator[]` see the holes until then.
+				*/
+				DEFERRED
+			};
+
 			/**
 			Default constructor. Constructs properties based on `Entity::DEFAULT_PROPERTIES`
 			*/
 			Entity() noexcept;
 			/**
+			Copies everything but the place in the `TransformHierarchy`, which every `Entity` has its own of.
+			*/
+			Entity(const Entity& other);
+			/**
 			Destructor. Made `virtual` for inheritance.
 			@see ~Entity()
 			*/
@@ -284,6 +399,20 @@ namespace mc {
 			*/
 			bool isEmpty() const;
 
+			/**
+			Sets how `removeChild()` keeps the children together. Leaving `ChildOrder::DEFERRED` closes the holes it left.
+			@see ChildOrder
+			*/
+			void setChildOrder(const ChildOrder order);
+			ChildOrder getChildOrder() const;
+
+			/**
+			Closes the holes that removing children left in `ChildOrder::DEFERRED`, keeping the order of the rest.
+			<p>
+			This is called by `update()`, so it is only needed to index the children without holes before that.
+			*/
+			void compactChildren();
+
 			/**
 			Retrieves the beginning of the children of this `Entity`
 			@return Pointer to the first `Entity`
@@ -400,6 +529,8 @@ namespace mc {
 			bool needsRemoval() const;
 
 			/**
+			Adds a child without taking ownership of it, so it can be on the stack or in a `Pool`. It has to be removed
+			before it is destroyed.
 			@dirty
 			*/
 			void addChild(Entity& e);
@@ -408,7 +539,7 @@ namespace mc {
 			*/
 			void addChild(Entity* e);
 			/**
-			@copydoc Entity::addChild(Entity&)
+			@dirty
 			*/
 			void addChild(std::shared_ptr<Entity> ent);
 
@@ -507,6 +638,11 @@ namespace mc {
 			*/
 			bool operator!=(const Entity& other) const noexcept;
 
+			/**
+			@copydoc Entity::Entity(const Entity&)
+			*/
+			Entity& operator=(const Entity& other);
+
 			/**
 			Retrieves the top most parent (known as the "root.")
 			<p>
@@ -522,22 +658,30 @@ namespace mc {
 			Entity* getRoot();
 
 			/**
+			@return The `Metrics` computed by the last `clean()`
 			@opengl
 			*/
-			const Metrics& getMetrics() const;
+			Metrics getMetrics() const;
 
 			/**
+			Cleans this `Entity` and everything below it.
+			<p>
+			`onClean()` is called on every dirty `Entity`, parents first. The transforms are then inherited in one pass
+			over the `TransformHierarchy`, which only visits the `Entities` that moved or whose parent moved.
 			@internal
 			@opengl
+			@see TransformHierarchy
 			*/
 			virtual void clean();
 
 
 			/**
+			Sends `event` to `onInput()`, and to the parents of this `Entity` while `event.bubbles` is `true`. `ENTER` also
+			calls `onHover()` and `Component::hover()`.
 			@internal
 			@opengl
 			*/
-			virtual void hover();
+			void sendInput(InputEvent& event);
 
 			/**
 			@dirty
@@ -547,7 +691,9 @@ namespace mc {
 			/**
 			Makes this `Entity` dirty and root dirty.
 			<p>
-			Should be used over `setProperty(Entity::DIRTY,true)` as it updates the root parent.
+			Should be used over `setProperty(Entity::DIRTY,true)` as it updates the root parent. The walk to the root stops
+			at any parent that another `Entity` already passed since the last clean, so making many `Entities` dirty
+			is cheap.
 			@see Entity::getRoot()
 			@dirty
 			*/
@@ -629,10 +775,50 @@ namespace mc {
 			virtual void onClean();
 
 			/**
+			Called when the mouse moves onto this `Entity` or one of its children.
 			@internal
 			@opengl
 			*/
 			virtual void onHover();
+
+			/**
+			Called for every `InputEvent` that reaches this `Entity`. Setting `event.bubbles` to `false` stops it from being
+			sent to the parent.
+			@opengl
+			@see InputEvent
+			*/
+			virtual void onInput(InputEvent& event);
+
+			/**
+			Called by `clean()` after the `Metrics` of this `Entity` changed, which happens when it or one of its parents moved.
+			It is called once every transform was inherited, so `getMetrics()` returns the new ones.
+			@internal
+			@opengl
+			*/
+			virtual void onMetricsChanged();
+
+			/**
+			Whether `onMetricsChanged()` should be called. `Entities` that don't watch their `Metrics`, and have no `Components`,
+			are skipped entirely by `clean()` when they move, which is a lot faster in big trees.
+			@see getMetrics()
+			*/
+			void watchMetrics(const bool watch);
+
+			/**
+			Whether every child of this `Entity` is updated as if it had `Entity::INDEPENDENT`. Used by `WindowModule`
+			when `LaunchConfig::parallelUpdate` is set.
+			*/
+			void setChildrenIndependent(const bool independent);
+
+			/**
+			Moves this `Entity` and everything below it into `newHierarchy`. Children that are added later join it as well.
+			<p>
+			Used by roots that are cleaned on another thread, like `WindowModule`, so their tree is separate from every other.
+			Must only be called on a root, and `newHierarchy` must outlive everything in it or be replaced first.
+			@internal
+			@see TransformHierarchy
+			*/
+			void useHierarchy(TransformHierarchy& newHierarchy);
 		private:
 			std::vector<std::shared_ptr<Component>> components = std::vector<std::shared_ptr<Component>>();
 
@@ -646,9 +832,49 @@ namespace mc {
 			TransformMatrix transformation;
 
 			/**
+			The `TransformHierarchy` of the tree this `Entity` is in, which is the same as its parent
+			@internal
+			*/
+			TransformHierarchy* hierarchy;
+
+			/**
+			Handle of this `Entity` in `hierarchy`
 			@internal
 			*/
-			Metrics metrics;
+			Index node;
+
+			bool metricsWatched = false;
+			bool childrenIndependent = false;
+
+			ChildOrder childOrder = ChildOrder::ORDERED;
+			//whether there is a nullptr in children that compactChildren() should remove
+			bool childHoles = false;
+
+			//where this is in the children of its parent, so it can be found without searching them
+			Index childIndex = Index(-1);
+
+			void updateWatched();
+
+			/**
+			Links the node of this `Entity` below the node of `newParent`, moving it into the hierarchy of `newParent` if it is
+			in another one. An `Entity` taken out of a tree goes back to `getTransformHierarchy()`. Called before `parent` is set.
+			*/
+			void linkParent(Entity* newParent);
+
+			/**
+			Removes a child according to the `ChildOrder`, keeping the index of every child that moved up to date
+			*/
+			void eraseChild(const Index index);
+
+			/**
+			Updates every child, the independent ones in parallel
+			*/
+			void updateChildren();
+
+			/**
+			Kills and removes a child found dead during a parallel update, if it wasn't removed since
+			*/
+			void removeDeadChild(const Entity* child);
 
 			/**
 			Automatically called when `Entity::PROPERTY_DEAD` is true. Removes this entity from it's parent, and calls it's `destroy()` method.
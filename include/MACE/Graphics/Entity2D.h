@@ -14,6 +14,17 @@ See LICENSE.md for full copyright information
 #include <MACE/Graphics/Components.h>
 #include <MACE/Utility/Vector.h>
 
+#include <unordered_map>
+#include <vector>
+
+//width of a GlyphAtlas in pixels. the height starts at a quarter of this and doubles when it runs out of room
+#define MACE__GLYPH_ATLAS_WIDTH 1024
+
+//size in pixels that distance field glyphs are rasterized at. they are scaled from this to any other size
+#define MACE__DISTANCE_FIELD_GLYPH_SIZE 48
+//how many pixels around the outline of a glyph the distance field covers
+#define MACE__DISTANCE_FIELD_SPREAD 6
+
 namespace mc {
 	namespace gfx {
 		/**
@@ -59,7 +70,12 @@ namespace mc {
 
 			virtual void onTrigger();
 
-			void doHover();
+			/**
+			Updates `isHovered()` and `isClicked()` from an `InputEvent`. Pressing the left mouse button calls `click()`,
+			and releasing it while clicked calls `trigger()`. Moving the mouse while clicked calls `onClick()` again, so
+			it can be dragged.
+			*/
+			void handleInput(const InputEvent& event);
 		};
 
 		class TexturedEntity2D: public Entity2D {
@@ -192,7 +208,7 @@ namespace mc {
 		private:
 			void onRender(Painter& p) override;
 			void onClick() override;
-			void onHover() override;
+			void onInput(InputEvent& event) override;
 		};//Slider
 
 		//TEXT IS UP AHEAD
@@ -206,6 +222,106 @@ namespace mc {
 			SERIF,
 		};
 
+		/**
+		What a `Text` does with lines that are wider than its maximum width
+		@see Text::setMaxWidth(const float)
+		*/
+		enum class TextOverflow: Byte {
+			/**
+			Lines are broken after spaces, hyphens, and CJK characters. Words that don't fit on a line on their own are broken anywhere.
+			*/
+			WRAP,
+			/**
+			Lines are cut off and end with an ellipsis
+			*/
+			ELLIPSIS
+		};
+
+		struct GlyphMetrics {
+			signed long width = 0;
+			signed long height = 0;
+			signed long bearingX = 0;
+			signed long bearingY = 0;
+			signed long advanceX = 0;
+			signed long advanceY = 0;
+
+			bool operator ==(const GlyphMetrics& other) const;
+			bool operator !=(const GlyphMetrics& other) const;
+		};
+
+		/**
+		Where a rasterized glyph is stored in a `GlyphAtlas`, in pixels. Glyphs with no visible pixels, like spaces,
+		only have metrics and a width and height of 0.
+		*/
+		struct Glyph {
+			GlyphMetrics metrics{};
+
+			unsigned int x = 0, y = 0, width = 0, height = 0;
+		};
+
+		/**
+		Packs every rasterized glyph of a `Font` into a single `Texture`, so an entire `Text` can be drawn
+		with one draw call. Subpixel glyphs use 3 channels and distance field glyphs use 1.
+		<p>
+		Glyphs are placed left to right in rows. The atlas has a fixed width, and its height doubles when it runs out
+		of room. That changes the texture coordinates of every glyph, so `getGeneration()` is incremented and anything
+		built from the old coordinates should be rebuilt. Replacing a glyph, like when a glyph that was rasterized in
+		the background is filled in, increments it as well.
+		<p>
+		A copy of the pixels is kept in memory. Only the rows that changed are uploaded by `getTexture()`.
+		@see Font::getGlyph(const char32_t) const
+		*/
+		class GlyphAtlas {
+		public:
+			GlyphAtlas(const unsigned int width = MACE__GLYPH_ATLAS_WIDTH, const unsigned int channels = 3);
+
+			/**
+			@return The glyph, or `nullptr` if it hasn't been added
+			*/
+			const Glyph* getGlyph(const unsigned int code) const;
+
+			/**
+			@param pixels Rows of `getChannels()` bytes per pixel, top to bottom. Can be `nullptr` if `width` or `height` is 0.
+			@param pitch Bytes between the start of each row in `pixels`
+			@throws OutOfBounds If the glyph is wider than the atlas
+			@see getGeneration()
+			*/
+			const Glyph& addGlyph(const unsigned int code, const GlyphMetrics& metrics, const Byte* pixels, const unsigned int width, const unsigned int height, const unsigned int pitch);
+
+			/**
+			Creates or updates the texture with any glyphs added since the last call. Requires a graphics context.
+			*/
+			Texture& getTexture();
+
+			unsigned int getWidth() const;
+			unsigned int getHeight() const;
+			unsigned int getChannels() const;
+
+			Size getGlyphCount() const;
+
+			/**
+			Incremented every time the atlas grows or a glyph is replaced
+			*/
+			Index getGeneration() const;
+
+			void destroy();
+		private:
+			std::unordered_map<unsigned int, Glyph> glyphs{};
+
+			std::vector<Byte> pixels{};
+			unsigned int width, height, channels;
+
+			//where the next glyph goes, and how tall the current row is
+			unsigned int penX = 0, penY = 0, rowHeight = 0;
+
+			//rows that have to be uploaded on the next getTexture()
+			unsigned int dirtyTop, dirtyBottom;
+
+			Index generation = 0;
+
+			Texture texture{};
+		};//GlyphAtlas
+
 		/**
 		@todo instead of using an id system add FT_Face
 		@todo get rid of FT_Library global constant
@@ -214,8 +330,25 @@ namespace mc {
 		class Font {
 			friend class Text;
 		public:
+			/**
+			Memory maps a font file, so only the parts of it that are used are ever loaded.
+			<p>
+			Faces are shared. Loading the same path again returns a `Font` with the same id. Each load holds
+			a reference to the face, and it is only destroyed once `destroy()` was called for every load.
+			Copies of a `Font` share the reference of the one they were copied from.
+			*/
 			static Font loadFont(const std::string& name, unsigned int size = 12);
+			/**
+			@copydoc Font::loadFont(const std::string&, unsigned int)
+			*/
 			static Font loadFont(const char* name, unsigned int size = 12);
+			/**
+			The data isn't copied, so it must stay alive until the font is destroyed.
+			<p>
+			Faces are shared by the hash of their data. Loading the same data again, even from another
+			buffer, returns a `Font` with the same id and holds another reference to it.
+			@see loadFont(const std::string&, unsigned int)
+			*/
 			static Font loadFontFromMemory(const unsigned char* data, unsigned long int dataSize, unsigned int size = 12);
 			template<std::size_t N>
 			static inline Font loadFontFromMemory(const unsigned char data[N], unsigned int size = 12) {
@@ -224,6 +357,10 @@ namespace mc {
 
 			Font(const Font& f);
 			Font(const Index id = 0, const unsigned int h = 0);
+			/**
+			The embedded fonts are stored compressed, and each one is only decompressed the first time it is used.
+			Like `loadFont(const std::string&, unsigned int)`, every `Font` constructed this way holds a reference to the face.
+			*/
 			Font(const Fonts f, const unsigned int height = 12);
 
 			void destroy();
@@ -231,7 +368,67 @@ namespace mc {
 			/**
 			@todo cache characters
 			*/
-			void getCharacter(const wchar_t character, std::shared_ptr<Letter> let) const;
+			void getCharacter(const char32_t character, std::shared_ptr<Letter> let) const;
+
+			/**
+			Rasterizes a glyph into the atlas for this font and size, if it isn't already there.
+			<p>
+			`calculateMetrics()` must be called first so the glyph is rasterized at the right size.
+			@see getAtlas()
+			*/
+			const Glyph& getGlyph(const char32_t character) const;
+
+			/**
+			@return Whether this font has a glyph for `character`, instead of drawing it as a missing glyph
+			*/
+			bool hasCharacter(const char32_t character) const;
+
+			/**
+			Like `getGlyph()`, but a glyph that isn't in the atlas yet is rasterized on a background thread. Only its metrics
+			are loaded right away, so it can be laid out. It has no pixels until `updateGlyphs()` adds them, and is
+			drawn blank until then.
+			<p>
+			`calculateMetrics()` must be called first.
+			@see prepareGlyphs(const char32_t, const char32_t) const
+			*/
+			const Glyph& requestGlyph(const char32_t character) const;
+
+			/**
+			Rasterizes every character from `first` to `last`, inclusive, on a background thread. Useful for loading
+			screens, so large character sets like CJK are ready before any `Text` needs them.
+			@see getPendingGlyphCount()
+			*/
+			void prepareGlyphs(const char32_t first, const char32_t last) const;
+
+			/**
+			@return The `GlyphAtlas` shared by every `Font` with the same face and size
+			*/
+			GlyphAtlas& getAtlas() const;
+
+			/**
+			Rasterizes a glyph into the distance field atlas for this face, if it isn't already there.
+			<p>
+			Distance field glyphs are rasterized once at `MACE__DISTANCE_FIELD_GLYPH_SIZE` pixels regardless of the size of this `Font`,
+			and their metrics are for that size. The pixels extend `MACE__DISTANCE_FIELD_SPREAD` past the glyph on every side.
+			@see getDistanceFieldAtlas()
+			*/
+			const Glyph& getDistanceFieldGlyph(const char32_t character) const;
+
+			/**
+			@copydoc requestGlyph(const char32_t) const
+			@see getDistanceFieldGlyph(const char32_t) const
+			*/
+			const Glyph& requestDistanceFieldGlyph(const char32_t character) const;
+
+			/**
+			@copydoc prepareGlyphs(const char32_t, const char32_t) const
+			*/
+			void prepareDistanceFieldGlyphs(const char32_t first, const char32_t last) const;
+
+			/**
+			@return The single channel `GlyphAtlas` shared by every size of this face
+			*/
+			GlyphAtlas& getDistanceFieldAtlas() const;
 
 			bool hasKerning() const;
 
@@ -244,30 +441,33 @@ namespace mc {
 			*/
 			signed long getHeight() const;
 
-			Vector<signed long, 2> getKerning(const wchar_t prev, const wchar_t current) const;
+			Vector<signed long, 2> getKerning(const char32_t prev, const char32_t current) const;
 
 			Index getID() const;
 
 			bool operator==(const Font& other) const;
 			bool operator!=(const Font& other) const;
+
+			/**
+			Adds every glyph that finished rasterizing in the background to its atlas. `Text` calls this every frame.
+			*/
+			static void updateGlyphs();
+
+			/**
+			@return How many glyphs are queued or rasterizing in the background, including ones that finished but
+			haven't been added by `updateGlyphs()` yet
+			*/
+			static Size getPendingGlyphCount();
 		private:
 			Index id;
 			unsigned int height;
 
 			void calculateMetrics() const;
-		};//Font
+			void calculateDistanceFieldMetrics() const;
 
-		struct GlyphMetrics {
-			signed long width = 0;
-			signed long height = 0;
-			signed long bearingX = 0;
-			signed long bearingY = 0;
-			signed long advanceX = 0;
-			signed long advanceY = 0;
-
-			bool operator ==(const GlyphMetrics& other) const;
-			bool operator !=(const GlyphMetrics& other) const;
-		};
+			bool isQueued(const unsigned int code, const bool distanceField) const;
+			void queueGlyph(const unsigned int code, const bool distanceField) const;
+		};//Font
 
 		class Letter: public Entity2D {
 			friend class Font;
@@ -302,27 +502,162 @@ namespace mc {
 		};//Letter
 
 		/**
+		Where every glyph of a `Text` goes. Layouts are cached and shared between every `Text` with the same
+		`Key`, so repeated labels are only laid out once.
+		@see Text::getLayout()
+		*/
+		struct TextLayout {
+			/**
+			Everything that changes the result of a layout
+			*/
+			struct Key {
+				/**
+				UTF-8
+				*/
+				std::string text;
+				Index fontID = 0;
+				unsigned int fontSize = 0;
+				Vector<int, 2> dpi = {0, 0};
+				Vector<int, 2> windowSize = {0, 0};
+				bool distanceField = false;
+
+				bool operator==(const Key& other) const;
+				bool operator!=(const Key& other) const;
+			};
+
+			/**
+			A glyph relative to the top left corner of its line, in relative window coordinates
+			*/
+			struct GlyphQuad {
+				char32_t character;
+				/**
+				Where the character starts in its `Line`, in bytes
+				*/
+				Index index;
+				float left, top, right, bottom;
+				/**
+				Whether a line can be wrapped before this glyph
+				*/
+				bool breakBefore;
+			};
+
+			/**
+			Lines are laid out on their own so an edit only has to lay out the lines it touches.
+			*/
+			struct Line {
+				/**
+				Where the line starts in the text, in bytes
+				*/
+				Index begin = 0;
+				/**
+				In bytes, not including the newline at the end
+				*/
+				Size length = 0;
+				/**
+				In 26.6 fractional pixels
+				*/
+				signed long width = 0;
+
+				std::vector<GlyphQuad> quads{};
+			};
+
+			/**
+			`Key::text` is empty for layouts that were edited in place by `Text::append()`, `Text::insert()`, or
+			`Text::erase()`. Those layouts belong to a single `Text` and are never cached.
+			*/
+			Key key{};
+
+			std::vector<Line> lines{};
+
+			/**
+			Distance between the top of each line, in relative window coordinates
+			*/
+			float lineHeight = 0.0f;
+
+			/**
+			Width of the longest line, in 26.6 fractional pixels
+			*/
+			signed long maxLineWidth = 0;
+
+			/**
+			What the `Text` is scaled to, in relative window coordinates
+			*/
+			float width = 0.0f, height = 0.0f;
+		};//TextLayout
+
+		/**
+		Renders a string with a `Font`.
+		<p>
+		By default, the string is drawn as meshes of glyph quads that sample the `GlyphAtlas` of its font. Each mesh
+		holds a block of lines, and every block is drawn together with `Painter::drawModels()`. A block is only
+		rebuilt when its lines, the font, or the atlas change.
+		<p>
+		Layouts are cached by `TextLayout::Key`, so moving a `Text` or repeating the same string never lays it out again.
+		Editing the text with `append()`, `insert()`, or `erase()` only lays out and rebuilds the lines that changed,
+		so a long log or console stays cheap to add to.
+		<p>
+		The text is stored as UTF-8 and decoded straight into codepoints while it is laid out. Positions passed
+		to `insert()` and `erase()` are byte offsets, and must be at the start of a character. Invalid UTF-8 is
+		replaced with `utf8::REPLACEMENT_CHARACTER`.
 		@bug newline with vertical align doesnt really work
+		@see setLetterEntities(const bool)
 		*/
 		class Text: public TexturedEntity2D {
 		public:
-			Text(const std::string& t, const Font& f = Font());
-			Text(const std::wstring& t = L"", const Font& f = Font());
+			/**
+			@param t UTF-8
+			*/
+			Text(const std::string& t = "", const Font& f = Font());
+			Text(const std::wstring& t, const Font& f = Font());
 			~Text() = default;
 
 			/**
+			@param newText UTF-8
 			@dirty
 			*/
 			void setText(const std::string& newText);
 			/**
+			Converts the text to UTF-8. Prefer `setText(const std::string&)`, which is used as-is.
 			@dirty
 			*/
 			void setText(const std::wstring& newText);
 			/**
+			@return The text as UTF-8
+			@dirty
+			*/
+			std::string& getText();
+			const std::string& getText() const;
+			/**
+			Converts the text from UTF-8, so it is slower than `getText()`
+			*/
+			std::wstring getWideText() const;
+
+			/**
+			Adds to the end of the text. Only the last line is laid out again.
+			@dirty
+			*/
+			void append(const std::string& str);
+			/**
+			@copydoc Text::append(const std::string&)
+			*/
+			void append(const std::wstring& str);
+
+			/**
+			Inserts into the text before `position`. Lines before the edit keep their layout, and lines after it
+			are reused as long as their characters didn't change.
 			@dirty
 			*/
-			std::wstring& getText();
-			const std::wstring& getText() const;
+			void insert(const Index position, const std::string& str);
+			/**
+			@copydoc Text::insert(const Index, const std::string&)
+			*/
+			void insert(const Index position, const std::wstring& str);
+
+			/**
+			Removes `length` bytes starting at `position`, laying out as little as `insert()`.
+			@dirty
+			*/
+			void erase(const Index position, const Size length);
 
 			/**
 			@dirty
@@ -334,8 +669,64 @@ namespace mc {
 			Font& getFont();
 			const Font& getFont() const;
 
+			/**
+			Only filled when `hasLetterEntities()` is true.
+			*/
 			const std::vector<std::shared_ptr<Letter>>& getLetters() const;
 
+			/**
+			@return The layout that was used the last time this was cleaned, or `nullptr` if there isn't one yet.
+			Not used when `hasLetterEntities()` is true.
+			*/
+			std::shared_ptr<const TextLayout> getLayout() const;
+
+			/**
+			Renders every character as its own `Letter` child instead of one mesh. Each `Letter` is a separate
+			`Entity` and draw call, so this is much slower and should only be used for effects on individual letters.
+			<p>
+			A texture set with `setTexture()` is stretched over each letter in this mode. Otherwise, it is sampled
+			with the texture coordinates of the `GlyphAtlas`, so only solid colors look correct.
+			@dirty
+			*/
+			void setLetterEntities(const bool enabled);
+			bool hasLetterEntities() const;
+
+			/**
+			Renders glyphs from a signed distance field with `Painter::Brush::DISTANCE_FIELD` instead of subpixel bitmaps.
+			<p>
+			Each glyph is rasterized once per face, so the text stays sharp at any scale and changing the size of the
+			`Font` never rasterizes anything. Small text looks softer than the default mode. Ignored when `hasLetterEntities()` is true.
+			@dirty
+			*/
+			void setDistanceField(const bool enabled);
+			bool hasDistanceField() const;
+
+			/**
+			Lines wider than this are broken up or cut off, depending on `getOverflow()`. It is in the same units as
+			`getWidth()`, so this `Text` is never wider than it unless a single glyph doesn't fit. 0, the default, only
+			breaks lines at newlines.
+			<p>
+			The lines are broken from the glyphs that were already laid out, so changing only this never lays anything
+			out again. Only the lines that wrap differently are rebuilt, so resizing wrapped labels every frame stays cheap.
+			<p>
+			Ignored when `hasLetterEntities()` is true.
+			@dirty
+			*/
+			void setMaxWidth(const float width);
+			float getMaxWidth() const;
+
+			/**
+			@dirty
+			@see setMaxWidth(const float)
+			*/
+			void setOverflow(const TextOverflow overflow);
+			TextOverflow getOverflow() const;
+
+			/**
+			@return How many rows the text took up after it was wrapped, the last time this was cleaned
+			*/
+			Size getRowCount() const;
+
 			void setTexture(const Texture& tex) override;
 			Texture& getTexture() override;
 			const Texture& getTexture() const override;
@@ -351,11 +742,85 @@ namespace mc {
 		private:
 			std::vector<std::shared_ptr<Letter>> letters;
 
-			std::wstring text;
+			/*
+			The mesh is split into blocks of lines so an edit only rebuilds the blocks it touched.
+			*/
+			struct MeshBlock {
+				Model mesh{};
+				bool created = false;
+				//whether the block has no glyphs and shouldn't be drawn
+				bool empty = true;
+			};
+
+			std::shared_ptr<TextLayout> layout = nullptr;
+
+			std::vector<MeshBlock> blocks{};
+			std::vector<const Model*> visibleBlocks{};
+			//lines whose blocks have to be rebuilt, from firstDirtyLine up to but not including lastDirtyLine
+			Index firstDirtyLine = 0, lastDirtyLine = 0;
+			//generation of the GlyphAtlas when the blocks were built
+			Index atlasGeneration = 0;
+
+			//whether the text was replaced instead of edited, which means it has to be laid out from scratch
+			bool textReplaced = true;
+			//range of the text left alone by every edit since the last clean. the first editBegin characters and the last editSuffix characters are unchanged
+			bool edited = false;
+			Index editBegin = 0;
+			Size editSuffix = 0;
+
+			bool letterEntities = false;
+			bool distanceField = false;
+
+			/*
+			How setMaxWidth() breaks up a line of the layout. The layout may be shared, so this belongs to the Text.
+			Lines that fit have no breaks and aren't truncated.
+			*/
+			struct LineWrap {
+				//rows above this line
+				Index firstRow = 0;
+				//the quads that start a new row, and how far left the row is moved
+				std::vector<std::pair<Index, float>> breaks{};
+				//for TextOverflow::ELLIPSIS, every quad from visibleQuads on is replaced by the ellipsis at ellipsisX
+				bool truncated = false;
+				Index visibleQuads = 0;
+				float ellipsisX = 0.0f;
+
+				bool operator==(const LineWrap& other) const;
+				bool operator!=(const LineWrap& other) const;
+			};
+
+			float maxWidth = 0.0f;
+			TextOverflow overflow = TextOverflow::WRAP;
+			//whether the lines have to be broken again even though the layout didn't change
+			bool wrapChanged = true;
+
+			//one for each line, or empty when there is no maximum width
+			std::vector<LineWrap> wraps{};
+			TextLayout::Line ellipsis{};
+			Size rowCount = 0;
+			//what the blocks are scaled to, which is smaller than the layout when lines are wrapped
+			float layoutWidth = 0.0f, layoutHeight = 0.0f;
+
+			//UTF-8
+			std::string text;
 
 			Font font;
 
 			Texture texture;
+
+			std::shared_ptr<TextLayout> createLayout(const TextLayout::Key& key);
+			std::vector<TextLayout::Line> layoutLines(TextLayout& out, const std::string& str, const Index begin, const Index end);
+			void relayout();
+			void wrapLines(const bool layoutChanged);
+
+			void markEdited(const Index position, const Size suffix);
+
+			void clearLetters();
+			void layoutLetters();
+
+			void markLinesDirty(const Index first, const Index last);
+			void buildBlocks();
+			void buildBlock(const Index block);
 		};//Text
 
 		class Button: public TexturedEntity2D, public Selectable {
@@ -399,7 +864,7 @@ namespace mc {
 
 		protected:
 			void onRender(Painter& p) override;
-			void onHover() override;
+			void onInput(InputEvent& event) override;
 			void onDestroy() override;
 		private:
 			Texture texture;
@@ -42,7 +42,10 @@ namespace mc {
 #include <MACE/Graphics/Entity.h>
 #include <MACE/Graphics/Components.h>
 #include <MACE/Graphics/Entity2D.h>
+#include <MACE/Graphics/Particles.h>
+#include <MACE/Graphics/TileMap.h>
 #include <MACE/Graphics/Renderer.h>
+#include <MACE/Graphics/SpatialIndex.h>
 #include <MACE/Graphics/Context.h>
 #include <MACE/Graphics/Window.h>
 
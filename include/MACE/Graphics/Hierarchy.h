@@ -0,0 +1,192 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#pragma once
+#ifndef MACE__GRAPHICS_HIERARCHY_H
+#define MACE__GRAPHICS_HIERARCHY_H
+
+#include <MACE/Core/Constants.h>
+#include <MACE/Graphics/Entity.h>
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace mc {
+	namespace gfx {
+		/**
+		Flattened copy of the `Entity` tree that `Entity::clean()` computes transforms with.
+		<p>
+		Every `Entity` owns a node. Nodes are stored as a structure of arrays ordered depth first, so parents always
+		come before their children and everything below a node is right after it. Inheriting transforms is then
+		a single pass over a contiguous range, with no recursion, virtual calls, or `std::shared_ptr`.
+		<p>
+		Adding or removing a node only marks the order as stale. It is sorted again the next time a range is needed,
+		so changing the tree many times between cleans costs a single sort.
+		<p>
+		Dirty and moved nodes are also kept in lists, so cleaning only touches what changed and its subtrees. Cleaning
+		a tree where nothing changed doesn't look at any nodes.
+		<p>
+		Every tree that is cleaned on its own thread, like the tree of a `WindowModule`, has its own hierarchy. `Entities`
+		that aren't in one of those trees are in `getTransformHierarchy()`.
+		<p>
+		Every function locks a recursive mutex, so nodes can be changed by the parallel update in `Entity::update()`
+		and from the main thread while the rendering thread cleans. `visitDirty()`, `visit()` and `update()` hold it for
+		the whole pass, including their callbacks, so nothing changes the tree under them from another thread.
+		@internal
+		@see Entity::clean()
+		*/
+		class TransformHierarchy {
+		public:
+			using Node = Index;
+
+			/**
+			The parent of a root node
+			*/
+			static MACE_CONSTEXPR const Node NONE = static_cast<Node>(-1);
+
+			/**
+			@return A new root node. Its handle stays the same until it is destroyed, even when the nodes are sorted.
+			*/
+			Node create(Entity* owner);
+			/**
+			The children of `node` become roots.
+			*/
+			void destroy(const Node node);
+
+			void setParent(const Node node, const Node parent);
+			Node getParent(const Node node) const;
+
+			/**
+			Moves `node` and everything below it into `other`, below `parent` which is a node of `other`. Their transformations,
+			`Metrics`, and whether they are dirty or watched are kept. Both hierarchies are locked until it is done.
+			@param callback Called with the owner of every moved node and its handle in `other`, parents first. The old handles are destroyed.
+			*/
+			void moveTo(TransformHierarchy& other, const Node node, const Node parent, const std::function<void(Entity*, Node)>& callback);
+
+			/**
+			Sets the transformation of a node, relative to its parent. If it changed, its `Metrics` are recomputed by the next `update()`
+			*/
+			void setLocal(const Node node, const TransformMatrix& local);
+
+			/**
+			Whether the owner of a node needs its `Entity::onClean()` called
+			*/
+			void setDirty(const Node node, const bool dirty);
+			bool isDirty(const Node node) const;
+
+			/**
+			Marks the path from `node` to its root, so later calls for anything on that path can stop early.
+			<p>
+			Marks only last until any node is cleared or the tree changes, as that is the only way the root can stop being dirty.
+			@return The owner of the root of `node`, or `nullptr` if it was already marked since then and doesn't need to be
+			made dirty again
+			*/
+			Entity* markPath(const Node node);
+
+			/**
+			Whether `update()` calls back for a node when its `Metrics` change. Nodes that aren't watched are updated
+			without leaving the arrays.
+			*/
+			void setWatched(const Node node, const bool watched);
+
+			/**
+			@return What the `Metrics` of a node were after the last `update()` that changed them
+			*/
+			Metrics getMetrics(const Node node) const;
+
+			/**
+			Calls `callback` with the owner of every dirty node at or below `root`, parents first. The callback is
+			expected to clear the node, and is allowed to add and remove nodes. Nodes that it makes dirty are visited as well.
+			*/
+			void visitDirty(const Node root, const std::function<void(Entity*)>& callback);
+
+			/**
+			Calls `callback` with the owner of every node at or below `root`, parents first. It must not add or remove nodes.
+			*/
+			void visit(const Node root, const std::function<void(Entity*)>& callback);
+
+			/**
+			Recomputes the `Metrics` of every node at or below `root` whose transformation was set, or whose parent changed.
+			Only the subtrees of those nodes are looked at.
+			<p>
+			`callback` is called with the owner of every watched node whose `Metrics` changed, before its children
+			inherit them, and can modify them. It must not add or remove nodes.
+			*/
+			void update(const Node root, const std::function<void(Entity*, Metrics&)>& callback);
+
+			/**
+			@return How many nodes are alive
+			*/
+			Size size() const;
+
+			/**
+			Keeps other threads from changing the hierarchy until the returned lock is released, for work that spans more than one call.
+			*/
+			std::unique_lock<std::recursive_mutex> lock() const;
+		private:
+			//plain floats instead of TransformMatrix, so the inheriting pass doesn't go through Vector
+			struct Transforms {
+				float translation[3], rotation[3], scaler[3];
+			};
+
+			/*
+			Indexed by position in the sorted order. A position whose owner is nullptr was destroyed since the last sort.
+			parents are positions as well, and are always smaller than the position of their child after a sort.
+			*/
+			std::vector<Transforms> local{}, transform{}, inherited{};
+			std::vector<Index> parents{};
+			//how many positions after this one are below it, including itself
+			std::vector<Size> subtreeSizes{};
+			std::vector<Entity*> owners{};
+			std::vector<Node> nodes{};
+			std::vector<Byte> dirty{};
+			std::vector<Byte> watched{};
+			//whether the local transformation was set since the last update()
+			std::vector<Byte> moved{};
+			//scratch space for update(), whether the metrics at a position changed
+			std::vector<Byte> changed{};
+
+			/*
+			Indexed by node. Children are linked lists so nodes can be moved around without any allocations,
+			and newer children are at the front.
+			*/
+			std::vector<Index> positions{};
+			std::vector<Node> parentNodes{}, firstChildren{}, nextSiblings{}, previousSiblings{};
+			std::vector<Node> freeNodes{};
+			//nodes that were made dirty or moved. they may have been cleared since, or be in the list more than once
+			std::vector<Node> dirtyNodes{}, movedNodes{};
+			//the generation each node was last passed by markPath() in
+			std::vector<Size> markedGenerations{};
+
+			Size generation = 1;
+
+			Size liveCount = 0;
+			bool sorted = true;
+
+			//recursive, as the public functions call each other and callbacks can call back into the hierarchy
+			mutable std::recursive_mutex mutex{};
+
+			void unlink(const Node node);
+			void sort();
+			void setMoved(const Index position);
+
+			/**
+			Takes every node in `list` that is at or below `root` and has its flag set, sorted parents first. Nodes
+			outside of `root` are left in it, and ones that were cleared are dropped.
+			*/
+			std::vector<Node> takeNodes(std::vector<Node>& list, const std::vector<Byte>& flags, const Node root);
+			void updateRange(const Index begin, const Index end, const std::function<void(Entity*, Metrics&)>& callback);
+		};//TransformHierarchy
+
+		/**
+		@return The `TransformHierarchy` of every `Entity` that isn't in a tree with its own
+		@internal
+		*/
+		TransformHierarchy& getTransformHierarchy();
+	}//gfx
+}//mc
+
+#endif//MACE__GRAPHICS_HIERARCHY_H
@@ -21,6 +21,17 @@ See LICENSE.md for full copyright information
 
 #define MACE__VAO_DEFAULT_VERTICES_LOCATION 0
 #define MACE__VAO_DEFAULT_TEXTURE_COORD_LOCATION 1
+//instanced draws use one float attribute per location, in the same order as Painter::QuadInstances
+//GLSL 3.30 doesn't allow expressions in layout qualifiers, so each location needs its own literal
+#define MACE__VAO_INSTANCE_X_LOCATION 2
+#define MACE__VAO_INSTANCE_Y_LOCATION 3
+#define MACE__VAO_INSTANCE_SIZE_LOCATION 4
+#define MACE__VAO_INSTANCE_ROTATION_LOCATION 5
+#define MACE__VAO_INSTANCE_RED_LOCATION 6
+#define MACE__VAO_INSTANCE_GREEN_LOCATION 7
+#define MACE__VAO_INSTANCE_BLUE_LOCATION 8
+#define MACE__VAO_INSTANCE_ALPHA_LOCATION 9
+#define MACE__VAO_INSTANCE_ATTRIBUTE_COUNT 8
 
 namespace mc {
 	namespace gfx {
@@ -395,6 +406,12 @@ namespace mc {
 				*/
 				void setData(const void* data, GLsizei width, GLsizei height, Enum type, Enum format, Enum internalFormat, GLint mipmapLevel);
 
+				/**
+				@opengl
+				@see https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glTexSubImage2D.xhtml
+				*/
+				void setSubData(const void* data, GLint x, GLint y, GLsizei width, GLsizei height, Enum type, Enum format, GLint mipmapLevel);
+
 				/**
 				@opengl
 				@see https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glTexImage2DMultisample.xhtml
@@ -11,12 +11,115 @@ See LICENSE.md for full copyright information
 #include <MACE/Graphics/Context.h>
 #include <MACE/Graphics/OGL/OGL33Renderer.h>
 
+#include <vector>
+
 namespace mc {
 	namespace gfx {
 		namespace ogl33 {
-			class OGL33Model: public ModelImpl, private ogl33::VertexArray {
-				friend class OGL33Renderer;
+			class OGL33Model;
+
+			/**
+			Hands out ranges of elements from a pool that can grow. Freed ranges are merged with their neighbors
+			so the pool does not fragment.
+			@internal
+			@see GeometryArena
+			*/
+			class RangeAllocator {
+			public:
+				struct Range {
+					Index offset = 0;
+					Size length = 0;
+				};
+
+				/**
+				Finds the first free range large enough for `length` elements.
+				@return Whether a range was found. If `false`, the pool needs to be grown with RangeAllocator::grow(const Size)
+				*/
+				bool allocate(const Size length, Range& out);
+				void free(const Range& range);
+
+				void grow(const Size newCapacity);
+				Size getCapacity() const;
+
+				void clear();
+			private:
+				//sorted by offset, and no two ranges are ever adjacent
+				std::vector<Range> freeRanges{};
+				Size capacity = 0;
+			};//RangeAllocator
+
+			/**
+			Shared vertex and index storage for every `OGL33Model` with the same vertex format.
+			<p>
+			Instead of each `Model` owning a vertex array object and its own buffers, models allocate ranges
+			out of a few large buffers and draw with a base vertex and index offset. This means switching
+			between models doesn't rebind a vertex array, and creating a `Model` does not create any OpenGL objects.
+			<p>
+			Each attribute is stored in its own `VertexBuffer` so they can be uploaded independently, like
+			the `Model` API expects.
+			@see OGL33Model
+			*/
+			class GeometryArena: public Initializable {
 			public:
+				using Range = RangeAllocator::Range;
+
+				struct Attribute {
+					GLuint location;
+					GLint components;
+				};
+
+				GeometryArena(const std::vector<Attribute>& format, const Size initialVertices = 4096, const Size initialIndices = 8192);
+
+				void init() override;
+				void destroy() override;
+
+				void bind() const;
+				void unbind() const;
+
+				bool isCreated() const;
+
+				Range allocateVertices(const Size count);
+				void freeVertices(const Range& range);
+
+				Range allocateIndices(const Size count);
+				void freeIndices(const Range& range);
+
+				/**
+				@param attribute Index into the format this arena was created with, not the attribute location
+				@param range Range previously returned by GeometryArena::allocateVertices(const Size)
+				@param data Must have `range.length` elements, each with as many components as the attribute
+				*/
+				void setVertexData(const Index attribute, const Range& range, const float* data);
+				void setIndexData(const Range& range, const unsigned int* data);
+
+				/**
+				Draws every model in one call with `glMultiDrawElementsBaseVertex` or `glMultiDrawArrays`.
+				<p>
+				Every model must come from this arena and have the same `PrimitiveType`. Either all of them must have indices, or none.
+				@opengl
+				*/
+				void multiDraw(const std::vector<const OGL33Model*>& models) const;
+
+				const std::vector<Attribute>& getFormat() const;
+			private:
+				std::vector<Attribute> format;
+
+				ogl33::VertexArray vao{};
+				std::vector<ogl33::VertexBuffer> vertexBuffers{};
+				ogl33::ElementBuffer indexBuffer{};
+
+				RangeAllocator vertexAllocator{}, indexAllocator{};
+
+				void growVertices(const Size minimumCapacity);
+				void growIndices(const Size minimumCapacity);
+			};//GeometryArena
+
+			class OGL33Model: public ModelImpl {
+				friend class GeometryArena;
+			public:
+				OGL33Model(const std::shared_ptr<GeometryArena>& arena);
+				~OGL33Model() noexcept override;
+
 				void init() override;
 				void destroy() override;
 
@@ -30,6 +133,19 @@ namespace mc {
 				void loadIndices(const unsigned int indiceNum, const unsigned int* indiceData) override;
 
 				bool isCreated() const override;
+
+				const GeometryArena::Range& getVertexRange() const;
+				const GeometryArena::Range& getIndexRange() const;
+
+				const GeometryArena* getArena() const;
+			private:
+				std::shared_ptr<GeometryArena> arena;
+
+				GeometryArena::Range vertices{}, indices{};
+
+				bool created = false;
+
+				void reserveVertices(const Size count);
 			};
 
 			class OGL33Texture: public TextureImpl, private ogl33::Texture2D {
@@ -47,6 +163,7 @@ namespace mc {
 				void setPackStorageHint(const gfx::PixelStorage hint, const int value) override;
 
 				void setData(const void* data, const int mipmap = 0) override;
+				void setSubData(const void* data, const unsigned int x, const unsigned int y, const unsigned int width, const unsigned int height, const int mipmap = 0) override;
 
 				void readPixels(void* data) const override;
 			};
@@ -66,6 +183,9 @@ namespace mc {
 				void onDestroy(gfx::WindowModule* win) override;
 			private:
 				std::unique_ptr<Renderer> renderer;
+
+				//every Model uses the same format, so one arena is enough
+				std::shared_ptr<GeometryArena> geometry;
 			};
 		}//ogl33
 	}//gfx
@@ -84,9 +84,16 @@ namespace mc {
 			protected:
 				void loadSettings(const Painter::State& state) override;
 				void draw(const Model& m, const Painter::Brush brush) override;
+				void drawModels(const std::vector<const Model*>& models, const Painter::Brush brush) override;
+				void drawQuadInstances(const Painter::QuadInstances& instances) override;
 			private:
 				OGL33Renderer* const renderer;
 
+				//created the first time drawQuadInstances() is called, as most entities never use it
+				VertexArray instanceArray{};
+				VertexBuffer instanceBuffer{};
+				Size instanceCapacity = 0;
+
 				struct {
 					UniformBuffer entityData;
 					UniformBuffer painterData;
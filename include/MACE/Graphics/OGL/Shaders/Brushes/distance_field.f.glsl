@@ -0,0 +1,15 @@
+//when the preprocessor copy and pastes this file, the newlines will be syntax errors. we need to specify that this is a multiline string. if you want syntax highlighting, make sure to configure your editor to ignore this line
+R""(
+uniform lowp sampler2D tex1;
+uniform mediump sampler2D tex2;
+
+vec4 mc_frag_main(void){
+	vec4 foreground = mcGetForeground(tex1);
+	float distance = mcGetBackground(tex2).r;
+
+	//how much the distance changes across a pixel, which keeps the edge a pixel wide at any scale
+	float edge = max(fwidth(distance) * 0.75, 0.0001);
+
+	return vec4(foreground.rgb, foreground.a * smoothstep(0.5 - edge, 0.5 + edge, distance));
+}
+)""
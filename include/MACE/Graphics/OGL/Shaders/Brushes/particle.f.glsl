@@ -0,0 +1,10 @@
+//when the preprocessor copy and pastes this file, the newlines will be syntax errors. we need to specify that this is a multiline string. if you want syntax highlighting, make sure to configure your editor to ignore this line
+R""(
+in lowp vec4 _mcInstanceColor;
+
+uniform lowp sampler2D tex;
+
+vec4 mc_frag_main(void){
+	return mcGetForeground(tex) * _mcInstanceColor;
+}
+)""
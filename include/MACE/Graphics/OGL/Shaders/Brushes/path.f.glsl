@@ -0,0 +1,11 @@
+//when the preprocessor copy and pastes this file, the newlines will be syntax errors. we need to specify that this is a multiline string. if you want syntax highlighting, make sure to configure your editor to ignore this line
+R""(
+vec4 mc_frag_main(void){
+#ifdef MACE_TEXTURE
+	//the first texture coordinate is how much of the pixel is covered by the path
+	return vec4(mc_Foreground.mc_Color.rgb, mc_Foreground.mc_Color.a * clamp(_mcTextureCoord.x, 0.0, 1.0));
+#else
+	return mc_Foreground.mc_Color;
+#endif
+}
+)""
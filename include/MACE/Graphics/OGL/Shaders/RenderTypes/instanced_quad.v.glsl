@@ -0,0 +1,31 @@
+//when the preprocessor copy and pastes this file, the newlines will be syntax errors. we need to specify that this is a multiline string. if you want syntax highlighting, make sure to configure your editor to ignore this line
+R""(
+//each attribute comes from its own array, matching the layout of Painter::QuadInstances
+layout(location = MACE_VAO_INSTANCE_X_LOCATION) in float _mcInstanceX;
+layout(location = MACE_VAO_INSTANCE_Y_LOCATION) in float _mcInstanceY;
+layout(location = MACE_VAO_INSTANCE_SIZE_LOCATION) in float _mcInstanceSize;
+layout(location = MACE_VAO_INSTANCE_ROTATION_LOCATION) in float _mcInstanceRotation;
+layout(location = MACE_VAO_INSTANCE_RED_LOCATION) in float _mcInstanceRed;
+layout(location = MACE_VAO_INSTANCE_GREEN_LOCATION) in float _mcInstanceGreen;
+layout(location = MACE_VAO_INSTANCE_BLUE_LOCATION) in float _mcInstanceBlue;
+layout(location = MACE_VAO_INSTANCE_ALPHA_LOCATION) in float _mcInstanceAlpha;
+
+out lowp vec4 _mcInstanceColor;
+
+void mc_instance_main(void){
+	//drawn as a triangle strip of 4 vertices
+	vec2 mc_Corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1)) * 2.0 - 1.0;
+
+	float mc_Cos = cos(_mcInstanceRotation), mc_Sin = sin(_mcInstanceRotation);
+	_mc_VertexPosition = vec3(mat2(mc_Cos, mc_Sin, -mc_Sin, mc_Cos) * (mc_Corner * _mcInstanceSize) + vec2(_mcInstanceX, _mcInstanceY), 0.0);
+
+	//same orientation as Model::getQuad()
+	_mcInputTextureCoord = vec2(mc_Corner.x * 0.5 + 0.5, 0.5 - mc_Corner.y * 0.5);
+
+	_mcInstanceColor = vec4(_mcInstanceRed, _mcInstanceGreen, _mcInstanceBlue, _mcInstanceAlpha);
+}
+
+vec4 mc_vert_main(vec4 pos){
+	return pos;
+}
+)""
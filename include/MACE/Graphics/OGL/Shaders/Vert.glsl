@@ -1,11 +1,21 @@
 R""(
-#ifdef MACE_TEXTURE
+#ifdef MACE_INSTANCED
+//instanced draws have no per-vertex attributes. mc_instance_main() fills these in from gl_VertexID
+vec2 _mcInputTextureCoord;
+vec3 _mc_VertexPosition;
+
+void mc_instance_main(void);
+#else
+#	ifdef MACE_TEXTURE
 layout(location = MACE_VAO_DEFAULT_TEXTURE_COORD_LOCATION) in vec2 _mcInputTextureCoord;
+#	endif
 
-out highp vec2 _mcTextureCoord;
+layout(location = MACE_VAO_DEFAULT_VERTICES_LOCATION) in vec3 _mc_VertexPosition;
 #endif
 
-layout(location = MACE_VAO_DEFAULT_VERTICES_LOCATION) in vec3 _mc_VertexPosition;
+#ifdef MACE_TEXTURE
+out highp vec2 _mcTextureCoord;
+#endif
 
 mat3 _mcCreateRotationMatrix(const in vec3 mc_RotationInput){
 	float mc_CosZ = cos(mc_RotationInput.z), mc_SinZ = sin(mc_RotationInput.z),
@@ -44,6 +54,10 @@ vec4 mcGetEntityPosition(){
 vec4 mc_vert_main(vec4);
 
 void main(void){
+#ifdef MACE_INSTANCED
+	mc_instance_main();
+#endif
+
 #ifdef MACE_TEXTURE
 	_mcTextureCoord = _mcInputTextureCoord;
 #endif
@@ -0,0 +1,261 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#pragma once
+#ifndef MACE__GRAPHICS_PARTICLES_H
+#define MACE__GRAPHICS_PARTICLES_H
+
+#include <MACE/Core/Constants.h>
+#include <MACE/Graphics/Entity2D.h>
+#include <MACE/Utility/Vector.h>
+#include <MACE/Utility/Color.h>
+#include <MACE/Utility/Math.h>
+
+#include <array>
+#include <chrono>
+#include <initializer_list>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <vector>
+
+//how many samples a ParticleCurve is baked into
+#define MACE__PARTICLE_CURVE_RESOLUTION 64
+
+namespace mc {
+	namespace gfx {
+		/**
+		Value that changes over the lifetime of a particle, from 0 when it is emitted to 1 when it dies.
+		<p>
+		Keys are linearly interpolated and baked into a lookup table, so sampling the curve is a single
+		array access no matter how many keys it has.
+		<p>
+		Only `float` and `Color` curves are supported.
+		@see ParticleSystem
+		*/
+		template<typename T>
+		class ParticleCurve {
+		public:
+			ParticleCurve(const T& constant) : ParticleCurve({{0.0f, constant}}) {}
+			/**
+			@param keyframes Pairs of a time from 0 to 1 and the value at that time. They don't have to be sorted.
+			*/
+			ParticleCurve(std::initializer_list<std::pair<float, T>> keyframes);
+
+			void addKey(const float time, const T& value);
+
+			const T& get(const float time) const {
+				return table[static_cast<Index>(math::clamp(time, 0.0f, 1.0f) * (MACE__PARTICLE_CURVE_RESOLUTION - 1) + 0.5f)];
+			}
+
+			const std::vector<std::pair<float, T>>& getKeys() const;
+		private:
+			std::vector<std::pair<float, T>> keys;
+			std::array<T, MACE__PARTICLE_CURVE_RESOLUTION> table;
+
+			void bake();
+		};//ParticleCurve
+
+		/**
+		Spawns particles for a `ParticleSystem`. Every value that has a minimum and a maximum is picked
+		randomly between the two for each particle.
+		<p>
+		Positions and sizes are in the same space as `Model::getQuad()`, where -1 to 1 covers the whole `ParticleSystem`.
+		*/
+		struct ParticleEmitter {
+			Vector<float, 2> position = {0.0f, 0.0f};
+			/**
+			Particles spawn up to this far away from `position` on each axis
+			*/
+			Vector<float, 2> area = {0.0f, 0.0f};
+
+			/**
+			How many particles are spawned every second
+			*/
+			float rate = 50.0f;
+			/**
+			Spawned all at once on the next update, then reset to 0
+			*/
+			Size burst = 0;
+
+			/**
+			Angle in radians particles move towards, where 0 is the positive x-axis
+			*/
+			float direction = math::pi<float>() * 0.5f;
+			/**
+			How far in radians the direction of each particle can be from `direction`
+			*/
+			float spread = math::pi<float>() * 0.125f;
+
+			float minSpeed = 0.5f, maxSpeed = 1.0f;
+			/**
+			In seconds
+			*/
+			float minLifetime = 1.0f, maxLifetime = 2.0f;
+			float minSize = 0.02f, maxSize = 0.05f;
+			/**
+			In radians per second
+			*/
+			float minSpin = 0.0f, maxSpin = 0.0f;
+
+			bool enabled = true;
+		};//ParticleEmitter
+
+		/**
+		Simulates and renders a large amount of particles as a single `Entity`.
+		<p>
+		Particles are stored as a structure of arrays and simulated with SIMD when `MACE_SSE` is defined.
+		Every particle is drawn in one instanced draw call with `Painter::drawQuadInstances()`, so there
+		is no per-particle `Entity`, `Component`, or uniform buffer.
+		<p>
+		Particles are simulated in the local space of this `Entity`, so moving it moves every particle with it.
+		@see ParticleEmitter
+		@see ParticleCurve
+		*/
+		class ParticleSystem: public TexturedEntity2D {
+		public:
+			ParticleSystem(const Size maxParticles = 4096);
+			~ParticleSystem() = default;
+
+			void setTexture(const Texture& tex) override;
+			Texture& getTexture() override;
+			const Texture& getTexture() const override;
+
+			/**
+			@return Index of the new emitter, for use with `getEmitter()`
+			*/
+			Index addEmitter(const ParticleEmitter& emitter);
+			ParticleEmitter& getEmitter(const Index i);
+			const ParticleEmitter& getEmitter(const Index i) const;
+			std::vector<ParticleEmitter>& getEmitters();
+			const std::vector<ParticleEmitter>& getEmitters() const;
+
+			/**
+			Multiplied by the random size of each particle
+			*/
+			void setSizeCurve(const ParticleCurve<float>& curve);
+			const ParticleCurve<float>& getSizeCurve() const;
+
+			/**
+			Multiplied by the texture of each particle
+			*/
+			void setColorCurve(const ParticleCurve<Color>& curve);
+			const ParticleCurve<Color>& getColorCurve() const;
+
+			/**
+			Acceleration applied to every particle, in units per second squared
+			*/
+			void setGravity(const Vector<float, 2>& gravity);
+			const Vector<float, 2>& getGravity() const;
+
+			/**
+			Fraction of velocity lost every second, from 0 to 1
+			*/
+			void setDrag(const float drag);
+			float getDrag() const;
+
+			/**
+			Any particles over the new limit are removed.
+			*/
+			void setMaxParticles(const Size maxParticles);
+			Size getMaxParticles() const;
+
+			/**
+			Splits the simulation between this many threads when there are enough particles to be worth it.
+			1 by default, which simulates everything on the calling thread.
+			<p>
+			When there is a current `JobSystem`, like while an `Instance` is updated, its workers are used instead of starting new threads.
+			@see JobSystem::getCurrent()
+			*/
+			void setThreadCount(const unsigned int threads);
+			unsigned int getThreadCount() const;
+
+			Size getParticleCount() const;
+
+			/**
+			Removes every live particle. Emitters keep running.
+			*/
+			void clearParticles();
+
+			/**
+			Advances the simulation. Called automatically by `update()` with the time since the last update.
+			@param delta In seconds
+			*/
+			void simulate(const float delta);
+		protected:
+			void onInit() override final;
+			void onUpdate() override final;
+			void onRender(Painter& p) override final;
+			void onDestroy() override final;
+			void onClean() override final;
+		private:
+			Texture texture;
+
+			std::vector<ParticleEmitter> emitters{};
+			//fractional particles left over from previous updates, one per emitter
+			std::vector<float> emitterAccumulators{};
+
+			ParticleCurve<float> sizeCurve = ParticleCurve<float>(1.0f);
+			ParticleCurve<Color> colorCurve = ParticleCurve<Color>(Color(1.0f, 1.0f, 1.0f, 1.0f));
+
+			Vector<float, 2> gravity = {0.0f, 0.0f};
+			float drag = 0.0f;
+
+			unsigned int threadCount = 1;
+
+			Size maxParticles;
+			Size particleCount = 0;
+
+			/*
+			Every array has room for maxParticles rounded up to a multiple of 4 so SIMD loops never need
+			a scalar tail. `life` goes from 0 to 1 over the lifetime of the particle, at `lifeRate` per second.
+			The rendered attributes are written every update and uploaded as-is by Painter::drawQuadInstances().
+			*/
+			struct {
+				std::vector<float> x, y, velocityX, velocityY, rotation, spin, life, lifeRate, baseSize;
+				std::vector<float> size, red, green, blue, alpha;
+			} particles;
+
+			//a copy of the rendered attributes, since onRender() is called from the rendering thread while onUpdate() simulates
+			struct Instances {
+				std::vector<float> x, y, size, rotation, red, green, blue, alpha;
+				Size count = 0;
+			};
+
+			//filled by the update thread, then swapped into the shared instances so neither thread waits on a copy
+			Instances stagedInstances{};
+
+			class SharedInstances {
+			public:
+				SharedInstances() = default;
+				//the mutex isn't copied, so a copied ParticleSystem gets its own
+				SharedInstances(const SharedInstances& other);
+				SharedInstances& operator=(const SharedInstances& other);
+
+				Instances instances{};
+				mutable std::mutex mutex{};
+			} sharedInstances{};
+
+			std::minstd_rand randomEngine{std::random_device{}()};
+
+			std::chrono::time_point<std::chrono::steady_clock> lastUpdate;
+
+			void resizeStorage();
+			/**
+			Copies the particles into the instances that the rendering thread draws
+			*/
+			void publishInstances();
+
+			void removeDeadParticles(const float delta);
+			void simulateRange(const Index begin, const Index end, const float delta);
+			void emitParticles(const float delta);
+			void spawnParticle(const ParticleEmitter& emitter);
+
+			float randomBetween(const float minimum, const float maximum);
+		};//ParticleSystem
+	}//gfx
+}//mc
+
+#endif//MACE__GRAPHICS_PARTICLES_H
@@ -0,0 +1,148 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#pragma once
+#ifndef MACE__GRAPHICS_PATH_H
+#define MACE__GRAPHICS_PATH_H
+
+#include <MACE/Core/Constants.h>
+#include <MACE/Graphics/Context.h>
+#include <MACE/Utility/Vector.h>
+
+#include <vector>
+#include <initializer_list>
+
+namespace mc {
+	namespace gfx {
+		/**
+		Mixes `value` into `seed`, for hashing several values together
+		@internal
+		*/
+		inline void hashCombine(std::size_t& seed, const std::size_t value) {
+			//the golden ratio, scaled to the width of std::size_t so every bit of it is used
+			const std::size_t golden = sizeof(std::size_t) >= 8 ? static_cast<std::size_t>(0x9e3779b97f4a7c15ULL) : static_cast<std::size_t>(0x9e3779b9UL);
+			seed ^= value + golden + (seed << 6) + (seed >> 2);
+		}
+
+		/**
+		Triangles generated from a `Path`, in the layout expected by `Model`.
+		<p>
+		The first texture coordinate of each vertex is its coverage, where 1 is inside the shape and 0 is
+		the outer edge of the anti-aliasing fringe. It is read by `Painter::Brush::PATH`.
+		@see Path::tessellateFill(const float, PathMesh&) const
+		@see Path::tessellateStroke(const float, const float, PathMesh&) const
+		*/
+		struct PathMesh {
+			std::vector<float> vertices{};
+			std::vector<float> textureCoordinates{};
+			std::vector<unsigned int> indices{};
+
+			/**
+			Uploads this mesh into a new `Model`.
+			@opengl
+			*/
+			Model createModel() const;
+
+			Size getVertexCount() const;
+
+			void clear();
+		};//PathMesh
+
+		/**
+		Describes a 2D shape out of lines, arcs, and bezier curves.
+		<p>
+		Coordinates are in the same space as `Model::getQuad()`, where -1 to 1 covers the whole `Entity`.
+		Every function that builds the path returns a reference to it so calls can be chained:
+		{@code
+			Path p = Path();
+			p.moveTo(-1.0f, -1.0f).lineTo(1.0f, -1.0f).quadraticTo(1.0f, 1.0f, -1.0f, 1.0f).close();
+		}
+		@see Painter::fillPath(const Path&)
+		@see Painter::drawPath(const Path&, const float)
+		*/
+		class Path {
+		public:
+			enum class Command: Byte {
+				MOVE,
+				LINE,
+				QUADRATIC,
+				CUBIC,
+				CLOSE
+			};
+
+			static Path rect(const float x, const float y, const float w, const float h);
+			static Path roundedRect(const float x, const float y, const float w, const float h, const float radius);
+			static Path ellipse(const float centerX, const float centerY, const float radiusX, const float radiusY);
+			static Path circle(const float centerX, const float centerY, const float radius);
+
+			/**
+			Starts a new contour at a point
+			*/
+			Path& moveTo(const float x, const float y);
+			Path& lineTo(const float x, const float y);
+			Path& quadraticTo(const float controlX, const float controlY, const float x, const float y);
+			Path& cubicTo(const float control1X, const float control1Y, const float control2X, const float control2Y, const float x, const float y);
+			/**
+			Adds a circular arc. If there is an open contour, a line is drawn from its last point to the start of the arc.
+			@param startAngle Measured in radians counter-clockwise from the positive x-axis
+			@param endAngle If less than `startAngle`, the arc goes clockwise
+			*/
+			Path& arc(const float centerX, const float centerY, const float radius, const float startAngle, const float endAngle);
+			/**
+			Closes the current contour by connecting it back to its first point
+			*/
+			Path& close();
+
+			void clear();
+
+			bool isEmpty() const;
+
+			/**
+			Hash of every command and point in this `Path`. Two equal paths always have the same hash.
+			<p>
+			The hash is cached and only recalculated after the path changes.
+			*/
+			std::size_t getHash() const;
+
+			/**
+			Flattens every curve into line segments.
+			@param tolerance Maximum distance between the curve and the generated lines
+			@param closed Set to whether each contour was explicitly closed
+			@return One list of points per contour
+			*/
+			std::vector<std::vector<Vector<float, 2>>> flatten(const float tolerance, std::vector<bool>& closed) const;
+
+			/**
+			Triangulates the inside of this `Path`. Every contour is treated as closed and filled independently,
+			so holes are not cut out. Concave contours are supported.
+			@param feather Width of the anti-aliased fringe added around the edge. 0 disables anti-aliasing.
+			*/
+			void tessellateFill(const float feather, PathMesh& out) const;
+			/**
+			Generates triangles covering the outline of this `Path`, with mitered joins and butt caps.
+			@param width How wide the outline is
+			@param feather Width of the anti-aliased fringe on each side. 0 disables anti-aliasing.
+			*/
+			void tessellateStroke(const float width, const float feather, PathMesh& out) const;
+
+			const std::vector<Command>& getCommands() const;
+			const std::vector<float>& getPoints() const;
+
+			bool operator==(const Path& other) const;
+			bool operator!=(const Path& other) const;
+		private:
+			std::vector<Command> commands{};
+			//each command consumes 2 floats per point: MOVE and LINE use 1 point, QUADRATIC 2, and CUBIC 3
+			std::vector<float> points{};
+
+			mutable std::size_t hash = 0;
+			mutable bool hashDirty = true;
+
+			void addCommand(const Command command, std::initializer_list<float> args);
+		};//Path
+	}//gfx
+}//mc
+
+#endif//MACE__GRAPHICS_PATH_H
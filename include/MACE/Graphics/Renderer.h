@@ -12,12 +12,14 @@ See LICENSE.md for full copyright information
 #include <MACE/Graphics/Entity.h>
 #include <MACE/Graphics/Window.h>
 #include <MACE/Graphics/Context.h>
+#include <MACE/Graphics/Path.h>
+#include <MACE/Graphics/SpatialIndex.h>
 #include <MACE/Utility/Vector.h>
 #include <MACE/Utility/Transform.h>
 #include <MACE/Utility/Color.h>
 
-#include <deque>
 #include <stack>
+#include <vector>
 
 namespace mc {
 	namespace gfx {
@@ -33,7 +35,7 @@ namespace mc {
 			std::shared_ptr<PainterImpl> painterImpl;
 		};
 		//if the container we use is ever going to be changed, we typedef
-		using RenderQueue = std::deque<RendererEntry>;
+		using RenderQueue = std::vector<RendererEntry>;
 		//cant be size_t - opengl has to use to uints so the EntityID must be unsigned int
 		using EntityID = unsigned int;
 
@@ -95,6 +97,34 @@ namespace mc {
 				as if that `RenderFeature` is `false`
 				*/
 				MULTICOMPONENT_BLEND = 5,
+				/**
+				Renders the foreground color with its alpha multiplied
+				by the first texture coordinate of the `Model`.
+				<br>
+				This is used to anti-alias the edges of a `Path`.
+				@see PathMesh
+				*/
+				PATH = 6,
+				/**
+				Renders the foreground texture multiplied by the
+				color of each instance.
+				<br>
+				This is only used by `Painter::drawQuadInstances()`
+				@see ParticleSystem
+				*/
+				PARTICLE = 7,
+				/**
+				Renders the foreground texture with its alpha taken from
+				a signed distance field in the red channel of the background
+				texture, where 0.5 is the edge.
+				<br>
+				The edge is anti-aliased using screen space derivatives, so
+				it stays sharp at any scale.
+				<br>
+				This is used by `Text` in distance field mode.
+				@see Text::setDistanceField(const bool)
+				*/
+				DISTANCE_FIELD = 8,
 			};
 
 			enum class RenderFeatures: Byte {
@@ -128,6 +158,32 @@ namespace mc {
 				bool operator!=(const State& other) const;
 			};
 
+			/**
+			Per-instance attributes for `Painter::drawQuadInstances()`.
+			<p>
+			Every pointer is an array with `count` elements. Data that is already stored
+			as a structure of arrays can be uploaded without being repacked first.
+			*/
+			struct QuadInstances {
+				const float* x = nullptr;
+				const float* y = nullptr;
+				/**
+				Half of the width and height of the quad, as `Model::getQuad()` spans from -1 to 1
+				*/
+				const float* size = nullptr;
+				/**
+				In radians
+				*/
+				const float* rotation = nullptr;
+
+				const float* red = nullptr;
+				const float* green = nullptr;
+				const float* blue = nullptr;
+				const float* alpha = nullptr;
+
+				Size count = 0;
+			};
+
 			void drawModel(const Model& m, const Texture& img);
 
 			void fillModel(const Model& m);
@@ -136,6 +192,22 @@ namespace mc {
 			void fillRect(const Vector<float, 2>& pos, const Vector<float, 2>& size);
 			void fillRect(const Vector<float, 4>& dim);
 
+			/**
+			Fills the inside of a `Path` with the foreground color, with anti-aliased edges.
+			<p>
+			The tessellated mesh is cached by the `Path`, so a static shape is only
+			tessellated once. It is tessellated again if the `Entity` is scaled enough to change
+			how many pixels the edges cover.
+			@see GraphicsContext::findPathMesh(const Path&, const float, const int, const bool)
+			*/
+			void fillPath(const Path& path);
+			/**
+			Draws the outline of a `Path` with the foreground color, with anti-aliased edges.
+			@param width Width of the line, in the same units as the `Path`
+			@see Painter::fillPath(const Path&)
+			*/
+			void drawPath(const Path& path, const float width = 0.01f);
+
 			void drawImage(const Texture& img);
 
 			void maskImage(const Texture& img, const Texture& mask);
@@ -146,6 +218,18 @@ namespace mc {
 
 			void drawQuad(const Brush brush);
 			void draw(const Model& m, const Brush brush);
+			/**
+			Draws several models with the same settings. When possible, the renderer combines them into one draw call.
+			@see Painter::draw(const Model&, const Brush)
+			*/
+			void drawModels(const std::vector<const Model*>& models, const Brush brush);
+			/**
+			Draws many quads with a single draw call, using `Brush::PARTICLE`.
+			<p>
+			Each quad is placed, scaled, rotated and colored by the matching element
+			in `instances`, and then transformed like any other `Model` drawn by this `Painter`.
+			*/
+			void drawQuadInstances(const QuadInstances& instances);
 
 			const GraphicsEntity* const getEntity() const;
 
@@ -249,6 +333,8 @@ namespace mc {
 			void destroy() override;
 
 			void clean();
+
+			void drawPathMesh(const Path& path, const float width, const bool stroke);
 		};
 
 		MACE_CONSTEXPR inline Painter::RenderFeatures operator|(const Painter::RenderFeatures& left, const Painter::RenderFeatures& right) {
@@ -281,6 +367,8 @@ namespace mc {
 
 			virtual void loadSettings(const Painter::State& state) = 0;
 			virtual void draw(const Model& m, const Painter::Brush brush) = 0;
+			virtual void drawModels(const std::vector<const Model*>& models, const Painter::Brush brush) = 0;
+			virtual void drawQuadInstances(const Painter::QuadInstances& instances) = 0;
 
 			bool operator==(const PainterImpl& other) const;
 			bool operator!=(const PainterImpl& other) const;
@@ -300,11 +388,42 @@ namespace mc {
 		public:
 			virtual ~Renderer() = default;
 
+			/**
+			Finds the `GraphicsEntity` on top at a point with the `SpatialIndex`, without asking the GPU. Only the rectangle
+			a `GraphicsEntity` covers is taken into account, so transparent parts of it are still hit.
+			@param x From `-1` on the left to `1` on the right, like the translation of an `Entity`
+			@param y From `-1` on the bottom to `1` on the top
+			@return The `GraphicsEntity` drawn last in the last frame that covers the point, or `nullptr`
+			@see getEntityAt(const unsigned int, const unsigned int) for hits that are exact to the pixel
+			*/
 			GraphicsEntity* getEntityAt(const float x, const float y);
+			/**
+			@copydoc getEntityAt(const float, const float)
+			*/
 			const GraphicsEntity* getEntityAt(const float x, const float y) const;
+			/**
+			Finds the `GraphicsEntity` that drew a pixel by reading it back from the GPU. It is exact, but has to wait for
+			the GPU to finish the frame.
+			@param x, y In pixels, from the top left of the framebuffer
+			@see getEntityAt(const float, const float)
+			*/
 			GraphicsEntity* getEntityAt(const unsigned int x, const unsigned int y);
+			/**
+			@copydoc getEntityAt(const unsigned int, const unsigned int)
+			*/
 			const GraphicsEntity* getEntityAt(const unsigned int x, const unsigned int y) const;
 
+			/**
+			Appends every `GraphicsEntity` drawn in the last frame that covers a point to `out`, with the one on top first.
+			@copydetails getEntityAt(const float, const float)
+			*/
+			void getEntitiesAt(const float x, const float y, std::vector<GraphicsEntity*>& out) const;
+			/**
+			Appends every `GraphicsEntity` drawn in the last frame that overlaps `area` to `out`, with the one on top first.
+			Useful for selecting with a rectangle.
+			*/
+			void getEntitiesIn(const Bounds& area, std::vector<GraphicsEntity*>& out) const;
+
 
 			virtual void getEntitiesAt(const unsigned int x, const unsigned int y, const unsigned int w, const unsigned int h, EntityID* arr) const = 0;
 			template<Size W, Size H>
@@ -347,12 +466,28 @@ namespace mc {
 			GraphicsContext* getContext();
 			const GraphicsContext* getContext() const;
 
+			/**
+			@return The bounds of every initialized `GraphicsEntity`
+			*/
+			SpatialIndex& getSpatialIndex();
+			const SpatialIndex& getSpatialIndex() const;
+
+			/**
+			Sets whether hovering reads the `GraphicsEntity` under the mouse back from the GPU, which is exact to the pixel
+			but waits for the GPU every frame. By default, the `SpatialIndex` is used instead.
+			@see getEntityAt(const unsigned int, const unsigned int)
+			*/
+			void setPixelExactHover(const bool exact);
+			bool isPixelExactHover() const;
+
 			/**
 			@internal
 			*/
 			void flagResize();
 		protected:
 			RenderQueue renderQueue = RenderQueue();
+			//IDs of slots in the render queue whose entity was destroyed, which are reused before the queue grows
+			std::vector<EntityID> freeIDs = std::vector<EntityID>();
 
 			unsigned int samples = 1;
 
@@ -372,6 +507,49 @@ namespace mc {
 			//not declared const because some of the functions require modification to an internal buffer of impls
 			virtual std::shared_ptr<PainterImpl> createPainterImpl() = 0;
 		private:
+			SpatialIndex spatialIndex{};
+
+			//every GraphicsEntity drawn is given the next number, so the one drawn last is on top
+			Size drawCount = 0;
+			//what drawCount was when the last frame started
+			Size lastFrame = 0;
+			Size currentFrame = 0;
+
+			bool pixelExactHover = false;
+
+			//queued input is moved here, so the same memory is used every frame
+			std::vector<InputEvent> events{};
+
+			//what was under the mouse when it was last hit tested
+			GraphicsEntity* hovered = nullptr;
+			int mouseX = -1, mouseY = -1;
+
+			//whether a frame was drawn since the last hit test, which could have moved something under the mouse
+			bool sceneChanged = false;
+
+			/**
+			@return The `GraphicsEntity` at the position of the mouse, or `nullptr`
+			*/
+			GraphicsEntity* pick(gfx::WindowModule* win);
+			/**
+			Hit tests at the position of the mouse, and sends `LEAVE` and `ENTER` to every `Entity` that the mouse moved
+			off of or onto
+			*/
+			void updateHovered(gfx::WindowModule* win);
+			/**
+			Sends an event to whatever is under the mouse, from where it bubbles up
+			*/
+			void sendToHovered(InputEvent event);
+
+			/**
+			@return Whether a proxy in the spatialIndex was drawn in the last frame or the one being drawn
+			*/
+			bool wasDrawn(const SpatialIndex::Proxy proxy) const;
+			/**
+			Appends the entities of `proxies` that were drawn to `out`, the one drawn last first
+			*/
+			void appendDrawn(std::vector<SpatialIndex::Proxy>& proxies, std::vector<GraphicsEntity*>& out) const;
+
 			/**
 			@internal
 			@opengl
@@ -397,6 +575,8 @@ namespace mc {
 			void tearDown(gfx::WindowModule* win);
 
 			/**
+			Hit tests and sends the `InputEvents` that were queued since the last frame. If no events were queued and
+			nothing was drawn, what is under the mouse can't have changed, and nothing is done.
 			@internal
 			@opengl
 			*/
@@ -409,9 +589,15 @@ namespace mc {
 			*/
 			void destroy();
 
+			/**
+			Gives `p` a slot in the `RenderQueue`, reusing a free one if there is any
+			*/
 			void queue(GraphicsEntity* const e, Painter& p);
 
-			void remove(const EntityID i);
+			/**
+			Frees the slot of `e,` so the next `GraphicsEntity` that is queued reuses it and its `PainterImpl`
+			*/
+			void remove(const GraphicsEntity* const e, const EntityID id);
 		};//Renderer
 
 		class MACE_NOVTABLE GraphicsEntity: public Entity {
@@ -455,7 +641,7 @@ namespace mc {
 		protected:
 			virtual void onRender(Painter& painter) = 0;
 
-			void clean() override final;
+			void onMetricsChanged() override final;
 
 			void init() override final;
 
@@ -463,7 +649,17 @@ namespace mc {
 		private:
 			Painter painter;
 
+			//the renderer this was queued in, whose SpatialIndex has the bounds of this
+			Renderer* renderer = nullptr;
+			SpatialIndex::Proxy proxy = SpatialIndex::NONE;
+
 			void onRender() override final;
+
+			bool isIndexed() const;
+			/**
+			Frees the slot of this in the `RenderQueue` and removes it from the `SpatialIndex`
+			*/
+			void removeFromRenderer();
 		};//GraphicsEntity
 	}//gfx
 }//mc
@@ -0,0 +1,146 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#pragma once
+#ifndef MACE__GRAPHICS_SPATIALINDEX_H
+#define MACE__GRAPHICS_SPATIALINDEX_H
+
+#include <MACE/Core/Constants.h>
+#include <MACE/Graphics/Entity.h>
+
+#include <vector>
+
+namespace mc {
+	namespace gfx {
+		class GraphicsEntity;
+
+		/**
+		An axis aligned rectangle, in the same space `Entities` are positioned in.
+		*/
+		struct Bounds {
+			float left = 0.0f, bottom = 0.0f, right = 0.0f, top = 0.0f;
+
+			bool contains(const float x, const float y) const;
+			bool contains(const Bounds& other) const;
+			bool overlaps(const Bounds& other) const;
+
+			float getPerimeter() const;
+
+			/**
+			@return The smallest `Bounds` that contain both `this` and `other`
+			*/
+			Bounds merge(const Bounds& other) const;
+
+			bool operator==(const Bounds& other) const;
+			bool operator!=(const Bounds& other) const;
+		};//Bounds
+
+		/**
+		Dynamic bounding volume tree over the `Bounds` of `GraphicsEntities`, for hit testing on the CPU.
+		<p>
+		Every leaf is a proxy for a `GraphicsEntity`. Leaves are stored with a margin around them, so an `Entity` that
+		moves a little only has its exact bounds updated, and the tree only changes when it leaves its margin. Inserting
+		picks the sibling that grows the tree the least, and the tree is rebalanced on the way up, so queries stay
+		logarithmic no matter what order things are added in.
+		<p>
+		Every `Renderer` has one, which `GraphicsEntity` keeps up to date from `Entity::clean()`.
+		@see Renderer::getEntityAt(const float, const float)
+		*/
+		class SpatialIndex {
+		public:
+			using Proxy = Index;
+
+			static MACE_CONSTEXPR const Proxy NONE = static_cast<Proxy>(-1);
+
+			/**
+			@return The area a quad from `-1` to `1` covers when it is drawn with `metrics`. Only rotation around the z axis
+			is taken into account, and the transform of the `Painter` isn't.
+			*/
+			static Bounds getBounds(const Metrics& metrics);
+
+			Proxy insert(GraphicsEntity* entity, const Bounds& bounds);
+			void remove(const Proxy proxy);
+
+			/**
+			Changes the `Bounds` of a proxy.
+			@return Whether the tree had to change, because the new bounds left the margin around the old ones
+			*/
+			bool move(const Proxy proxy, const Bounds& bounds);
+
+			/**
+			Stores a number with a proxy. `Renderer` uses it for the order `GraphicsEntities` were drawn in.
+			*/
+			void setOrder(const Proxy proxy, const Size order);
+			Size getOrder(const Proxy proxy) const;
+
+			/**
+			@return The `GraphicsEntity` of a proxy, or `nullptr` if it was removed
+			*/
+			GraphicsEntity* getEntity(const Proxy proxy) const;
+			const Bounds& getBounds(const Proxy proxy) const;
+
+			/**
+			Appends every proxy whose bounds contain a point to `out`, in no particular order
+			*/
+			void query(const float x, const float y, std::vector<Proxy>& out) const;
+			/**
+			Appends every proxy whose bounds overlap `area` to `out`, in no particular order
+			*/
+			void query(const Bounds& area, std::vector<Proxy>& out) const;
+
+			void clear();
+
+			/**
+			@return How many proxies there are
+			*/
+			Size size() const;
+			/**
+			@return How many levels the tree has, which is about the base 2 logarithm of `size()` when it is balanced
+			*/
+			Size getHeight() const;
+		private:
+			struct Node {
+				//the bounds with the margin. for a branch, the bounds of both children
+				Bounds fat{};
+				//the bounds the proxy was given. only used by leaves
+				Bounds bounds{};
+
+				Index parent = NONE;
+				Index left = NONE, right = NONE;
+				//a leaf is 0, and free nodes are -1
+				int height = -1;
+
+				GraphicsEntity* entity = nullptr;
+				Size order = 0;
+
+				bool isLeaf() const;
+			};
+
+			std::vector<Node> nodes{};
+			std::vector<Index> freeNodes{};
+
+			Index root = NONE;
+			Size leafCount = 0;
+
+			Index allocate();
+			void release(const Index node);
+
+			void insertLeaf(const Index leaf);
+			void removeLeaf(const Index leaf);
+
+			/**
+			Rotates the tree at `node` if one side is more than 1 level taller than the other
+			@return The node that took its place
+			*/
+			Index balance(const Index node);
+			/**
+			Refits the bounds and height of every node from `node` to the root, balancing them on the way
+			*/
+			void refit(Index node);
+		};//SpatialIndex
+	}//gfx
+}//mc
+
+#endif//MACE__GRAPHICS_SPATIALINDEX_H
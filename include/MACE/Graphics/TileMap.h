@@ -0,0 +1,104 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#pragma once
+#ifndef MACE__GRAPHICS_TILEMAP_H
+#define MACE__GRAPHICS_TILEMAP_H
+
+#include <MACE/Core/Constants.h>
+#include <MACE/Graphics/Entity2D.h>
+
+#include <vector>
+
+//width and height of a chunk, in tiles
+#define MACE__TILEMAP_CHUNK_SIZE 64
+
+namespace mc {
+	namespace gfx {
+		/**
+		Renders a large grid of tiles from a texture atlas as a single `Entity`.
+		<p>
+		Tiles are grouped into square chunks, and each chunk is turned into a static `Model`. A chunk is only
+		rebuilt when one of its tiles changes, and only when it is visible. Chunks outside of the window are
+		skipped, and the visible ones are drawn together with `Painter::drawModels()`.
+		<p>
+		The whole map spans -1 to 1 like `Model::getQuad()`, so it fills this `Entity`. Tile (0, 0) is in the top left corner.
+		The atlas is split into a grid of equally sized cells, numbered left to right and then top to bottom.
+		*/
+		class TileMap: public TexturedEntity2D {
+		public:
+			using Tile = unsigned short;
+
+			/**
+			Tiles set to this are not drawn
+			*/
+			static MACE_CONSTEXPR const Tile EMPTY = 0xFFFF;
+
+			TileMap(const unsigned int columns, const unsigned int rows, const unsigned int atlasColumns = 1, const unsigned int atlasRows = 1);
+			~TileMap() = default;
+
+			void setTexture(const Texture& tex) override;
+			Texture& getTexture() override;
+			const Texture& getTexture() const override;
+
+			/**
+			@dirty
+			*/
+			void setTile(const unsigned int x, const unsigned int y, const Tile tile);
+			Tile getTile(const unsigned int x, const unsigned int y) const;
+
+			/**
+			Sets every tile in the map
+			@dirty
+			*/
+			void fill(const Tile tile);
+
+			unsigned int getColumns() const;
+			unsigned int getRows() const;
+
+			/**
+			Changes how the atlas texture is split up. Every chunk is rebuilt.
+			@dirty
+			*/
+			void setAtlasLayout(const unsigned int atlasColumns, const unsigned int atlasRows);
+			unsigned int getAtlasColumns() const;
+			unsigned int getAtlasRows() const;
+
+			Size getChunkCount() const;
+		protected:
+			void onInit() override final;
+			void onUpdate() override final;
+			void onRender(Painter& p) override final;
+			void onDestroy() override final;
+			void onClean() override final;
+		private:
+			struct Chunk {
+				std::vector<Tile> tiles = std::vector<Tile>(MACE__TILEMAP_CHUNK_SIZE * MACE__TILEMAP_CHUNK_SIZE, TileMap::EMPTY);
+				Model mesh{};
+				//amount of tiles in this chunk that aren't EMPTY
+				Size tileCount = 0;
+				bool meshCreated = false;
+				bool dirty = true;
+			};
+
+			Texture texture;
+
+			unsigned int columns, rows;
+			unsigned int atlasColumns, atlasRows;
+
+			unsigned int chunkColumns, chunkRows;
+			std::vector<Chunk> chunks;
+
+			std::vector<const Model*> visibleMeshes{};
+
+			Chunk& getChunk(const unsigned int x, const unsigned int y);
+			const Chunk& getChunk(const unsigned int x, const unsigned int y) const;
+
+			void rebuildChunk(const unsigned int chunkX, const unsigned int chunkY);
+		};//TileMap
+	}//gfx
+}//mc
+
+#endif//MACE__GRAPHICS_TILEMAP_H
@@ -10,10 +10,13 @@ See LICENSE.md for full copyright information
 #include <MACE/Core/Instance.h>
 #include <MACE/Core/Constants.h>
 #include <MACE/Graphics/Entity.h>
+#include <MACE/Graphics/ComponentStore.h>
 
 #include <thread>
 #include <string>
 #include <functional>
+#include <mutex>
+#include <vector>
 
 //forward declaration to prevent including glfw.h
 struct GLFWwindow;
@@ -103,11 +106,21 @@ namespace mc {
 				bool resizable = false;
 				bool vsync = false;
 
+				/**
+				Whether the children of this window are updated in parallel, as if they all had `Entity::INDEPENDENT`.
+				Their updates must then only change their own subtree.
+				*/
+				bool parallelUpdate = false;
+
 				bool operator==(const LaunchConfig& other) const;
 				bool operator!=(const LaunchConfig& other) const;
 			};
 
+			/**
+			The tree of a window is cleaned and rendered on its own thread, so it gets its own `TransformHierarchy`.
+			*/
 			WindowModule(const LaunchConfig& config);
+			~WindowModule() noexcept;
 
 #ifdef MACE_EXPOSE_GLFW
 			/**
@@ -140,6 +153,23 @@ namespace mc {
 			GraphicsContext* getContext();
 			const GraphicsContext* getContext() const;
 
+			/**
+			@return The `ComponentSystems` of this window, which are updated every frame before any `Entity`
+			*/
+			ComponentStore& getComponentStore();
+			const ComponentStore& getComponentStore() const;
+
+			/**
+			Queues an `InputEvent` from the window, which the `Renderer` hit tests and sends on the next frame.
+			@internal
+			*/
+			void pushInput(const InputEvent& event);
+			/**
+			Moves every queued `InputEvent` to the end of `out`, in the order they happened.
+			@internal
+			*/
+			void takeInput(std::vector<InputEvent>& out);
+
 			template<typename T>
 			float convertPixelsToRelativeXCoordinates(T px) const {
 				return static_cast<float>(px) / config.width;
@@ -166,6 +196,15 @@ namespace mc {
 
 			std::unique_ptr<gfx::GraphicsContext> context;
 
+			//locked by the rendering thread while it builds a frame, so the main thread can't change the tree under it
+			std::unique_ptr<TransformHierarchy> transformHierarchy;
+
+			ComponentStore components{};
+
+			//events are queued by the main thread and taken by the render thread
+			std::mutex inputMutex{};
+			std::vector<InputEvent> input{};
+
 			void create();
 
 			void configureThread();
@@ -0,0 +1,230 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#pragma once
+#ifndef MACE__UTILITY_POOL_H
+#define MACE__UTILITY_POOL_H
+
+#include <MACE/Core/Constants.h>
+#include <MACE/Core/Error.h>
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mc {
+	/**
+	Refers to an object in a `Pool`.
+	<p>
+	Slots are reused after their object is destroyed, so every handle also remembers which generation of its slot
+	it was made for. Handles to destroyed objects are detected instead of silently pointing to whatever replaced them.
+	@see Pool
+	*/
+	struct PoolHandle {
+		Index index = static_cast<Index>(-1);
+		unsigned int generation = 0;
+
+		bool operator==(const PoolHandle& other) const {
+			return index == other.index && generation == other.generation;
+		}
+
+		bool operator!=(const PoolHandle& other) const {
+			return !operator==(other);
+		}
+	};//PoolHandle
+
+	/**
+	Stores objects of a single type in fixed size slabs, and hands out `PoolHandles` to them.
+	<p>
+	Creating and destroying objects reuses the slots of destroyed ones, so it doesn't go through the heap after
+	the pool has grown to its peak size. Slabs are never moved, so pointers returned by `get()` stay valid until
+	their object is destroyed. Objects are close together in memory, and `forEach()` visits them without
+	any reference counting.
+	<p>
+	Entities can be created in a `Pool` and added with `Entity::addChild(Entity*)`, which doesn't take ownership.
+	@tparam T What to store
+	@tparam SlabSize How many objects are allocated at once when the pool is full
+	*/
+	template<typename T, Size SlabSize = 256>
+	class Pool {
+		static_assert(SlabSize > 0, "A Pool needs room for at least 1 object per slab");
+	public:
+		using Handle = PoolHandle;
+
+		Pool() = default;
+		~Pool() {
+			clear();
+		}
+
+		Pool(const Pool& other) = delete;
+		Pool& operator=(const Pool& other) = delete;
+
+		/**
+		Constructs a new object with `args`.
+		@return A handle to it
+		*/
+		template<typename... Args>
+		Handle create(Args&&... args) {
+			Index index;
+			if (freeSlots.empty()) {
+				if (slotCount % SlabSize == 0) {
+					slabs.push_back(std::unique_ptr<Slot[]>(new Slot[SlabSize]));
+				}
+
+				index = slotCount++;
+			} else {
+				index = freeSlots.back();
+				freeSlots.pop_back();
+			}
+
+			Slot& slot = getSlot(index);
+			try {
+				new (&slot.storage) T(std::forward<Args>(args)...);
+			} catch (...) {
+				freeSlots.push_back(index);
+				throw;
+			}
+			slot.alive = true;
+
+			++liveCount;
+
+			Handle out = Handle();
+			out.index = index;
+			out.generation = slot.generation;
+			return out;
+		}
+
+		/**
+		Destroys an object, and makes every handle to it invalid.
+		@throws ObjectNotFoundError If `handle` was already destroyed, or is from another `Pool`
+		*/
+		void destroy(const Handle handle) {
+			Slot* slot = find(handle);
+			if (slot == nullptr) {
+				MACE__THROW(ObjectNotFound, "Handle passed to Pool::destroy() isn\'t valid");
+			}
+
+			slot->alive = false;
+			++slot->generation;
+			freeSlots.push_back(handle.index);
+			--liveCount;
+
+			reinterpret_cast<T*>(&slot->storage)->~T();
+		}
+
+		/**
+		@return The object `handle` refers to, or `nullptr` if it was destroyed
+		*/
+		T* get(const Handle handle) {
+			Slot* slot = find(handle);
+			return slot == nullptr ? nullptr : reinterpret_cast<T*>(&slot->storage);
+		}
+
+		/**
+		@copydoc Pool::get(const Handle)
+		*/
+		const T* get(const Handle handle) const {
+			const Slot* slot = find(handle);
+			return slot == nullptr ? nullptr : reinterpret_cast<const T*>(&slot->storage);
+		}
+
+		bool isValid(const Handle handle) const {
+			return find(handle) != nullptr;
+		}
+
+		/**
+		@return How many objects are alive
+		*/
+		Size size() const {
+			return liveCount;
+		}
+
+		/**
+		@return How many objects fit before another slab is allocated
+		*/
+		Size capacity() const {
+			return slabs.size() * SlabSize;
+		}
+
+		/**
+		Calls `func` with every object that is alive, in the order of their slots. Objects must not be created or
+		destroyed from `func`.
+		*/
+		template<typename Func>
+		void forEach(Func func) {
+			for (Index i = 0; i < slotCount; ++i) {
+				Slot& slot = getSlot(i);
+				if (slot.alive) {
+					func(*reinterpret_cast<T*>(&slot.storage));
+				}
+			}
+		}
+
+		/**
+		Destroys every object. The slabs are kept for later objects.
+		*/
+		void clear() {
+			for (Index i = 0; i < slotCount; ++i) {
+				Slot& slot = getSlot(i);
+				if (slot.alive) {
+					slot.alive = false;
+					++slot.generation;
+					reinterpret_cast<T*>(&slot.storage)->~T();
+				}
+			}
+
+			freeSlots.clear();
+			//slots are handed out from the back, so the first ones are reused first
+			for (Index i = slotCount; i-- > 0;) {
+				freeSlots.push_back(i);
+			}
+
+			liveCount = 0;
+		}
+	private:
+		struct Slot {
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+			unsigned int generation = 0;
+			bool alive = false;
+		};
+
+		std::vector<std::unique_ptr<Slot[]>> slabs{};
+		std::vector<Index> freeSlots{};
+
+		//how many slots were ever handed out
+		Size slotCount = 0;
+		Size liveCount = 0;
+
+		Slot& getSlot(const Index index) {
+			return slabs[index / SlabSize][index % SlabSize];
+		}
+
+		const Slot& getSlot(const Index index) const {
+			return slabs[index / SlabSize][index % SlabSize];
+		}
+
+		Slot* find(const Handle handle) {
+			if (handle.index >= slotCount) {
+				return nullptr;
+			}
+
+			Slot& slot = getSlot(handle.index);
+			return slot.alive && slot.generation == handle.generation ? &slot : nullptr;
+		}
+
+		const Slot* find(const Handle handle) const {
+			if (handle.index >= slotCount) {
+				return nullptr;
+			}
+
+			const Slot& slot = getSlot(handle.index);
+			return slot.alive && slot.generation == handle.generation ? &slot : nullptr;
+		}
+	};//Pool
+}//mc
+
+#endif//MACE__UTILITY_POOL_H
@@ -0,0 +1,99 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#pragma once
+#ifndef MACE__UTILITY_UNICODE_H
+#define MACE__UTILITY_UNICODE_H
+
+#include <MACE/Core/Constants.h>
+
+#include <string>
+
+namespace mc {
+	/**
+	Namespace with functions for working with UTF-8 strings without converting them to `std::wstring`
+	*/
+	namespace utf8 {
+		/**
+		Put in place of invalid sequences by `sanitize()`
+		*/
+		MACE_CONSTEXPR const char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+		/**
+		Checks that a string is valid UTF-8. Overlong encodings, surrogates, and codepoints past U+10FFFF are invalid.
+		<p>
+		Runs of ASCII are checked 16 bytes at a time when `MACE_SSE` is defined.
+		@return Where the first invalid sequence starts, or `length` if the whole string is valid
+		*/
+		Size validate(const char* data, const Size length);
+		/**
+		@copydoc validate(const char*, const Size)
+		*/
+		Size validate(const std::string& str);
+
+		bool isValid(const std::string& str);
+
+		/**
+		@return A copy of `str` where every invalid sequence is replaced with `REPLACEMENT_CHARACTER`
+		*/
+		std::string sanitize(const std::string& str);
+
+		/**
+		Decodes the codepoint that starts at `position`, and moves `position` to the start of the next one.
+		<p>
+		Nothing is checked, so the string must be valid UTF-8 and `position` must be at the start of a codepoint.
+		@see validate(const char*, const Size)
+		*/
+		inline char32_t decode(const char* data, Index& position) {
+			const unsigned char lead = static_cast<unsigned char>(data[position]);
+
+			if (lead < 0x80) MACE_LIKELY{
+				++position;
+				return lead;
+			} else if (lead < 0xE0) {
+				const char32_t out = (static_cast<char32_t>(lead & 0x1F) << 6) | (data[position + 1] & 0x3F);
+				position += 2;
+				return out;
+			} else if (lead < 0xF0) {
+				const char32_t out = (static_cast<char32_t>(lead & 0x0F) << 12) | (static_cast<char32_t>(data[position + 1] & 0x3F) << 6) | (data[position + 2] & 0x3F);
+				position += 3;
+				return out;
+			}
+
+			const char32_t out = (static_cast<char32_t>(lead & 0x07) << 18) | (static_cast<char32_t>(data[position + 1] & 0x3F) << 12) | (static_cast<char32_t>(data[position + 2] & 0x3F) << 6) | (data[position + 3] & 0x3F);
+			position += 4;
+			return out;
+		}
+
+		/**
+		@return Whether `c` is the first byte of a codepoint, instead of a continuation byte
+		*/
+		inline bool isCodepointStart(const char c) {
+			return (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+		}
+
+		/**
+		@return How many codepoints are in a valid UTF-8 string
+		*/
+		Size countCodepoints(const std::string& str);
+
+		/**
+		Adds `codepoint` to the end of `out` as UTF-8
+		*/
+		void append(std::string& out, const char32_t codepoint);
+
+		/**
+		Converts UTF-16 or UTF-32, depending on the size of `wchar_t`, to UTF-8. Unpaired surrogates become `REPLACEMENT_CHARACTER`.
+		*/
+		std::string fromWideString(const std::wstring& str);
+
+		/**
+		Converts valid UTF-8 to UTF-16 or UTF-32, depending on the size of `wchar_t`
+		*/
+		std::wstring toWideString(const std::string& str);
+	}//utf8
+}//mc
+
+#endif//MACE__UTILITY_UNICODE_H
@@ -30,5 +30,7 @@ namespace mc {
 #include <MACE/Utility/DynamicLibrary.h>
 #include <MACE/Utility/Process.h>
 #include <MACE/Utility/Math.h>
+#include <MACE/Utility/Unicode.h>
+#include <MACE/Utility/Pool.h>
 
 #endif
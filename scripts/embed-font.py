@@ -0,0 +1,37 @@
+#!/usr/bin/env python3
+# Generates one of the sources in src/Graphics/Fonts from a font file.
+# The font is stored compressed with zlib, and Font decompresses it the first time it is used.
+#
+# Usage: embed-font.py <font file> <variable prefix> <font name> <output .cpp>
+# Example: embed-font.py SourceSansPro-Regular.otf sourceSansPro "Source Sans Pro" src/Graphics/Fonts/SourceSansPro.cpp
+import sys
+import zlib
+
+def main():
+	if len(sys.argv) != 5:
+		sys.exit("Usage: embed-font.py <font file> <variable prefix> <font name> <output .cpp>")
+
+	fontPath, prefix, name, outputPath = sys.argv[1:]
+
+	with open(fontPath, "rb") as fontFile:
+		data = fontFile.read()
+
+	compressed = zlib.compress(data, 9)
+
+	lines = []
+	for i in range(0, len(compressed), 12):
+		lines.append("\t\t\t" + ", ".join("0x%02x" % byte for byte in compressed[i:i + 12]))
+
+	with open(outputPath, "w", newline="\n") as output:
+		output.write("/*\nCopyright (c) 2016-2019 Liav Turkia\n\nSee LICENSE.md for full copyright information\n*/\n")
+		output.write("namespace mc {\n\tnamespace gfx {\n")
+		output.write("\t\t/**\n\t\tBinary data for the %s font, compressed with zlib. %s belongs to Adobe under the SIL Open Font License\n\t\t*/\n" % (name, name))
+		output.write("\t\textern const unsigned char %sData[] = {\n" % prefix)
+		output.write(",\n".join(lines))
+		output.write("\n\t\t};\n\n")
+		output.write("\t\textern const unsigned int %sLength = %d;\n" % (prefix, len(compressed)))
+		output.write("\t\textern const unsigned int %sUncompressedLength = %d;\n" % (prefix, len(data)))
+		output.write("\t}//gfx\n}//mc\n")
+
+if __name__ == "__main__":
+	main()
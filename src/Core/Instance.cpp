@@ -9,6 +9,22 @@ See LICENSE.md for full copyright information
 #include <memory>
 
 namespace mc {
+	namespace {
+		//makes the JobSystem of an Instance the current one while it calls its Modules
+		class CurrentJobs {
+		public:
+			CurrentJobs(JobSystem* jobs) : previous(JobSystem::getCurrent()) {
+				JobSystem::setCurrent(jobs);
+			}
+
+			~CurrentJobs() {
+				JobSystem::setCurrent(previous);
+			}
+		private:
+			JobSystem* previous;
+		};
+	}//anon namespace
+
 	Index Instance::addModule(Module& m) {
 		if (m.getInstance() != nullptr) MACE_UNLIKELY{
 			MACE__THROW(AlreadyExists, "Can\'t add a Module to 2 Instance\'s!");
@@ -133,6 +149,11 @@ namespace mc {
 		flags &= ~Instance::DESTROYED;
 		flags |= Instance::INIT;
 
+		//modules can already use it when they are initialized
+		jobs = std::unique_ptr<JobSystem>(new JobSystem(jobConfig));
+
+		const CurrentJobs current(jobs.get());
+
 		for (Index i = 0; i < modules.size(); ++i) {
 			modules[i]->init();
 		}
@@ -147,9 +168,15 @@ namespace mc {
 		flags &= ~Instance::INIT;
 		flags &= ~Instance::STOP_REQUESTED;
 
-		for (Index i = 0; i < modules.size(); ++i) {
-			modules[i]->destroy();
+		{
+			const CurrentJobs current(jobs.get());
+
+			for (Index i = 0; i < modules.size(); ++i) {
+				modules[i]->destroy();
+			}
 		}
+
+		jobs.reset();
 	}
 
 	void Instance::update() {
@@ -158,6 +185,9 @@ namespace mc {
 		if (!(flags & Instance::INIT)) {
 			MACE__THROW(InitializationFailed, "init() must be called!");
 		}
+
+		const CurrentJobs current(jobs.get());
+
 		for (Index i = 0; i < modules.size(); ++i) {
 			modules[i]->update();
 		}
@@ -175,9 +205,31 @@ namespace mc {
 		return (flags & flag) != 0;
 	}
 
+	JobSystem& Instance::getJobSystem() {
+		//this line duplicates the getJobSystem() (const version)
+		return const_cast<JobSystem&>(static_cast<const Instance*>(this)->getJobSystem());
+	}
+
+	const JobSystem& Instance::getJobSystem() const {
+		if (jobs == nullptr) {
+			MACE__THROW(InitializationFailed, "init() must be called before the JobSystem can be used");
+		}
+
+		return *jobs;
+	}
+
+	void Instance::setJobConfig(const JobSystem::Config& config) {
+		jobConfig = config;
+	}
+
+	const JobSystem::Config& Instance::getJobConfig() const {
+		return jobConfig;
+	}
+
 	void Instance::reset() {
 		modules.clear();
 		flags = 0;
+		jobs.reset();
 	}
 
 	bool Instance::operator==(const Instance & other) const {
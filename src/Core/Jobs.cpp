@@ -0,0 +1,258 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <MACE/Core/Jobs.h>
+#include <MACE/Core/Error.h>
+
+#include <algorithm>
+
+#ifdef MACE_WINAPI
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#elif defined(MACE_POSIX) && defined(__linux__)
+#	include <pthread.h>
+#	include <sched.h>
+#endif
+
+namespace mc {
+	namespace {
+		thread_local JobSystem* currentJobSystem = nullptr;
+		//which queue a worker owns. threads that aren't workers use the first one
+		thread_local Index currentQueue = 0;
+
+		void pinThread(std::thread& thread, const unsigned int core) {
+#ifdef MACE_WINAPI
+			SetThreadAffinityMask(thread.native_handle(), static_cast<DWORD_PTR>(1) << (core % (sizeof(DWORD_PTR) * 8)));
+#elif defined(MACE_POSIX) && defined(__linux__)
+			cpu_set_t cores;
+			CPU_ZERO(&cores);
+			CPU_SET(core % CPU_SETSIZE, &cores);
+			pthread_setaffinity_np(thread.native_handle(), sizeof(cores), &cores);
+#else
+			//not every system lets threads be pinned, in which case the operating system decides
+			static_cast<void>(thread);
+			static_cast<void>(core);
+#endif
+		}
+	}//anon namespace
+
+	bool Job::isDone() const {
+		return unfinished.load() == 0;
+	}
+
+	JobSystem::JobSystem() : JobSystem(Config()) {}
+
+	JobSystem::JobSystem(const Config& config) {
+		const unsigned int hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		const unsigned int workerCount = config.workers == 0 ? hardwareThreads - 1 : config.workers;
+
+		queues.reserve(workerCount + 1);
+		for (Index i = 0; i <= workerCount; ++i) {
+			queues.push_back(std::unique_ptr<Queue>(new Queue()));
+		}
+
+		workers.reserve(workerCount);
+		for (Index i = 1; i <= workerCount; ++i) {
+			workers.emplace_back(&JobSystem::work, this, i);
+
+			if (config.pinWorkers) {
+				//the first core is left for the thread that created the system
+				pinThread(workers.back(), static_cast<unsigned int>(i % hardwareThreads));
+			}
+		}
+	}
+
+	JobSystem::~JobSystem() {
+		{
+			const std::unique_lock<std::mutex> guard(sleepMutex);
+			running = false;
+		}
+		wake.notify_all();
+
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+	}
+
+	JobHandle JobSystem::create(const Job::Function& function, const JobHandle& parent) {
+		JobHandle job = std::make_shared<Job>();
+		job->function = function;
+
+		if (parent != nullptr) {
+#ifdef MACE_DEBUG_CHECK_ARGS
+			if (parent->isDone()) {
+				MACE__THROW(InvalidState, "The parent of a Job can\'t be done already");
+			}
+#endif
+
+			job->parent = parent;
+			++parent->unfinished;
+		}
+
+		return job;
+	}
+
+	void JobSystem::run(const JobHandle& job) {
+#ifdef MACE_DEBUG_CHECK_NULLPTR
+		if (job == nullptr) {
+			MACE__THROW(NullPointer, "Job passed to JobSystem::run() was nullptr");
+		}
+#endif
+
+		Queue& queue = *queues[getQueue()];
+		{
+			const std::unique_lock<std::mutex> guard(queue.mutex);
+			queue.jobs.push_back(job);
+			++queued;
+		}
+
+		//taking the lock means a worker can't be between checking for jobs and going to sleep
+		{
+			const std::unique_lock<std::mutex> guard(sleepMutex);
+		}
+		wake.notify_one();
+	}
+
+	JobHandle JobSystem::run(const Job::Function& function, const JobHandle& parent) {
+		JobHandle job = create(function, parent);
+		run(job);
+		return job;
+	}
+
+	void JobSystem::wait(const JobHandle& job) {
+		const Index queue = getQueue();
+
+		while (!job->isDone()) {
+			const JobHandle next = take(queue);
+			if (next != nullptr) {
+				execute(next);
+			} else {
+				//whatever is left is running on another thread
+				std::this_thread::yield();
+			}
+		}
+
+		std::exception_ptr error;
+		{
+			const std::unique_lock<std::mutex> guard(errorMutex);
+			error = job->error;
+		}
+
+		if (error != nullptr) {
+			std::rethrow_exception(error);
+		}
+	}
+
+	void JobSystem::parallelFor(const Index begin, const Index end, const Size batchSize, const std::function<void(Index, Index)>& function) {
+		if (begin >= end) {
+			return;
+		}
+
+		const Size batch = std::max(batchSize, static_cast<Size>(1));
+		if (end - begin <= batch) {
+			function(begin, end);
+			return;
+		}
+
+		const JobHandle parent = create([]() {});
+		for (Index i = begin; i < end; i += batch) {
+			const Index batchEnd = std::min(i + batch, end);
+			run([&function, i, batchEnd]() {
+				function(i, batchEnd);
+			}, parent);
+		}
+		run(parent);
+
+		wait(parent);
+	}
+
+	unsigned int JobSystem::getWorkerCount() const {
+		return static_cast<unsigned int>(workers.size());
+	}
+
+	JobSystem* JobSystem::getCurrent() {
+		return currentJobSystem;
+	}
+
+	void JobSystem::setCurrent(JobSystem* jobs) {
+		currentJobSystem = jobs;
+	}
+
+	void JobSystem::work(const Index queue) {
+		currentJobSystem = this;
+		currentQueue = queue;
+
+		while (running) {
+			const JobHandle job = take(queue);
+			if (job != nullptr) {
+				execute(job);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> guard(sleepMutex);
+			wake.wait(guard, [this]() {
+				return !running || queued > 0;
+			});
+		}
+	}
+
+	JobHandle JobSystem::take(const Index queue) {
+		{
+			Queue& own = *queues[queue];
+			const std::unique_lock<std::mutex> guard(own.mutex);
+			if (!own.jobs.empty()) {
+				JobHandle job = std::move(own.jobs.back());
+				own.jobs.pop_back();
+				--queued;
+				return job;
+			}
+		}
+
+		for (Index i = 1; i < queues.size(); ++i) {
+			Queue& other = *queues[(queue + i) % queues.size()];
+			const std::unique_lock<std::mutex> guard(other.mutex);
+			if (!other.jobs.empty()) {
+				JobHandle job = std::move(other.jobs.front());
+				other.jobs.pop_front();
+				--queued;
+				return job;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void JobSystem::execute(const JobHandle& job) {
+		try {
+			job->function();
+		} catch (...) {
+			const std::unique_lock<std::mutex> guard(errorMutex);
+			if (job->error == nullptr) {
+				job->error = std::current_exception();
+			}
+		}
+
+		finish(job.get());
+	}
+
+	void JobSystem::finish(Job* job) {
+		while (job != nullptr && --job->unfinished == 0) {
+			Job* const parent = job->parent.get();
+
+			if (parent != nullptr) {
+				const std::unique_lock<std::mutex> guard(errorMutex);
+				if (parent->error == nullptr) {
+					parent->error = job->error;
+				}
+			}
+
+			job = parent;
+		}
+	}
+
+	Index JobSystem::getQueue() const {
+		return currentJobSystem == this ? currentQueue : 0;
+	}
+}//mc
@@ -20,6 +20,11 @@ See LICENSE.md for full copyright information
 #	include <unistd.h>
 #	include <errno.h>
 #	include <cstring>
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#else
+#	include <fstream>
 #endif
 
 namespace mc {
@@ -243,6 +248,99 @@ namespace mc {
 #endif
 		}
 
+		const Byte* mapFile(const char* path, Size* size) {
+#ifdef MACE_WINAPI
+			const HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE) {
+				MACE__THROW(FileNotFound, "Failed to open " + std::string(path) + ": error code " + std::to_string(GetLastError()));
+			}
+
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+				CloseHandle(file);
+
+				MACE__THROW(BadFile, std::string(path) + " is empty or its size can\'t be read");
+			}
+
+			*size = static_cast<Size>(fileSize.QuadPart);
+
+			const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			//the view keeps the file and the mapping open on its own
+			CloseHandle(file);
+			if (mapping == nullptr) {
+				MACE__THROW(BadFile, "Failed to map " + std::string(path) + ": error code " + std::to_string(GetLastError()));
+			}
+
+			const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
+			if (data == nullptr) {
+				MACE__THROW(BadFile, "Failed to map " + std::string(path) + ": error code " + std::to_string(GetLastError()));
+			}
+
+			return static_cast<const Byte*>(data);
+#elif defined(MACE_POSIX)
+			char buffer[128];
+
+			const int file = open(path, O_RDONLY);
+			if (file < 0) {
+				MACE__THROW(FileNotFound, "Failed to open " + std::string(path) + ": " + os::strerror(buffer, sizeof(buffer), errno));
+			}
+
+			struct stat status;
+			if (fstat(file, &status) != 0 || status.st_size == 0) {
+				close(file);
+
+				MACE__THROW(BadFile, std::string(path) + " is empty or its size can\'t be read");
+			}
+
+			*size = static_cast<Size>(status.st_size);
+
+			void* data = mmap(nullptr, *size, PROT_READ, MAP_PRIVATE, file, 0);
+			//the mapping keeps the file open on its own
+			close(file);
+			if (data == MAP_FAILED) {
+				MACE__THROW(BadFile, "Failed to map " + std::string(path) + ": " + os::strerror(buffer, sizeof(buffer), errno));
+			}
+
+			return static_cast<const Byte*>(data);
+#else
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file) {
+				MACE__THROW(FileNotFound, "Failed to open " + std::string(path));
+			}
+
+			*size = static_cast<Size>(file.tellg());
+			if (*size == 0) {
+				MACE__THROW(BadFile, std::string(path) + " is empty");
+			}
+
+			Byte* data = new Byte[*size];
+
+			file.seekg(0);
+			if (!file.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(*size))) {
+				delete[] data;
+
+				MACE__THROW(BadFile, "Failed to read " + std::string(path));
+			}
+
+			return data;
+#endif
+		}
+
+		void unmapFile(const Byte* data, const Size size) {
+#ifdef MACE_WINAPI
+			static_cast<void>(size);
+
+			UnmapViewOfFile(data);
+#elif defined(MACE_POSIX)
+			munmap(const_cast<Byte*>(data), size);
+#else
+			static_cast<void>(size);
+
+			delete[] data;
+#endif
+		}
+
 		void clearError(const unsigned int, const char*) {
 #ifdef MACE_WINAPI
 			SetLastError(0);
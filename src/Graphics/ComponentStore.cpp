@@ -0,0 +1,25 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <MACE/Graphics/ComponentStore.h>
+
+namespace mc {
+	namespace gfx {
+		void ComponentStore::update() {
+			//a system can create another one while it updates, which would invalidate an iterator
+			for (Index i = 0; i < systems.size(); ++i) {
+				systems[i]->update();
+			}
+		}
+
+		Size ComponentStore::size() const {
+			Size out = 0;
+			for (const std::unique_ptr<ComponentSystem>& system : systems) {
+				out += system->size();
+			}
+			return out;
+		}
+	}//gfx
+}//mc
@@ -6,7 +6,13 @@ See LICENSE.md for full copyright information
 #define MACE__COMPONENTS_EXPOSE_MAKE_EASE_FUNCTION//this macro exposes the MACE__MAKE_EASE_FUNCTION macro
 #include <MACE/Graphics/Components.h>
 #include <MACE/Graphics/Entity2D.h>
+#include <algorithm>
 #include <iostream>
+#include <limits>
+
+#ifdef MACE_SSE
+#	include <emmintrin.h>
+#endif
 
 namespace mc {
 	namespace gfx {
@@ -726,6 +732,467 @@ namespace mc {
 			return !operator==(other);
 		}
 
+		EaseSystem::Handle EaseSystem::add(Entity * const entity, const EaseComponent::EaseUpdateCallback callback, const EaseSettings settings, const float start, const float dest) {
+			Callbacks cold = Callbacks();
+			cold.settings = settings;
+			cold.update = callback;
+
+			Ease ease = Ease();
+			//the next update advances by the time since the last one, which this ease wasn't around for
+			ease.elapsed = updated ? -std::chrono::duration<float>(std::chrono::steady_clock::now() - lastUpdate).count() : 0.0f;
+			ease.duration = static_cast<float>(settings.ms) / 1000.0f;
+			ease.progress = 0.0f;
+			ease.start = start;
+			ease.destination = dest;
+			ease.repetition = 0;
+			ease.callbacks = callbacks.create(std::move(cold));
+
+			return eases.add(entity, ease);
+		}
+
+		void EaseSystem::remove(const Handle handle) {
+			if (!eases.isValid(handle)) {
+				MACE__THROW(ObjectNotFound, "Handle passed to EaseSystem::remove() isn\'t easing");
+			}
+
+			if (advancing) {
+				removed.push_back(handle);
+			} else {
+				erase(handle);
+			}
+		}
+
+		bool EaseSystem::isEasing(const Handle handle) const {
+			return eases.isValid(handle);
+		}
+
+		float EaseSystem::getProgress(const Handle handle) const {
+			const Ease* ease = eases.get(handle);
+			if (ease == nullptr) {
+				MACE__THROW(ObjectNotFound, "Handle passed to EaseSystem::getProgress() isn\'t easing");
+			}
+
+			return ease->progress;
+		}
+
+		void EaseSystem::update() {
+			const std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
+			const float seconds = std::chrono::duration<float>(now - lastUpdate).count();
+			lastUpdate = now;
+			updated = true;
+
+			advance(seconds);
+		}
+
+		void EaseSystem::advance(const float seconds) {
+			std::vector<Handle> finished = std::vector<Handle>();
+
+			advancing = true;
+
+			//eases added by callbacks start next time
+			const Size count = eases.size();
+			for (Index i = 0; i < count; ++i) {
+				Ease& ease = eases.getData()[i];
+
+				ease.elapsed += seconds;
+				ease.progress = ease.duration > 0.0f ? std::min(std::max(ease.elapsed / ease.duration, 0.0f), 1.0f) : 1.0f;
+
+				const Callbacks& cold = *callbacks.get(ease.callbacks);
+				const float value = cold.settings.reverseOnRepeat && ease.repetition % 2
+					? cold.settings.ease(ease.progress, ease.destination, ease.start - ease.destination, 1.0f)
+					: cold.settings.ease(ease.progress, ease.start, ease.destination - ease.start, 1.0f);
+
+				const bool done = ease.progress >= 1.0f;
+				if (done) {
+					ease.elapsed = 0.0f;
+					++ease.repetition;
+				}
+
+				const bool last = done && cold.settings.repeats >= 0 && ease.repetition >= cold.settings.repeats;
+
+				//the callback can add eases and move the array, so ease can't be used after this
+				cold.update(eases.getOwners()[i], value);
+
+				if (last) {
+					finished.push_back(eases.getHandle(i));
+				}
+			}
+
+			advancing = false;
+
+			for (const Handle handle : removed) {
+				if (eases.isValid(handle)) {
+					erase(handle);
+				}
+			}
+			removed.clear();
+
+			for (const Handle handle : finished) {
+				if (!eases.isValid(handle)) {
+					continue;
+				}
+
+				Entity* const owner = eases.getOwners()[eases.getPosition(handle)];
+				const EaseSettings::EaseDoneCallback done = callbacks.get(eases.get(handle)->callbacks)->settings.done;
+
+				erase(handle);
+
+				done(owner);
+			}
+		}
+
+		Size EaseSystem::size() const {
+			return eases.size();
+		}
+
+		void EaseSystem::erase(const Handle handle) {
+			callbacks.destroy(eases.get(handle)->callbacks);
+			eases.remove(handle);
+		}
+
+		namespace {
+			template<typename T>
+			void removeSwapped(std::vector<T>& vector, const Index position) {
+				if (position + 1 < vector.size()) {
+					vector[position] = std::move(vector.back());
+				}
+				vector.pop_back();
+			}
+		}//anon namespace
+
+		TweenSystem::Handle TweenSystem::add(float* const value, const float start, const float dest, const EaseSettings settings) {
+#ifdef MACE_DEBUG_CHECK_NULLPTR
+			if (value == nullptr) {
+				MACE__THROW(NullPointer, "Value passed to TweenSystem::add() was nullptr");
+			}
+#endif
+
+			Tween tween = Tween();
+			tween.binding = Binding::FLOAT;
+			tween.value = value;
+
+			return insert(std::move(tween), start, dest, settings);
+		}
+
+		TweenSystem::Handle TweenSystem::add(Progressable* const progressable, const float start, const float dest, const EaseSettings settings) {
+#ifdef MACE_DEBUG_CHECK_NULLPTR
+			if (progressable == nullptr) {
+				MACE__THROW(NullPointer, "Progressable passed to TweenSystem::add() was nullptr");
+			}
+#endif
+
+			Tween tween = Tween();
+			tween.binding = Binding::PROGRESSABLE;
+			tween.progressable = progressable;
+
+			return insert(std::move(tween), start, dest, settings);
+		}
+
+		TweenSystem::Handle TweenSystem::add(Entity* const entity, const TransformMatrix& start, const TransformMatrix& dest, const EaseSettings settings) {
+#ifdef MACE_DEBUG_CHECK_NULLPTR
+			if (entity == nullptr) {
+				MACE__THROW(NullPointer, "Entity passed to TweenSystem::add() was nullptr");
+			}
+#endif
+
+			Tween tween = Tween();
+			tween.binding = Binding::TRANSFORM;
+			tween.entity = entity;
+
+			//the arrays hold how far along the transformations are, which apply() interpolates them by
+			const Handle handle = insert(std::move(tween), 0.0f, 1.0f, settings);
+
+			Transforms matrices = Transforms();
+			matrices.start = start;
+			matrices.destination = dest;
+
+			const Slot& slot = slots[handle.index];
+			groups[slot.group]->tweens[slot.position].transforms = transforms.create(std::move(matrices));
+
+			return handle;
+		}
+
+		TweenSystem::Handle TweenSystem::add(Entity* const entity, const TransformMatrix& dest, const EaseSettings settings) {
+#ifdef MACE_DEBUG_CHECK_NULLPTR
+			if (entity == nullptr) {
+				MACE__THROW(NullPointer, "Entity passed to TweenSystem::add() was nullptr");
+			}
+#endif
+
+			return add(entity, entity->getTransformation(), dest, settings);
+		}
+
+		void TweenSystem::remove(const Handle handle) {
+			if (getSlot(handle) == nullptr) {
+				MACE__THROW(ObjectNotFound, "Handle passed to TweenSystem::remove() isn\'t tweening");
+			}
+
+			if (advancing) {
+				removed.push_back(handle);
+			} else {
+				erase(handle);
+			}
+		}
+
+		bool TweenSystem::isTweening(const Handle handle) const {
+			return getSlot(handle) != nullptr;
+		}
+
+		float TweenSystem::getProgress(const Handle handle) const {
+			const Slot* slot = getSlot(handle);
+			if (slot == nullptr) {
+				MACE__THROW(ObjectNotFound, "Handle passed to TweenSystem::getProgress() isn\'t tweening");
+			}
+
+			return groups[slot->group]->progress[slot->position];
+		}
+
+		void TweenSystem::update() {
+			const std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
+			const float seconds = std::chrono::duration<float>(now - lastUpdate).count();
+			lastUpdate = now;
+			updated = true;
+
+			advance(seconds);
+		}
+
+		void TweenSystem::advance(const float seconds) {
+			finished.clear();
+
+			advancing = true;
+
+			//groups are never removed, and are held by pointer, so applying a tween can add more without moving them
+			for (Index g = 0; g < groups.size(); ++g) {
+				Group& group = *groups[g];
+
+				//tweens added while applying start next time
+				const Size count = group.size();
+
+				float* const elapsed = group.elapsed.data();
+				float* const progress = group.progress.data();
+				const float* const rate = group.rate.data();
+
+				Index i = 0;
+#ifdef MACE_SSE
+				const __m128 step = _mm_set1_ps(seconds), zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+				for (; i + 4 <= count; i += 4) {
+					const __m128 time = _mm_add_ps(_mm_loadu_ps(elapsed + i), step);
+					_mm_storeu_ps(elapsed + i, time);
+					_mm_storeu_ps(progress + i, _mm_min_ps(_mm_max_ps(_mm_mul_ps(time, _mm_loadu_ps(rate + i)), zero), one));
+				}
+#endif
+				for (; i < count; ++i) {
+					elapsed[i] += seconds;
+					progress[i] = std::min(std::max(elapsed[i] * rate[i], 0.0f), 1.0f);
+				}
+
+				//every tween in a group has the same curve, so it is eased from 0 to 1 and scaled afterwards
+				float* const value = group.value.data();
+				const Curve curve = group.curve;
+				for (i = 0; i < count; ++i) {
+					value[i] = curve(progress[i], 0.0f, 1.0f, 1.0f);
+				}
+
+				const float* const start = group.start.data();
+				const float* const change = group.change.data();
+
+				i = 0;
+#ifdef MACE_SSE
+				for (; i + 4 <= count; i += 4) {
+					_mm_storeu_ps(value + i, _mm_add_ps(_mm_loadu_ps(start + i), _mm_mul_ps(_mm_loadu_ps(change + i), _mm_loadu_ps(value + i))));
+				}
+#endif
+				for (; i < count; ++i) {
+					value[i] = start[i] + change[i] * value[i];
+				}
+
+				for (i = 0; i < count; ++i) {
+					//setting a transformation or progress can add tweens to this group and move its arrays, so nothing from above is used here
+					apply(group, i);
+
+					if (group.progress[i] < 1.0f) MACE_LIKELY{
+						continue;
+					}
+
+					group.elapsed[i] = 0.0f;
+
+					Tween& tween = group.tweens[i];
+					++tween.repetition;
+
+					if (tween.reverseOnRepeat) {
+						group.start[i] += group.change[i];
+						group.change[i] = -group.change[i];
+					}
+
+					if (tween.repeats >= 0 && tween.repetition >= tween.repeats) {
+						Handle handle = Handle();
+						handle.index = tween.slot;
+						handle.generation = slots[tween.slot].generation;
+						finished.push_back(handle);
+					}
+				}
+			}
+
+			advancing = false;
+
+			for (const Handle handle : removed) {
+				if (getSlot(handle) != nullptr) {
+					erase(handle);
+				}
+			}
+			removed.clear();
+
+			for (const Handle handle : finished) {
+				const Slot* slot = getSlot(handle);
+				if (slot == nullptr) {
+					continue;
+				}
+
+				const Tween& tween = groups[slot->group]->tweens[slot->position];
+				Entity* const entity = tween.entity;
+				const EaseSettings::EaseDoneCallback done = tween.done;
+
+				erase(handle);
+
+				done(entity);
+			}
+		}
+
+		Size TweenSystem::size() const {
+			return tweenCount;
+		}
+
+		Size TweenSystem::getGroupCount() const {
+			return groups.size();
+		}
+
+		Size TweenSystem::Group::size() const {
+			return tweens.size();
+		}
+
+		void TweenSystem::Group::removeAt(const Index position) {
+			removeSwapped(elapsed, position);
+			removeSwapped(rate, position);
+			removeSwapped(progress, position);
+			removeSwapped(start, position);
+			removeSwapped(change, position);
+			removeSwapped(value, position);
+			removeSwapped(tweens, position);
+		}
+
+		TweenSystem::Handle TweenSystem::insert(Tween tween, const float start, const float dest, const EaseSettings& settings) {
+			const Curve* curve = settings.ease.target<Curve>();
+			if (curve == nullptr) {
+				MACE__THROW(InvalidType, "TweenSystem can only ease with plain functions, such as the ones in EaseFunctions. Use EaseSystem instead");
+			}
+
+			Index groupIndex = 0;
+			while (groupIndex < groups.size() && groups[groupIndex]->curve != *curve) {
+				++groupIndex;
+			}
+
+			if (groupIndex == groups.size()) {
+				groups.push_back(std::unique_ptr<Group>(new Group()));
+				groups.back()->curve = *curve;
+			}
+
+			Index slot;
+			if (freeSlots.empty()) {
+				slot = slots.size();
+				slots.push_back(Slot());
+			} else {
+				slot = freeSlots.back();
+				freeSlots.pop_back();
+			}
+
+			Group& group = *groups[groupIndex];
+
+			slots[slot].group = groupIndex;
+			slots[slot].position = group.size();
+
+			const float duration = static_cast<float>(settings.ms) / 1000.0f;
+
+			//the next update advances by the time since the last one, which this tween wasn't around for
+			const float missed = updated ? std::chrono::duration<float>(std::chrono::steady_clock::now() - lastUpdate).count() : 0.0f;
+			group.elapsed.push_back(duration > 0.0f ? -missed : 0.0f);
+			//tweens without a duration finish on the next update
+			group.rate.push_back(duration > 0.0f ? 1.0f / duration : std::numeric_limits<float>::max());
+			group.progress.push_back(0.0f);
+			group.start.push_back(start);
+			group.change.push_back(dest - start);
+			group.value.push_back(start);
+
+			tween.repeats = settings.repeats;
+			tween.reverseOnRepeat = settings.reverseOnRepeat;
+			tween.done = settings.done;
+			tween.slot = slot;
+			group.tweens.push_back(std::move(tween));
+
+			++tweenCount;
+
+			Handle out = Handle();
+			out.index = slot;
+			out.generation = slots[slot].generation;
+			return out;
+		}
+
+		void TweenSystem::erase(const Handle handle) {
+			Slot& slot = slots[handle.index];
+			Group& group = *groups[slot.group];
+			const Index position = slot.position;
+
+			if (group.tweens[position].binding == Binding::TRANSFORM) {
+				transforms.destroy(group.tweens[position].transforms);
+			}
+
+			group.removeAt(position);
+
+			//the last tween was moved into the hole
+			if (position < group.size()) {
+				slots[group.tweens[position].slot].position = position;
+			}
+
+			slot.group = static_cast<Index>(-1);
+			slot.position = static_cast<Index>(-1);
+			++slot.generation;
+			freeSlots.push_back(handle.index);
+
+			--tweenCount;
+		}
+
+		const TweenSystem::Slot* TweenSystem::getSlot(const Handle handle) const {
+			if (handle.index >= slots.size()) {
+				return nullptr;
+			}
+
+			const Slot& slot = slots[handle.index];
+			return slot.generation == handle.generation && slot.group != static_cast<Index>(-1) ? &slot : nullptr;
+		}
+
+		void TweenSystem::apply(Group& group, const Index position) {
+			const Tween& tween = group.tweens[position];
+			const float value = group.value[position];
+
+			switch (tween.binding) {
+				case Binding::FLOAT:
+					*tween.value = value;
+					break;
+				case Binding::PROGRESSABLE:
+					tween.progressable->setProgress(value);
+					break;
+				case Binding::TRANSFORM: {
+					const Transforms& matrices = *transforms.get(tween.transforms);
+
+					TransformMatrix current = TransformMatrix();
+					current.translation = math::lerp(matrices.start.translation, matrices.destination.translation, value);
+					current.rotation = math::lerp(matrices.start.rotation, matrices.destination.rotation, value);
+					current.scaler = math::lerp(matrices.start.scaler, matrices.destination.scaler, value);
+					tween.entity->setTransformation(current);
+					break;
+				}
+			}
+		}
+
 		ComponentQueue::ComponentQueue(std::queue<std::shared_ptr<Component>> com) :components(com) {}
 
 		ComponentQueue::ComponentQueue() : ComponentQueue(std::queue<std::shared_ptr<Component>>()) {}
@@ -735,7 +1202,7 @@ namespace mc {
 		}
 
 		void ComponentQueue::addComponent(Component * com) {
-			addComponent(std::shared_ptr<Component>(com, [](Component*) {}));
+			addComponent(std::shared_ptr<Component>(std::shared_ptr<Component>(), com));
 		}
 
 		void ComponentQueue::addComponent(std::shared_ptr<Component> com) {
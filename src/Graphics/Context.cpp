@@ -5,6 +5,7 @@ See LICENSE.md for full copyright information
 */
 #include <MACE/Graphics/Context.h>
 #include <MACE/Graphics/Renderer.h>
+#include <MACE/Graphics/Path.h>
 
 #ifdef MACE_GCC
 //stb_image raises this warning and can be safely ignored
@@ -43,14 +44,13 @@ namespace mc {
 #	define MACE__VERIFY_MODEL_INIT()
 #endif
 
-#define MACE__RESOURCE_PREFIX "MC/"
-
-		//these are the names for cached resources in the GraphicsContext
-#define MACE__RESOURCE_SOLIDCOLOR MACE__RESOURCE_PREFIX "SolidColor"
-#define MACE__RESOURCE_GRADIENT MACE__RESOURCE_PREFIX "Gradient"
 		//how many pixels in the gradient
 #define MACE__RESOURCE_GRADIENT_HEIGHT 128
-#define MACE__RESOURCE_QUAD MACE__RESOURCE_PREFIX "Quad"
+
+		//how many tessellated paths are kept before the cache is flushed
+#ifndef MACE__PATH_MESH_CACHE_SIZE
+#	define MACE__PATH_MESH_CACHE_SIZE 1024
+#endif
 
 		bool ModelImpl::operator==(const ModelImpl& other) const {
 			return primitiveType == other.primitiveType;
@@ -64,37 +64,9 @@ namespace mc {
 			GraphicsContext* context = gfx::getCurrentWindow()->getContext();
 			if (context == nullptr) {
 				MACE__THROW(NullPointer, "No graphics context found in window!");
-			} else {
-				return context->getOrCreateModel(MACE__RESOURCE_QUAD, []() {
-					Model model = Model();
-					model.init();
-
-					MACE_CONSTEXPR const float squareTextureCoordinates[8] = {
-						0.0f,1.0f,
-						0.0f,0.0f,
-						1.0f,0.0f,
-						1.0f,1.0f,
-					};
-
-					MACE_CONSTEXPR const unsigned int squareIndices[6] = {
-						0,1,3,
-						1,2,3
-					};
-
-					MACE_CONSTEXPR const float squareVertices[12] = {
-						-1.0f,-1.0f,0.0f,
-						-1.0f,1.0f,0.0f,
-						1.0f,1.0f,0.0f,
-						1.0f,-1.0f,0.0f
-					};
-
-					model.createVertices(squareVertices, PrimitiveType::TRIANGLES);
-					model.createIndices(squareIndices);
-					model.createTextureCoordinates(squareTextureCoordinates);
-
-					return model;
-				});
 			}
+
+			return context->getQuad();
 		}
 
 		Model::Model() : model(nullptr) {}
@@ -360,55 +332,18 @@ namespace mc {
 			GraphicsContext* context = gfx::getCurrentWindow()->getContext();
 			if (context == nullptr) {
 				MACE__THROW(NullPointer, "No graphics context found in window!");
-			} else {
-				return context->getOrCreateTexture(MACE__RESOURCE_SOLIDCOLOR, []() {
-					TextureDesc desc = TextureDesc(1, 1, TextureDesc::Format::LUMINANCE);
-					desc.minFilter = TextureDesc::Filter::NEAREST;
-					desc.magFilter = TextureDesc::Filter::NEAREST;
-					desc.type = TextureDesc::Type::FLOAT;
-					desc.internalFormat = TextureDesc::InternalFormat::RED;
-
-					Texture texture = Texture(desc);
-
-					texture.resetPixelStorage();
-
-					MACE_CONSTEXPR const float data[] = {1.0f};
-					texture.setData(data);
-
-					return texture;
-				});
 			}
+
+			return context->getSolidColor();
 		}
 
 		Texture& Texture::getGradient() {
 			GraphicsContext* context = gfx::getCurrentWindow()->getContext();
 			if (context == nullptr) {
 				MACE__THROW(NullPointer, "No graphics context found in window!");
-			} else {
-
-
-				return context->getOrCreateTexture(MACE__RESOURCE_GRADIENT, []() {
-					TextureDesc desc = TextureDesc(1, MACE__RESOURCE_GRADIENT_HEIGHT);
-					desc.format = TextureDesc::Format::LUMINANCE;
-					desc.type = TextureDesc::Type::FLOAT;
-					desc.internalFormat = TextureDesc::InternalFormat::RED;
-					desc.minFilter = TextureDesc::Filter::LINEAR;
-					desc.magFilter = TextureDesc::Filter::NEAREST;
-					Texture texture = Texture(desc);
-
-					texture.resetPixelStorage();
-
-
-					float data[MACE__RESOURCE_GRADIENT_HEIGHT];
-					for (unsigned int i = 0; i < MACE__RESOURCE_GRADIENT_HEIGHT; ++i) {
-						//the darker part is on the bottom
-						data[i] = static_cast<float>(MACE__RESOURCE_GRADIENT_HEIGHT - i) / static_cast<float>(MACE__RESOURCE_GRADIENT_HEIGHT);
-					}
-					texture.setData(data);
-
-					return texture;
-				});
 			}
+
+			return context->getGradient();
 		}
 
 		Texture::Texture() : texture(nullptr), hue(0.0f, 0.0f, 0.0f, 0.0f) {}
@@ -522,6 +457,18 @@ namespace mc {
 			texture->setData(data, mipmap);
 		}
 
+		void Texture::setSubData(const void* data, const unsigned int x, const unsigned int y, const unsigned int width, const unsigned int height, const int mipmap) {
+			MACE__VERIFY_TEXTURE_INIT();
+
+#ifdef MACE_DEBUG_CHECK_ARGS
+			if (x + width > texture->desc.width || y + height > texture->desc.height) {
+				MACE__THROW(OutOfBounds, "Region passed to setSubData is outside of the Texture");
+			}
+#endif
+
+			texture->setSubData(data, x, y, width, height, mipmap);
+		}
+
 		void Texture::setUnpackStorageHint(const PixelStorage hint, const int value) {
 			MACE__VERIFY_TEXTURE_INIT();
 
@@ -556,20 +503,115 @@ namespace mc {
 			return window;
 		}
 
+		Model& GraphicsContext::getQuad() {
+			if (quad.model == nullptr) MACE_UNLIKELY{
+				quad.init();
+
+				MACE_CONSTEXPR const float squareTextureCoordinates[8] = {
+					0.0f,1.0f,
+					0.0f,0.0f,
+					1.0f,0.0f,
+					1.0f,1.0f,
+				};
+
+				MACE_CONSTEXPR const unsigned int squareIndices[6] = {
+					0,1,3,
+					1,2,3
+				};
+
+				MACE_CONSTEXPR const float squareVertices[12] = {
+					-1.0f,-1.0f,0.0f,
+					-1.0f,1.0f,0.0f,
+					1.0f,1.0f,0.0f,
+					1.0f,-1.0f,0.0f
+				};
+
+				quad.createVertices(squareVertices, PrimitiveType::TRIANGLES);
+				quad.createIndices(squareIndices);
+				quad.createTextureCoordinates(squareTextureCoordinates);
+			}
+
+			return quad;
+		}
+
+		Texture& GraphicsContext::getSolidColor() {
+			if (!solidColor.isCreated()) MACE_UNLIKELY{
+				TextureDesc desc = TextureDesc(1, 1, TextureDesc::Format::LUMINANCE);
+				desc.minFilter = TextureDesc::Filter::NEAREST;
+				desc.magFilter = TextureDesc::Filter::NEAREST;
+				desc.type = TextureDesc::Type::FLOAT;
+				desc.internalFormat = TextureDesc::InternalFormat::RED;
+
+				solidColor.init(desc);
+
+				solidColor.resetPixelStorage();
+
+				MACE_CONSTEXPR const float data[] = {1.0f};
+				solidColor.setData(data);
+			}
+
+			return solidColor;
+		}
+
+		Texture& GraphicsContext::getGradient() {
+			if (!gradient.isCreated()) MACE_UNLIKELY{
+				TextureDesc desc = TextureDesc(1, MACE__RESOURCE_GRADIENT_HEIGHT);
+				desc.format = TextureDesc::Format::LUMINANCE;
+				desc.type = TextureDesc::Type::FLOAT;
+				desc.internalFormat = TextureDesc::InternalFormat::RED;
+				desc.minFilter = TextureDesc::Filter::LINEAR;
+				desc.magFilter = TextureDesc::Filter::NEAREST;
+
+				gradient.init(desc);
+
+				gradient.resetPixelStorage();
+
+				float data[MACE__RESOURCE_GRADIENT_HEIGHT];
+				for (unsigned int i = 0; i < MACE__RESOURCE_GRADIENT_HEIGHT; ++i) {
+					//the darker part is on the bottom
+					data[i] = static_cast<float>(MACE__RESOURCE_GRADIENT_HEIGHT - i) / static_cast<float>(MACE__RESOURCE_GRADIENT_HEIGHT);
+				}
+				gradient.setData(data);
+			}
+
+			return gradient;
+		}
+
+		ResourceID GraphicsContext::getTextureID(const std::string & name) {
+			return textures.intern(name);
+		}
+
+		ResourceID GraphicsContext::getModelID(const std::string & name) {
+			return models.intern(name);
+		}
+
+		Texture& GraphicsContext::createTexture(const ResourceID id, const Texture & texture) {
+			if (hasTexture(id)) {
+				MACE__THROW(AlreadyExists, "Texture with ID " + std::to_string(id) + " has already been created");
+			}
+
+			return textures.set(id, texture);
+		}
+
 		Texture& GraphicsContext::createTexture(const std::string & name, const Texture & texture) {
-			if (hasTexture(name)) {
+			const ResourceID id = getTextureID(name);
+			if (hasTexture(id)) {
 				MACE__THROW(AlreadyExists, "Texture with name " + name + " has already been created");
 			}
 
-			return textures[name] = texture;
+			return textures.set(id, texture);
 		}
 
-		Texture& GraphicsContext::getOrCreateTexture(const std::string & name, const TextureCreateCallback create) {
-			if (!hasTexture(name)) {
-				return createTexture(name, create());
-			} else {
-				return getTexture(name);
+		Texture& GraphicsContext::getOrCreateTexture(const ResourceID id, const TextureCreateCallback & create) {
+			if (!hasTexture(id)) {
+				return textures.set(id, create());
 			}
+
+			return textures.get(id);
+		}
+
+		Texture& GraphicsContext::getOrCreateTexture(const std::string & name, const TextureCreateCallback & create) {
+			return getOrCreateTexture(getTextureID(name), create);
 		}
 
 		Texture& GraphicsContext::getOrCreateTextureFromFile(const std::string & name, const std::string & path) {
@@ -578,71 +620,176 @@ namespace mc {
 			});
 		}
 
+		Model& GraphicsContext::createModel(const ResourceID id, const Model & mod) {
+			if (hasModel(id)) {
+				MACE__THROW(AlreadyExists, "Model with ID " + std::to_string(id) + " has already been created");
+			}
+
+			return models.set(id, mod);
+		}
+
 		Model& GraphicsContext::createModel(const std::string & name, const Model & mod) {
-			if (hasModel(name)) {
+			const ResourceID id = getModelID(name);
+			if (hasModel(id)) {
 				MACE__THROW(AlreadyExists, "Model with name " + name + " has already been created");
 			}
 
-			return models[name] = mod;
+			return models.set(id, mod);
 		}
 
-		Model& GraphicsContext::getOrCreateModel(const std::string & name, const ModelCreateCallback create) {
-			if (!hasModel(name)) {
-				return createModel(name, create());
-			} else {
-				return getModel(name);
+		Model& GraphicsContext::getOrCreateModel(const ResourceID id, const ModelCreateCallback & create) {
+			if (!hasModel(id)) {
+				return models.set(id, create());
 			}
+
+			return models.get(id);
+		}
+
+		Model& GraphicsContext::getOrCreateModel(const std::string & name, const ModelCreateCallback & create) {
+			return getOrCreateModel(getModelID(name), create);
+		}
+
+		bool GraphicsContext::hasTexture(const ResourceID id) const {
+			return textures.has(id);
 		}
 
 		bool GraphicsContext::hasTexture(const std::string & name) const {
-			//map.count() returns 1 if key exists, 0 otherwise.
-			return textures.count(name) != 0;//the verbosity is to suppress warnings of casting from std::size_t to bool
+			return textures.has(name);
+		}
+
+		bool GraphicsContext::hasModel(const ResourceID id) const {
+			return models.has(id);
 		}
 
 		bool GraphicsContext::hasModel(const std::string & name) const {
-			return models.count(name) != 0;
+			return models.has(name);
+		}
+
+		void GraphicsContext::setTexture(const ResourceID id, const Texture & texture) {
+			textures.set(id, texture);
 		}
 
 		void GraphicsContext::setTexture(const std::string & name, const Texture & texture) {
-			textures[name] = texture;
+			textures.set(getTextureID(name), texture);
+		}
+
+		Texture& GraphicsContext::getTexture(const ResourceID id) {
+			return textures.get(id);
+		}
+
+		const Texture& GraphicsContext::getTexture(const ResourceID id) const {
+			return textures.get(id);
 		}
 
 		Texture& GraphicsContext::getTexture(const std::string & name) {
-			return textures.at(name);
+			return textures.get(textures.find(name));
 		}
 
 		const Texture& GraphicsContext::getTexture(const std::string & name) const {
-			return textures.at(name);
+			return textures.get(textures.find(name));
+		}
+
+		void GraphicsContext::setModel(const ResourceID id, const Model & model) {
+			models.set(id, model);
 		}
 
 		void GraphicsContext::setModel(const std::string & name, const Model & model) {
-			models[name] = model;
+			models.set(getModelID(name), model);
+		}
+
+		Model& GraphicsContext::getModel(const ResourceID id) {
+			return models.get(id);
+		}
+
+		const Model& GraphicsContext::getModel(const ResourceID id) const {
+			return models.get(id);
 		}
 
 		Model& GraphicsContext::getModel(const std::string & name) {
-			return models.at(name);
+			return models.get(models.find(name));
 		}
 
 		const Model& GraphicsContext::getModel(const std::string & name) const {
-			return models.at(name);
+			return models.get(models.find(name));
 		}
 
-		std::map<std::string, Texture>& GraphicsContext::getTextures() {
+		ResourceTable<Texture>& GraphicsContext::getTextures() {
 			return textures;
 		}
 
-		const std::map<std::string, Texture>& GraphicsContext::getTextures() const {
+		const ResourceTable<Texture>& GraphicsContext::getTextures() const {
 			return textures;
 		}
 
-		std::map<std::string, Model>& GraphicsContext::getModels() {
+		ResourceTable<Model>& GraphicsContext::getModels() {
 			return models;
 		}
 
-		const std::map<std::string, Model>& GraphicsContext::getModels() const {
+		const ResourceTable<Model>& GraphicsContext::getModels() const {
 			return models;
 		}
 
+		struct GraphicsContext::PathMeshEntry {
+			Path path;
+			float width;
+			int featherExponent;
+			bool stroke;
+
+			Model model;
+
+			bool matches(const Path& p, const float w, const int exponent, const bool s) const {
+				return width == w && featherExponent == exponent && stroke == s && path == p;
+			}
+		};
+
+		namespace {
+			std::size_t hashPathMesh(const Path& path, const float width, const int featherExponent, const bool stroke) {
+				std::size_t seed = path.getHash();
+				hashCombine(seed, std::hash<float>()(width));
+				hashCombine(seed, std::hash<int>()(featherExponent * 2 + (stroke ? 1 : 0)));
+				return seed;
+			}
+		}//anon namespace
+
+		Model* GraphicsContext::findPathMesh(const Path& path, const float width, const int featherExponent, const bool stroke) {
+			const auto it = pathMeshes.find(hashPathMesh(path, width, featherExponent, stroke));
+			//a different path with the same hash is a miss, and is replaced when its mesh is stored
+			if (it == pathMeshes.end() || !it->second->matches(path, width, featherExponent, stroke)) {
+				return nullptr;
+			}
+			return &it->second->model;
+		}
+
+		Model& GraphicsContext::storePathMesh(const Path& path, const float width, const int featherExponent, const bool stroke, const Model& model) {
+			if (pathMeshes.size() >= MACE__PATH_MESH_CACHE_SIZE) MACE_UNLIKELY{
+				//paths that change every frame would otherwise grow the cache forever
+				clearPathMeshes();
+			}
+
+			std::shared_ptr<PathMeshEntry>& entry = pathMeshes[hashPathMesh(path, width, featherExponent, stroke)];
+			if (entry == nullptr) {
+				entry = std::make_shared<PathMeshEntry>();
+			} else if (entry->model.isCreated()) {
+				entry->model.destroy();
+			}
+
+			entry->path = path;
+			entry->width = width;
+			entry->featherExponent = featherExponent;
+			entry->stroke = stroke;
+			entry->model = model;
+			return entry->model;
+		}
+
+		void GraphicsContext::clearPathMeshes() {
+			for (auto& mesh : pathMeshes) {
+				if (mesh.second->model.isCreated()) {
+					mesh.second->model.destroy();
+				}
+			}
+			pathMeshes.clear();
+		}
+
 		GraphicsContext::GraphicsContext(gfx::WindowModule * win) :window(win) {
 #ifdef MACE_DEBUG_CHECK_NULLPTR
 			if (window == nullptr) {
@@ -664,18 +811,35 @@ namespace mc {
 		}
 
 		void GraphicsContext::destroy() {
-			for (auto& x : textures) {
-				if (x.second.isCreated()) {
-					x.second.destroy();
+			textures.forEach([](Texture& tex) {
+				if (tex.isCreated()) {
+					tex.destroy();
 				}
-			}
+			});
+			textures.clear();
 
-			for (auto& x : models) {
-				if (x.second.isCreated()) {
-					x.second.destroy();
+			models.forEach([](Model& mod) {
+				if (mod.isCreated()) {
+					mod.destroy();
 				}
+			});
+			models.clear();
+
+			if (solidColor.isCreated()) {
+				solidColor.destroy();
+			}
+
+			if (gradient.isCreated()) {
+				gradient.destroy();
 			}
 
+			if (quad.model != nullptr) {
+				quad.destroy();
+				quad = Model();
+			}
+
+			clearPathMeshes();
+
 			getRenderer()->destroy();
 			onDestroy(window);
 			window = nullptr;
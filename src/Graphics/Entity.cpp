@@ -4,16 +4,53 @@ Copyright (c) 2016-2019 Liav Turkia
 See LICENSE.md for full copyright information
 */
 #include <MACE/Graphics/Entity.h>
+#include <MACE/Graphics/Hierarchy.h>
 #include <MACE/Graphics/Renderer.h>
 #include <MACE/Graphics/Context.h>
 #include <MACE/Core/Constants.h>
 #include <MACE/Core/System.h>
 #include <MACE/Core/Error.h>
+#include <MACE/Core/Jobs.h>
 #include <MACE/Utility/Transform.h>
+#include <exception>
 #include <string>
 
 namespace mc {
 	namespace gfx {
+		namespace {
+			thread_local EntityCommandBuffer* currentCommandBuffer = nullptr;
+		}//anon namespace
+
+		void EntityCommandBuffer::push(const Command& command) {
+			commands.push_back(command);
+		}
+
+		void EntityCommandBuffer::apply() {
+			//a command can push more commands, so the vector can grow while it is applied
+			for (Index i = 0; i < commands.size(); ++i) {
+				const Command command = commands[i];
+				command();
+			}
+
+			commands.clear();
+		}
+
+		bool EntityCommandBuffer::isEmpty() const {
+			return commands.empty();
+		}
+
+		Size EntityCommandBuffer::size() const {
+			return commands.size();
+		}
+
+		EntityCommandBuffer* EntityCommandBuffer::getCurrent() {
+			return currentCommandBuffer;
+		}
+
+		void EntityCommandBuffer::setCurrent(EntityCommandBuffer* buffer) {
+			currentCommandBuffer = buffer;
+		}
+
 		void Component::init() {}
 
 		bool Component::update() {
@@ -41,29 +78,36 @@ namespace mc {
 		}
 
 		bool Entity::hasChild(Entity& e) const {
-			for (Size i = 0; i < children.size(); ++i) {
-				if (children[i].get() == &e) {
-					return true;
-				}
-			}
-			return false;
+			return indexOf(e) != Index(-1);
 		}
 
 		void Entity::clearChildren() {
+			EntityCommandBuffer* const buffer = EntityCommandBuffer::getCurrent();
+			if (buffer != nullptr) MACE_UNLIKELY{
+				buffer->push([this]() {
+					clearChildren();
+				});
+				return;
+			}
+
 			makeDirty();
 
 			while (!children.empty()) {
-				children.back()->kill();
+				Entity* const child = children.back().get();
+				if (child != nullptr) {
+					child->kill();
+					child->childIndex = Index(-1);
+				}
 				children.pop_back();
 			}
+
+			childHoles = false;
 		}
 
 		void Entity::makeChildrenDirty() {
-			setProperty(Entity::DIRTY, true);
-
-			for (std::shared_ptr<Entity> e : children) {
-				e->makeChildrenDirty();
-			}
+			hierarchy->visit(node, [](Entity* entity) {
+				entity->setProperty(Entity::DIRTY, true);
+			});
 		}
 
 		const std::vector<std::shared_ptr<Entity>>& Entity::getChildren() const {
@@ -84,16 +128,12 @@ namespace mc {
 			}
 #endif
 
-			for (Index i = 0; i < children.size(); ++i) {
-				if (e == children[i].get()) {
-					makeDirty();
-
-					removeChild(i);
-					return;
-				}
+			const Index index = indexOf(*e);
+			if (index == Index(-1)) {
+				MACE__THROW(ObjectNotFound, "Specified argument to removeChild is not a valid object in the array!");
 			}
 
-			MACE__THROW(ObjectNotFound, "Specified argument to removeChild is not a valid object in the array!");
+			removeChild(index);
 		}
 
 		void Entity::removeChild(std::shared_ptr<Entity> ent) {
@@ -101,18 +141,25 @@ namespace mc {
 		}
 
 		void Entity::removeChild(Index index) {
-			makeDirty();
-
 #ifdef MACE_DEBUG_CHECK_ARGS
 			if (index >= children.size()) {
 				MACE__THROW(OutOfBounds, std::to_string(index) + " is larger than the amount of children!");
-			} else
+			}
 #endif
-				if (children.size() == 1) {
-					children.clear();
-				} else {
-					removeChild(children.begin() + index);
-				}
+
+			EntityCommandBuffer* const buffer = EntityCommandBuffer::getCurrent();
+			if (buffer != nullptr) MACE_UNLIKELY{
+				//the index may be different by the time the command runs
+				const Entity* const child = children[index].get();
+				buffer->push([this, child]() {
+					removeChild(child);
+				});
+				return;
+			}
+
+			makeDirty();
+
+			eraseChild(index);
 		}
 
 		void Entity::removeChild(const std::vector<std::shared_ptr<Entity>>::iterator & iter) {
@@ -122,7 +169,76 @@ namespace mc {
 			}
 #endif
 
-			children.erase(iter);
+			eraseChild(static_cast<Index>(iter - children.begin()));
+		}
+
+		void Entity::eraseChild(const Index index) {
+			Entity* const child = children[index].get();
+			if (child != nullptr) {
+				child->childIndex = Index(-1);
+			}
+
+			if (index + 1 == children.size()) {
+				children.pop_back();
+				return;
+			}
+
+			switch (childOrder) {
+			case ChildOrder::UNORDERED:
+				children[index] = std::move(children.back());
+				children.pop_back();
+
+				if (children[index] != nullptr) {
+					children[index]->childIndex = index;
+				}
+				break;
+			case ChildOrder::DEFERRED:
+				children[index].reset();
+				childHoles = true;
+				break;
+			case ChildOrder::ORDERED:
+			default:
+				children.erase(children.begin() + index);
+
+				for (Index i = index; i < children.size(); ++i) {
+					if (children[i] != nullptr) {
+						children[i]->childIndex = i;
+					}
+				}
+				break;
+			}
+		}
+
+		void Entity::compactChildren() {
+			if (!childHoles) {
+				return;
+			}
+
+			Index next = 0;
+			for (Index i = 0; i < children.size(); ++i) {
+				if (children[i] != nullptr) {
+					if (i != next) {
+						children[next] = std::move(children[i]);
+					}
+					children[next]->childIndex = next;
+					++next;
+				}
+			}
+			children.resize(next);
+
+			childHoles = false;
+		}
+
+		void Entity::setChildOrder(const ChildOrder order) {
+			childOrder = order;
+
+			if (order != ChildOrder::DEFERRED) {
+				compactChildren();
+			}
+		}
+
+		Entity::ChildOrder Entity::getChildOrder() const {
+			return childOrder;
 		}
 
 		void Entity::render() {
@@ -141,7 +257,7 @@ namespace mc {
 				onRender();
 
 				for (Index i = 0; i < children.size(); ++i) {
-					std::shared_ptr<Entity> child = children[i];
+					Entity* const child = children[i].get();
 					if (child != nullptr) {
 						child->render();
 					}
@@ -160,67 +276,64 @@ namespace mc {
 
 		void Entity::onDestroy() {}
 
-		void Entity::hover() {
-			onHover();
-			for (Index i = 0; i < components.size(); ++i) {
-				components[i]->hover();
-			}
+		void Entity::sendInput(InputEvent& event) {
+			Entity* entity = this;
+			while (entity != nullptr) {
+				entity->onInput(event);
 
-			//propagate upwards
-			Entity* par = getParent();
-			while (par != nullptr) {
-				par->hover();
-				par = par->getParent();
+				if (event.type == InputEvent::ENTER) {
+					entity->onHover();
+					for (Index i = 0; i < entity->components.size(); ++i) {
+						entity->components[i]->hover();
+					}
+				}
+
+				if (!event.bubbles) {
+					break;
+				}
+
+				entity = entity->getParent();
 			}
 		}
 
 		void Entity::clean() {
-			if (getProperty(Entity::DIRTY)) {
-				onClean();
-
-				metrics.transform = transformation;
-
-				metrics.inherited = TransformMatrix();
-				if (hasParent()) {
-					const Entity* par = getParent();
+			TransformHierarchy& hierarchy = *this->hierarchy;
 
-					const Metrics parentMetrics = par->getMetrics();
+			//held until every changed entity was told, so the main thread can't change the tree between the passes
+			const std::unique_lock<std::recursive_mutex> guard = hierarchy.lock();
 
-					metrics.inherited.translation += parentMetrics.transform.translation + parentMetrics.inherited.translation;
-					metrics.inherited.scaler *= parentMetrics.transform.scaler;
-					metrics.inherited.rotation += parentMetrics.transform.rotation;
+			//onClean() can move anything below it, so everything is cleaned before any transform is inherited
+			hierarchy.visitDirty(node, [this, &hierarchy](Entity* entity) {
+				//children that aren't initialized yet are cleaned once they are
+				if (entity != this && !entity->getProperty(Entity::INIT)) {
+					return;
 				}
 
-				metrics.transform.rotation += metrics.inherited.rotation;
+				entity->onClean();
 
-				for (Index i = 0; i < components.size(); ++i) {
+				entity->setProperty(Entity::DIRTY, false);
+				hierarchy.setLocal(entity->node, entity->transformation);
+			});
+
+			std::vector<Entity*> changed = std::vector<Entity*>();
+			hierarchy.update(node, [&changed](Entity* entity, Metrics& m) {
+				for (Index i = 0; i < entity->components.size(); ++i) {
 #ifdef MACE_DEBUG_CHECK_NULLPTR
-					if (components[i].get() == nullptr) {
+					if (entity->components[i].get() == nullptr) {
 						MACE__THROW(NullPointer, "One of the components in an entity was nullptr");
 					}
 #endif
 
-					components[i]->clean(metrics);
+					entity->components[i]->clean(m);
 				}
 
-				for (Size i = 0; i < children.size(); ++i) {
-					std::shared_ptr<Entity> child = children[i];
-					if (child == nullptr) {
-						removeChild(i--);//to account for the entity beng removed
-					} else if (child->getProperty(Entity::INIT)) {
-						child->setProperty(Entity::DIRTY, true);
-						child->clean();
-					}
-				}
+				changed.push_back(entity);
+			});
 
-				setProperty(Entity::DIRTY, false);
-			} else {
-				for (Size i = 0; i < children.size(); ++i) {
-					if (children[i]->getProperty(Entity::INIT)) {
-						if (children[i] != nullptr) {
-							children[i]->clean();
-						}
-					}
+			//the hierarchy only stores the metrics once the callback returns, so getMetrics() is up to date after the pass
+			for (Entity* entity : changed) {
+				if (entity->getProperty(Entity::INIT)) {
+					entity->onMetricsChanged();
 				}
 			}
 		}
@@ -247,8 +360,8 @@ namespace mc {
 			return par;
 		}
 
-		const Metrics& Entity::getMetrics() const {
-			return metrics;
+		Metrics Entity::getMetrics() const {
+			return hierarchy->getMetrics(node);
 		}
 
 		void Entity::reset() {
@@ -261,8 +374,11 @@ namespace mc {
 				}
 			}
 			components.clear();
+			updateWatched();
 			setParent(nullptr);
 			properties = Entity::DEFAULT_PROPERTIES;
+
+			hierarchy->setDirty(node, false);
 		}
 
 		void Entity::makeDirty() {
@@ -270,7 +386,19 @@ namespace mc {
 			if (!getProperty(Entity::DIRTY)) {
 				setProperty(Entity::DIRTY, true);
 
-				getRoot()->setProperty(Entity::DIRTY, true);
+				//stops at the first parent that was already passed, which means the root is already dirty
+				Entity* root = hierarchy->markPath(node);
+				if (root != nullptr) {
+					EntityCommandBuffer* const buffer = EntityCommandBuffer::getCurrent();
+					if (buffer != nullptr) MACE_UNLIKELY{
+						//other tasks can be making the same root dirty
+						buffer->push([root]() {
+							root->setProperty(Entity::DIRTY, true);
+						});
+					} else {
+						root->setProperty(Entity::DIRTY, true);
+					}
+				}
 			}
 		}
 
@@ -280,9 +408,157 @@ namespace mc {
 
 		void Entity::onHover() {}
 
+		void Entity::onInput(InputEvent&) {}
+
+		void Entity::onMetricsChanged() {}
+
+		void Entity::watchMetrics(const bool watch) {
+			metricsWatched = watch;
+
+			updateWatched();
+		}
+
+		void Entity::setChildrenIndependent(const bool independent) {
+			childrenIndependent = independent;
+		}
+
+		void Entity::updateWatched() {
+			hierarchy->setWatched(node, metricsWatched || !components.empty());
+		}
+
+		void Entity::useHierarchy(TransformHierarchy& newHierarchy) {
+			if (hierarchy == &newHierarchy) {
+				return;
+			}
+
+			hierarchy->moveTo(newHierarchy, node, TransformHierarchy::NONE, [&newHierarchy](Entity* entity, const TransformHierarchy::Node moved) {
+				entity->hierarchy = &newHierarchy;
+				entity->node = moved;
+			});
+		}
+
+		void Entity::linkParent(Entity* newParent) {
+			const TransformHierarchy::Node parentNode = newParent == nullptr ? TransformHierarchy::NONE : newParent->node;
+
+			//a root keeps its hierarchy, as it may have its own
+			TransformHierarchy* target = hierarchy;
+			if (newParent != nullptr) {
+				target = newParent->hierarchy;
+			} else if (parent != nullptr) {
+				target = &getTransformHierarchy();
+			}
+
+			if (target == hierarchy) {
+				hierarchy->setParent(node, parentNode);
+			} else {
+				hierarchy->moveTo(*target, node, parentNode, [target](Entity* entity, const TransformHierarchy::Node moved) {
+					entity->hierarchy = target;
+					entity->node = moved;
+				});
+			}
+		}
+
+		void Entity::updateChildren() {
+			EntityCommandBuffer* const buffer = EntityCommandBuffer::getCurrent();
+
+			//tasks don't start more tasks, as the other threads are already busy
+			std::vector<Entity*> tasks = std::vector<Entity*>();
+			if (buffer == nullptr) {
+				for (Index i = 0; i < children.size(); ++i) {
+					Entity* const child = children[i].get();
+					if (child != nullptr && !child->needsRemoval() && (childrenIndependent || child->getProperty(Entity::INDEPENDENT))) {
+						tasks.push_back(child);
+					}
+				}
+			}
+
+			const bool parallel = tasks.size() > 1;
+			if (parallel) {
+				std::vector<EntityCommandBuffer> buffers = std::vector<EntityCommandBuffer>(tasks.size());
+				std::vector<std::exception_ptr> errors = std::vector<std::exception_ptr>(tasks.size());
+
+				const std::function<void(Index, Index)> work = [&tasks, &buffers, &errors](const Index begin, const Index end) {
+					//a worker can pick up a task while waiting inside of another one, which has to get its buffer back
+					EntityCommandBuffer* const previous = EntityCommandBuffer::getCurrent();
+
+					for (Index i = begin; i < end; ++i) {
+						EntityCommandBuffer::setCurrent(&buffers[i]);
+						try {
+							tasks[i]->update();
+						} catch (...) {
+							errors[i] = std::current_exception();
+						}
+					}
+					EntityCommandBuffer::setCurrent(previous);
+				};
+
+				//without a JobSystem, like when there is no Instance, the tasks still get their own buffers
+				JobSystem* const jobs = JobSystem::getCurrent();
+				if (jobs != nullptr) {
+					jobs->parallelFor(0, tasks.size(), 1, work);
+				} else {
+					work(0, tasks.size());
+				}
+
+				//in the order of the children, so the result is the same no matter which task finished first
+				for (EntityCommandBuffer& commands : buffers) {
+					commands.apply();
+				}
+
+				for (const std::exception_ptr& error : errors) {
+					if (error != nullptr) {
+						std::rethrow_exception(error);
+					}
+				}
+			}
+
+			for (Index i = 0; i < children.size(); ++i) {
+				Entity* const child = children[i].get();
+				if (child == nullptr || child->needsRemoval()) {
+					if (buffer != nullptr) {
+						//removing it now would change the tree while other tasks are using it
+						if (child != nullptr) {
+							buffer->push([this, child]() {
+								removeDeadChild(child);
+							});
+						}
+					} else {
+						if (child != nullptr) {
+							child->kill();
+							child->childIndex = Index(-1);
+						}
+
+						//every dead child is removed at once below, so killing a lot of them is linear
+						children[i].reset();
+						childHoles = true;
+
+						makeDirty();
+					}
+					continue;
+				} else if (parallel && (childrenIndependent || child->getProperty(Entity::INDEPENDENT))) {
+					continue;
+				}
+				child->update();
+			}
+
+			if (buffer == nullptr) {
+				compactChildren();
+			}
+		}
+
+		void Entity::removeDeadChild(const Entity* child) {
+			const Index index = indexOf(*child);
+			if (index != Index(-1)) {
+				children[index]->kill();
+				removeChild(index);
+			}
+		}
+
 		void Entity::setParent(Entity * par) {
 			makeDirty();
 
+			linkParent(par);
+
 			this->parent = par;
 		}
 
@@ -319,10 +595,10 @@ namespace mc {
 		}
 
 		Index Entity::indexOf(const Entity & e) const {
-			for (Index i = 0; i < children.size(); ++i) {
-				if (children[i].get() == &e) {
-					return i;
-				}
+			const Index index = e.childIndex;
+			//the index is only for the parent that added it last
+			if (index < children.size() && children[index].get() == &e) {
+				return index;
 			}
 			return Index(-1);
 		}
@@ -355,19 +631,29 @@ namespace mc {
 			}
 #endif
 
+			EntityCommandBuffer* const buffer = EntityCommandBuffer::getCurrent();
+			if (buffer != nullptr) MACE_UNLIKELY{
+				buffer->push([this, e]() {
+					addChild(e);
+				});
+				return;
+			}
+
 			e->setParent(this);
 
 			if (getProperty(Entity::INIT) && !e->getProperty(Entity::INIT)) {
 				e->init();
 			}
 
+			e->childIndex = children.size();
 			children.push_back(e);
 
 			makeDirty();
 		}
 
 		void Entity::addChild(Entity * e) {
-			addChild(std::shared_ptr<Entity>(e, [](Entity*) {}));
+			//aliases an empty shared_ptr, so there is no control block to allocate or reference count
+			addChild(std::shared_ptr<Entity>(std::shared_ptr<Entity>(), e));
 		}
 
 		void Entity::addChild(Entity & e) {
@@ -379,7 +665,7 @@ namespace mc {
 		}
 
 		void Entity::addComponent(Component * com) {
-			addComponent(std::shared_ptr<Component>(com, [](Component*) {}));
+			addComponent(std::shared_ptr<Component>(std::shared_ptr<Component>(), com));
 		}
 
 		void Entity::addComponent(std::shared_ptr<Component> com) {
@@ -387,6 +673,7 @@ namespace mc {
 			components.back()->parent = this;
 			components.back()->init();
 
+			updateWatched();
 			makeDirty();
 		}
 
@@ -400,32 +687,23 @@ namespace mc {
 
 				//update the components of this entity
 				for (Index i = 0; i < components.size(); ++i) {
-					std::shared_ptr<Component> a = components.at(i);
+					Component* const a = components[i].get();
 #ifdef MACE_DEBUG_CHECK_NULLPTR
-					if (a.get() == nullptr) {
+					if (a == nullptr) {
 						MACE__THROW(NullPointer, "A component located at index " + std::to_string(i) + " was nullptr");
 					}
 #endif
 					if (a->update()) {
 						a->destroy();
 						components.erase(components.begin() + i--);//update the index after a removal, so we dont get an exception for accessing deleted memory
+
+						updateWatched();
 					}
 				}
 
 				onUpdate();
 
-				//call update() on children
-				for (Index i = 0; i < children.size(); ++i) {
-					std::shared_ptr<Entity> child = children[i];
-					if (child == nullptr || child->needsRemoval()) {
-						if (child != nullptr) {
-							child->kill();
-						}
-						removeChild(i--);//update the index after the removal of an element, dont want an error
-						continue;
-					}
-					child->update();
-				}
+				updateChildren();
 			}
 		}
 
@@ -436,13 +714,18 @@ namespace mc {
 
 			makeDirty();
 			for (Index i = 0; i < children.size(); ++i) {
-				std::shared_ptr<Entity> child = children[i];
+				Entity* const child = children[i].get();
 				if (child == nullptr || child->needsRemoval()) {
-					removeChild(i--);//update the index after the removal of an element
+					if (child != nullptr) {
+						child->childIndex = Index(-1);
+					}
+					children[i].reset();
+					childHoles = true;
 					continue;
 				}
 				child->init();
 			}
+			compactChildren();
 			onInit();
 			setProperty(Entity::INIT, true);
 		}
@@ -451,7 +734,7 @@ namespace mc {
 			if (getProperty(Entity::INIT)) {
 				setProperty(Entity::DEAD, true);
 				for (Index i = 0; i < children.size(); ++i) {
-					std::shared_ptr<Entity> child = children[i];
+					Entity* const child = children[i].get();
 					if (child != nullptr) {
 						child->destroy();
 					}
@@ -462,10 +745,49 @@ namespace mc {
 			reset();
 		}
 
-		Entity::Entity() noexcept {}
+		Entity::Entity() noexcept : hierarchy(&getTransformHierarchy()), node(hierarchy->create(this)) {}
+
+		Entity::Entity(const Entity & other) : Initializable(other), children(other.children), components(other.components), properties(other.properties),
+			parent(other.parent), transformation(other.transformation), hierarchy(parent == nullptr ? &getTransformHierarchy() : parent->hierarchy),
+			node(hierarchy->create(this)), metricsWatched(other.metricsWatched),
+			childrenIndependent(other.childrenIndependent), childOrder(other.childOrder), childHoles(other.childHoles) {
+			if (parent != nullptr) {
+				hierarchy->setParent(node, parent->node);
+			}
+
+			hierarchy->setLocal(node, transformation);
+			hierarchy->setDirty(node, getProperty(Entity::DIRTY));
+			updateWatched();
+		}
 
 		Entity::~Entity() noexcept {
 			children.clear();
+
+			hierarchy->destroy(node);
+		}
+
+		Entity& Entity::operator=(const Entity & other) {
+			if (this == &other) {
+				return *this;
+			}
+
+			linkParent(other.parent);
+
+			children = other.children;
+			components = other.components;
+			properties = other.properties;
+			parent = other.parent;
+			transformation = other.transformation;
+			metricsWatched = other.metricsWatched;
+			childrenIndependent = other.childrenIndependent;
+			childOrder = other.childOrder;
+			childHoles = other.childHoles;
+
+			hierarchy->setLocal(node, transformation);
+			hierarchy->setDirty(node, getProperty(Entity::DIRTY));
+			updateWatched();
+
+			return *this;
 		}
 
 
@@ -483,6 +805,8 @@ namespace mc {
 			if (b != properties) {
 				makeDirty();
 				properties = b;
+
+				hierarchy->setDirty(node, getProperty(Entity::DIRTY));
 			}
 		}
 
@@ -501,6 +825,9 @@ namespace mc {
 				} else {
 					properties &= ~(1 << position);
 				}
+
+				//clean() finds dirty entities through the hierarchy instead of walking the tree
+				hierarchy->setDirty(node, getProperty(Entity::DIRTY));
 			}
 		}
 
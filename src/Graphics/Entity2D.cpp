@@ -5,18 +5,46 @@ See LICENSE.md for full copyright information
 */
 #include <MACE/Graphics/Entity2D.h>
 #include <MACE/Core/System.h>
+#include <MACE/Utility/Unicode.h>
 
 #undef FT_CONFIG_OPTION_USE_HARFBUZZ
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_BITMAP_H
+#include FT_GZIP_H
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <clocale>
 
 #include <iostream>
 
+#ifndef MACE__TEXT_LAYOUT_CACHE_SIZE
+#	define MACE__TEXT_LAYOUT_CACHE_SIZE 512
+#endif
+
+//how many lines of a Text share a mesh
+#ifndef MACE__TEXT_BLOCK_LINES
+#	define MACE__TEXT_BLOCK_LINES 64
+#endif
+
 namespace mc {
 	namespace gfx {
 		namespace {
@@ -26,6 +54,147 @@ namespace mc {
 
 			std::vector<FT_Face> fonts = std::vector<FT_Face>();
 
+			//one atlas for each font id and size
+			std::map<std::pair<Index, unsigned int>, GlyphAtlas> atlases = std::map<std::pair<Index, unsigned int>, GlyphAtlas>();
+
+			//distance field glyphs are the same at every size, so there is one atlas for each font id
+			std::map<Index, GlyphAtlas> distanceFieldAtlases = std::map<Index, GlyphAtlas>();
+
+			std::unordered_map<std::size_t, std::shared_ptr<TextLayout>> layoutCache = std::unordered_map<std::size_t, std::shared_ptr<TextLayout>>();
+
+			std::size_t hashLayoutKey(const TextLayout::Key& key) {
+				std::size_t seed = std::hash<std::string>()(key.text);
+				hashCombine(seed, static_cast<std::size_t>(key.fontID));
+				hashCombine(seed, static_cast<std::size_t>(key.fontSize));
+				hashCombine(seed, static_cast<std::size_t>(key.dpi[0]));
+				hashCombine(seed, static_cast<std::size_t>(key.dpi[1]));
+				hashCombine(seed, static_cast<std::size_t>(key.windowSize[0]));
+				hashCombine(seed, static_cast<std::size_t>(key.windowSize[1]));
+				hashCombine(seed, static_cast<std::size_t>(key.distanceField));
+				return seed;
+			}
+
+			//compares everything but the text, which is slow to compare and is tracked by the Text instead
+			bool hasSameParameters(const TextLayout::Key& first, const TextLayout::Key& second) {
+				return first.fontID == second.fontID && first.fontSize == second.fontSize && first.dpi == second.dpi && first.windowSize == second.windowSize && first.distanceField == second.distanceField;
+			}
+
+			void updateLayoutSize(TextLayout& layout) {
+				const WindowModule* window = gfx::getCurrentWindow();
+
+				// it is >> 7 instead of >> 6 because we also want to divide the total of it in half (so shift an additional bit to the right)
+				layout.width = window->convertPixelsToRelativeXCoordinates(layout.maxLineWidth >> 7);
+				layout.height = layout.lineHeight * static_cast<float>(layout.lines.size()) * 0.5f;
+			}
+
+			inline bool isBreakingSpace(const char32_t c) {
+				//space, tab, zero width space, and ideographic space
+				return c == U' ' || c == U'\t' || c == 0x200B || c == 0x3000;
+			}
+
+			//CJK text has no spaces, so it can be wrapped between any two characters
+			inline bool isIdeograph(const char32_t c) {
+				return (c >= 0x2E80 && c <= 0x9FFF) || (c >= 0xAC00 && c <= 0xD7AF) || (c >= 0xF900 && c <= 0xFAFF) || (c >= 0x20000 && c <= 0x2FFFF);
+			}
+
+			/*
+			Felzenszwalb and Huttenlocher's linear time distance transform of one row or column.
+			f is the input and d gets the squared distances. v and z are scratch space with room for n and n + 1 elements
+			*/
+			void transformDistances(const float* f, float* d, int* v, float* z, const int n) {
+				int k = 0;
+				v[0] = 0;
+				z[0] = -std::numeric_limits<float>::infinity();
+				z[1] = std::numeric_limits<float>::infinity();
+
+				for (int q = 1; q < n; ++q) {
+					float intersection = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+					while (intersection <= z[k]) {
+						--k;
+						intersection = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+					}
+
+					++k;
+					v[k] = q;
+					z[k] = intersection;
+					z[k + 1] = std::numeric_limits<float>::infinity();
+				}
+
+				k = 0;
+				for (int q = 0; q < n; ++q) {
+					while (z[k + 1] < q) {
+						++k;
+					}
+
+					d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+				}
+			}
+
+			//replaces every element of grid, where 0 is a seed, with the squared distance to the closest seed
+			void transformDistances(std::vector<float>& grid, const int width, const int height) {
+				const int length = std::max(width, height);
+
+				std::vector<float> f = std::vector<float>(length), d = std::vector<float>(length), z = std::vector<float>(length + 1);
+				std::vector<int> v = std::vector<int>(length);
+
+				for (int x = 0; x < width; ++x) {
+					for (int y = 0; y < height; ++y) {
+						f[y] = grid[y * width + x];
+					}
+
+					transformDistances(f.data(), d.data(), v.data(), z.data(), height);
+
+					for (int y = 0; y < height; ++y) {
+						grid[y * width + x] = d[y];
+					}
+				}
+
+				for (int y = 0; y < height; ++y) {
+					transformDistances(&grid[y * width], d.data(), v.data(), z.data(), width);
+
+					std::copy(d.begin(), d.begin() + width, grid.begin() + y * width);
+				}
+			}
+
+			/*
+			Turns a grayscale glyph into a signed distance field that is MACE__DISTANCE_FIELD_SPREAD pixels bigger on every side.
+			0.5 (or 128) is the outline, and it goes up to 1 inside of the glyph and down to 0 outside of it.
+			*/
+			std::vector<Byte> createDistanceField(const FT_Bitmap& bitmap) {
+				const int spread = MACE__DISTANCE_FIELD_SPREAD;
+				const int width = static_cast<int>(bitmap.width) + spread * 2, height = static_cast<int>(bitmap.rows) + spread * 2;
+
+				const float infinity = static_cast<float>(width * width + height * height);
+
+				//distances from outside to the glyph, and from inside to the outside
+				std::vector<float> outside = std::vector<float>(static_cast<Size>(width) * height, infinity);
+				std::vector<float> inside = std::vector<float>(static_cast<Size>(width) * height, 0.0f);
+
+				const int pitch = std::abs(bitmap.pitch);
+				for (unsigned int y = 0; y < bitmap.rows; ++y) {
+					for (unsigned int x = 0; x < bitmap.width; ++x) {
+						if (bitmap.buffer[y * pitch + x] >= 128) {
+							const Size i = static_cast<Size>(y + spread) * width + (x + spread);
+							outside[i] = 0.0f;
+							inside[i] = infinity;
+						}
+					}
+				}
+
+				transformDistances(outside, width, height);
+				transformDistances(inside, width, height);
+
+				std::vector<Byte> out = std::vector<Byte>(static_cast<Size>(width) * height);
+				for (Size i = 0; i < out.size(); ++i) {
+					//the outline is halfway between the last pixel inside and the first pixel outside
+					const float distance = inside[i] > 0.0f ? std::sqrt(inside[i]) - 0.5f : 0.5f - std::sqrt(outside[i]);
+
+					out[i] = static_cast<Byte>(math::clamp(0.5f + distance / (spread * 2), 0.0f, 1.0f) * 255.0f + 0.5f);
+				}
+
+				return out;
+			}
+
 			Texture convertBitmapToTexture(const FT_Bitmap& bitmap) {
 				TextureDesc desc = TextureDesc(bitmap.width, bitmap.rows);
 				switch (bitmap.pixel_mode) {
@@ -102,6 +271,17 @@ namespace mc {
 				}
 			}
 
+			void loadGlyphMetrics(const FT_GlyphSlot glyph, GlyphMetrics& metrics) {
+				const FT_Glyph_Metrics& gMetrics = glyph->metrics;
+				const FT_Vector& advance = glyph->advance;
+				metrics.width = gMetrics.width;
+				metrics.height = gMetrics.height;
+				metrics.bearingX = gMetrics.horiBearingX;
+				metrics.bearingY = gMetrics.horiBearingY;
+				metrics.advanceX = advance.x;
+				metrics.advanceY = advance.y;
+			}
+
 			void ensureFreetypeInit() {
 				if (freetypeStatus < 0) {
 					checkFreetypeError(freetypeStatus = FT_Init_FreeType(&freetype), "Failed to initialize FreeType");
@@ -110,6 +290,365 @@ namespace mc {
 					fonts.resize(2);
 				}
 			}
+
+			/*
+			A glyph that was loaded and rasterized, but not added to an atlas yet. The bitmap and FreeType calls are
+			the slow part, so this can be done on another thread
+			*/
+			struct RasterizedGlyph {
+				GlyphMetrics metrics{};
+				std::vector<Byte> pixels{};
+				unsigned int width = 0, height = 0, pitch = 0;
+			};
+
+			//the face must already be the right size
+			void rasterizeGlyph(FT_Library library, FT_Face face, const char32_t c, RasterizedGlyph& out) {
+				checkFreetypeError(FT_Load_Char(face, c, FT_LOAD_RENDER | FT_LOAD_PEDANTIC | FT_LOAD_TARGET_LCD), "Failed to load glyph");
+
+				const FT_GlyphSlot glyph = face->glyph;
+				loadGlyphMetrics(glyph, out.metrics);
+
+				if (out.metrics.width == 0 || out.metrics.height == 0) {
+					return;
+				}
+
+				FT_Bitmap targetBitmap;
+				FT_Bitmap_New(&targetBitmap);
+
+				checkFreetypeError(FT_Bitmap_Convert(library, &glyph->bitmap, &targetBitmap, 1), "Failed to convert bitmaps");
+
+				//the LCD bitmap has a sample for each subpixel, which become the RGB channels
+				out.width = targetBitmap.width / 3;
+				out.height = targetBitmap.rows;
+				out.pitch = static_cast<unsigned int>(targetBitmap.pitch);
+				out.pixels.assign(targetBitmap.buffer, targetBitmap.buffer + static_cast<Size>(out.pitch) * out.height);
+
+				checkFreetypeError(FT_Bitmap_Done(library, &targetBitmap), "Failed to delete bitmap");
+			}
+
+			//the face must already be MACE__DISTANCE_FIELD_GLYPH_SIZE
+			void rasterizeDistanceFieldGlyph(FT_Face face, const char32_t c, RasterizedGlyph& out) {
+				checkFreetypeError(FT_Load_Char(face, c, FT_LOAD_RENDER), "Failed to load glyph");
+
+				const FT_GlyphSlot glyph = face->glyph;
+				loadGlyphMetrics(glyph, out.metrics);
+
+				if (out.metrics.width == 0 || out.metrics.height == 0 || glyph->bitmap.width == 0 || glyph->bitmap.rows == 0) {
+					return;
+				}
+
+				out.pixels = createDistanceField(glyph->bitmap);
+				out.width = glyph->bitmap.width + MACE__DISTANCE_FIELD_SPREAD * 2;
+				out.height = glyph->bitmap.rows + MACE__DISTANCE_FIELD_SPREAD * 2;
+				out.pitch = out.width;
+			}
+
+			//the memory a face was loaded from, so the rasterizer thread can open its own copy and it can be released later
+			struct FontSource {
+				const unsigned char* data = nullptr;
+				unsigned long size = 0;
+				//only set for files, which are memory mapped
+				std::string path{};
+				//only set for embedded fonts, which own their decompressed data
+				std::unique_ptr<Byte[]> buffer{};
+				//every load of a shared face holds a reference, and Font::destroy() only destroys it once they are all released
+				Size references = 0;
+			};
+
+			//one for every face in fonts
+			std::vector<FontSource> fontSources = std::vector<FontSource>();
+
+			//faces that were already loaded by path or by the hash of their data, so loading the same font twice shares one face
+			std::unordered_map<std::string, Index> fontPaths = std::unordered_map<std::string, Index>();
+			std::unordered_multimap<std::size_t, Index> fontHashes = std::unordered_multimap<std::size_t, Index>();
+
+			struct GlyphJob {
+				//the data of the face, which outlives the job since Font::destroy() waits for it
+				const unsigned char* data = nullptr;
+				unsigned long dataSize = 0;
+				Index fontID = 0;
+				//ignored for distance field glyphs, which are always the same size
+				unsigned int fontSize = 0;
+				Vector<int, 2> dpi = {0, 0};
+				unsigned int code = 0;
+				bool distanceField = false;
+			};
+
+			struct FinishedGlyph {
+				GlyphJob job{};
+				RasterizedGlyph glyph{};
+			};
+
+			/*
+			Rasterizes glyphs on a background thread with its own FreeType library and faces, since FreeType objects
+			can't be shared between threads. Jobs are queued and collected on the rendering thread, which is the only
+			thread that touches a GlyphAtlas.
+			*/
+			class GlyphRasterizer {
+			public:
+				~GlyphRasterizer() {
+					{
+						const std::unique_lock<std::mutex> guard(jobMutex);
+						stopping = true;
+					}
+					jobCondition.notify_one();
+
+					if (thread.joinable()) {
+						thread.join();
+					}
+				}
+
+				void queue(const GlyphJob& job) {
+					//a glyph that is already on its way shouldn't be rasterized twice
+					if (!queued.insert(getKey(job)).second) {
+						return;
+					}
+
+					{
+						const std::unique_lock<std::mutex> guard(jobMutex);
+						jobs.push_back(job);
+
+						if (!thread.joinable()) {
+							thread = std::thread(&GlyphRasterizer::run, this);
+						}
+					}
+					jobCondition.notify_one();
+				}
+
+				void collect(std::vector<FinishedGlyph>& out) {
+					if (!hasFinished.load()) {
+						return;
+					}
+
+					{
+						const std::unique_lock<std::mutex> guard(finishedMutex);
+						out.swap(finished);
+						hasFinished = false;
+					}
+
+					for (const FinishedGlyph& glyph : out) {
+						queued.erase(getKey(glyph.job));
+					}
+				}
+
+				bool isQueued(const GlyphJob& job) const {
+					return queued.find(getKey(job)) != queued.end();
+				}
+
+				Size getPendingCount() const {
+					return queued.size();
+				}
+
+				//drops every job for a face and closes the copy of it, so its memory can be freed
+				void forget(const Index fontID) {
+					{
+						const std::unique_lock<std::mutex> guard(jobMutex);
+						jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [fontID](const GlyphJob& job) {
+							return job.fontID == fontID;
+						}), jobs.end());
+					}
+
+					//waits for the glyph being rasterized right now. run() pops jobs while holding this, so none of them can still be for this face afterwards
+					const std::unique_lock<std::mutex> guard(faceMutex);
+
+					const auto face = faces.find(fontID);
+					if (face != faces.end()) {
+						FT_Done_Face(face->second);
+						faces.erase(face);
+					}
+
+					for (auto iter = queued.begin(); iter != queued.end();) {
+						if (std::get<0>(*iter) == fontID) {
+							iter = queued.erase(iter);
+						} else {
+							++iter;
+						}
+					}
+				}
+			private:
+				using JobKey = std::tuple<Index, unsigned int, unsigned int, bool>;
+
+				std::thread thread{};
+
+				std::mutex jobMutex{};
+				std::condition_variable jobCondition{};
+				std::deque<GlyphJob> jobs{};
+				bool stopping = false;
+
+				std::mutex finishedMutex{};
+				std::vector<FinishedGlyph> finished{};
+				std::atomic<bool> hasFinished{false};
+
+				//only used by the rendering thread
+				std::set<JobKey> queued{};
+
+				//only used by the rasterizer thread while it holds faceMutex
+				std::mutex faceMutex{};
+				FT_Library library = nullptr;
+				std::map<Index, FT_Face> faces{};
+
+				static JobKey getKey(const GlyphJob& job) {
+					return std::make_tuple(job.fontID, job.distanceField ? 0 : job.fontSize, job.code, job.distanceField);
+				}
+
+				FT_Face getFace(const GlyphJob& job) {
+					const auto result = faces.find(job.fontID);
+					if (result != faces.end()) {
+						return result->second;
+					}
+
+					FT_Face face;
+					checkFreetypeError(FT_New_Memory_Face(library, job.data, static_cast<FT_Long>(job.dataSize), 0, &face), "Failed to create font from memory");
+
+					checkFreetypeError(FT_Select_Charmap(face, FT_ENCODING_UNICODE), "Failed to change charmap from font");
+
+					return faces[job.fontID] = face;
+				}
+
+				void run() {
+					const bool initialized = FT_Init_FreeType(&library) == FT_Err_Ok;
+
+					while (true) {
+						{
+							std::unique_lock<std::mutex> guard(jobMutex);
+							jobCondition.wait(guard, [this]() {
+								return stopping || !jobs.empty();
+							});
+
+							if (stopping) {
+								break;
+							}
+						}
+
+						/*
+						the job is popped while holding faceMutex, so forget() either removes it from the queue first,
+						or waits for it to finish before the memory of its face is released. faceMutex can't be held
+						while waiting above, or forget() would block until another glyph is queued
+						*/
+						const std::unique_lock<std::mutex> faceGuard(faceMutex);
+
+						GlyphJob job;
+						{
+							const std::unique_lock<std::mutex> guard(jobMutex);
+							if (jobs.empty()) {
+								//forget() took it in the meantime
+								continue;
+							}
+
+							job = jobs.front();
+							jobs.pop_front();
+						}
+
+						FinishedGlyph out = FinishedGlyph();
+						out.job = job;
+
+						if (initialized) {
+							//a glyph that fails is left without pixels instead of taking down the thread
+							try {
+								FT_Face face = getFace(job);
+
+								if (job.distanceField) {
+									checkFreetypeError(FT_Set_Char_Size(face, 0, MACE__DISTANCE_FIELD_GLYPH_SIZE << 6, 72, 72), "Failed to change char size");
+									rasterizeDistanceFieldGlyph(face, static_cast<char32_t>(job.code), out.glyph);
+								} else {
+									checkFreetypeError(FT_Set_Char_Size(face, 0, job.fontSize << 6, job.dpi[0], job.dpi[1]), "Failed to change char size");
+									rasterizeGlyph(library, face, static_cast<char32_t>(job.code), out.glyph);
+								}
+							} catch (const std::exception&) {
+								out.glyph = RasterizedGlyph();
+							}
+						}
+
+						{
+							const std::unique_lock<std::mutex> guard(finishedMutex);
+							finished.push_back(std::move(out));
+							hasFinished = true;
+						}
+					}
+
+					const std::unique_lock<std::mutex> guard(faceMutex);
+					for (auto& face : faces) {
+						FT_Done_Face(face.second);
+					}
+					faces.clear();
+
+					if (initialized) {
+						FT_Done_FreeType(library);
+					}
+				}
+			};//GlyphRasterizer
+
+			GlyphRasterizer rasterizer;
+
+			Index createFace(const unsigned char* data, const unsigned long size, const std::string& message) {
+				const Index id = static_cast<Index>(fonts.size());
+
+				fonts.push_back(FT_Face());
+				fontSources.resize(fonts.size());
+
+				const FT_Error status = FT_New_Memory_Face(freetype, data, static_cast<FT_Long>(size), 0, &fonts[id]);
+				if (status != FT_Err_Ok) {
+					fonts.pop_back();
+					fontSources.pop_back();
+
+					throwFreetypeError(status, message);
+				}
+
+				checkFreetypeError(FT_Select_Charmap(fonts[id], FT_ENCODING_UNICODE), "Failed to change charmap from font");
+
+				fontSources[id].data = data;
+				fontSources[id].size = size;
+				fontSources[id].references = 1;
+
+				return id;
+			}
+
+			//FNV-1a
+			std::size_t hashFontData(const unsigned char* data, const unsigned long size) {
+				std::uint64_t hash = 14695981039346656037ULL;
+				for (unsigned long i = 0; i < size; ++i) {
+					hash ^= data[i];
+					hash *= 1099511628211ULL;
+				}
+
+				return static_cast<std::size_t>(hash);
+			}
+
+			void* allocateFreetypeMemory(FT_Memory, long size) {
+				return std::malloc(static_cast<std::size_t>(size));
+			}
+
+			void freeFreetypeMemory(FT_Memory, void* block) {
+				std::free(block);
+			}
+
+			void* reallocateFreetypeMemory(FT_Memory, long, long newSize, void* block) {
+				return std::realloc(block, static_cast<std::size_t>(newSize));
+			}
+
+			//FT_Gzip_Uncompress() needs an allocator, but the one in the library isn't public
+			FT_MemoryRec_ decompressionMemory = {nullptr, &allocateFreetypeMemory, &freeFreetypeMemory, &reallocateFreetypeMemory};
+
+			//embedded fonts are compressed, and are only decompressed the first time they are used or after they were destroyed
+			Index loadEmbeddedFont(Index& loaded, const unsigned char* data, const unsigned int length, const unsigned int uncompressedLength) {
+				if (loaded != 0 && fonts[loaded] != nullptr) {
+					++fontSources[loaded].references;
+					return loaded;
+				}
+
+				ensureFreetypeInit();
+
+				std::unique_ptr<Byte[]> buffer = std::unique_ptr<Byte[]>(new Byte[uncompressedLength]);
+
+				FT_ULong outputLength = uncompressedLength;
+				checkFreetypeError(FT_Gzip_Uncompress(&decompressionMemory, buffer.get(), &outputLength, data, length), "Failed to decompress embedded font");
+
+				const Index id = createFace(buffer.get(), outputLength, "Failed to create embedded font");
+				fontSources[id].buffer = std::move(buffer);
+
+				loaded = id;
+				return id;
+			}
 		}//anon namespace
 
 		Entity2D::Entity2D() : GraphicsEntity() {}
@@ -165,17 +704,36 @@ namespace mc {
 
 		void Selectable::onTrigger() {}
 
-		void Selectable::doHover() {
-			if (!isDisabled()) {
-				if (gfx::Input::isKeyDown(gfx::Input::MOUSE_LEFT)) {
+		void Selectable::handleInput(const InputEvent& event) {
+			switch (event.type) {
+			case InputEvent::ENTER:
+				selectableProperties |= Selectable::HOVERED;
+				break;
+			case InputEvent::LEAVE:
+				//releasing the mouse somewhere else doesn't trigger it
+				selectableProperties &= ~(Selectable::HOVERED | Selectable::CLICKED);
+				break;
+			case InputEvent::PRESS:
+				if (event.button == gfx::Input::MOUSE_LEFT && !isDisabled()) {
 					click();
 				}
-
-				if (gfx::Input::isKeyReleased(gfx::Input::MOUSE_LEFT) && isClicked()) {
+				break;
+			case InputEvent::RELEASE:
+				if (event.button == gfx::Input::MOUSE_LEFT && isClicked()) {
 					selectableProperties &= ~Selectable::CLICKED;
 
-					trigger();
+					if (!isDisabled()) {
+						trigger();
+					}
+				}
+				break;
+			case InputEvent::MOVE:
+				if (isClicked() && !isDisabled()) {
+					onClick();
 				}
+				break;
+			default:
+				break;
 			}
 		}
 
@@ -404,8 +962,8 @@ namespace mc {
 			}
 		}
 
-		void Slider::onHover() {
-			doHover();
+		void Slider::onInput(InputEvent& event) {
+			handleInput(event);
 		}
 
 		Font Font::loadFont(const std::string & name, unsigned int size) {
@@ -415,13 +973,25 @@ namespace mc {
 		Font Font::loadFont(const char* name, unsigned int size) {
 			ensureFreetypeInit();
 
-			//on 64 bit systems this cast is required
-			Index id = static_cast<Index>(fonts.size());
+			const auto existing = fontPaths.find(name);
+			if (existing != fontPaths.end()) {
+				++fontSources[existing->second].references;
+				return Font(existing->second, size);
+			}
+
+			Size dataSize = 0;
+			const Byte* data = os::mapFile(name, &dataSize);
 
-			fonts.push_back(FT_Face());
-			checkFreetypeError(FT_New_Face(freetype, name, 0, &fonts[id]), "Failed to create font");
+			Index id;
+			try {
+				id = createFace(data, static_cast<unsigned long>(dataSize), "Failed to create font");
+			} catch (...) {
+				os::unmapFile(data, dataSize);
+				throw;
+			}
 
-			checkFreetypeError(FT_Select_Charmap(fonts[id], FT_ENCODING_UNICODE), "Failed to change charmap from font");
+			fontSources[id].path = name;
+			fontPaths[name] = id;
 
 			return Font(id, size);
 		}
@@ -435,20 +1005,66 @@ namespace mc {
 
 			ensureFreetypeInit();
 
-			//on 64 bit systems this cast is required
-			Index id = static_cast<Index>(fonts.size());
-
-			fonts.push_back(FT_Face());
+			const std::size_t hash = hashFontData(data, size);
 
-			checkFreetypeError(FT_New_Memory_Face(freetype, data, size, 0, &fonts[id]), "Failed to create font from memory");
+			const auto existing = fontHashes.equal_range(hash);
+			for (auto iter = existing.first; iter != existing.second; ++iter) {
+				const FontSource& source = fontSources[iter->second];
+				if (source.size == size && (source.data == data || std::memcmp(source.data, data, size) == 0)) {
+					++fontSources[iter->second].references;
+					return Font(iter->second, fontSize);
+				}
+			}
 
-			checkFreetypeError(FT_Select_Charmap(fonts[id], FT_ENCODING_UNICODE), "Failed to change charmap from font");
+			const Index id = createFace(data, size, "Failed to create font from memory");
+			fontHashes.emplace(hash, id);
 
 			return Font(id, fontSize);
 		}
 
 		void Font::destroy() {
+			//another load of the same face is still using it
+			if (fontSources[id].references > 1) {
+				--fontSources[id].references;
+				return;
+			}
+
+			rasterizer.forget(id);
+
+			for (auto iter = atlases.begin(); iter != atlases.end();) {
+				if (iter->first.first == id) {
+					iter->second.destroy();
+					iter = atlases.erase(iter);
+				} else {
+					++iter;
+				}
+			}
+
+			const auto distanceFieldAtlas = distanceFieldAtlases.find(id);
+			if (distanceFieldAtlas != distanceFieldAtlases.end()) {
+				distanceFieldAtlas->second.destroy();
+				distanceFieldAtlases.erase(distanceFieldAtlas);
+			}
+
 			checkFreetypeError(FT_Done_Face(fonts[id]), "Failed to delete font");
+			fonts[id] = nullptr;
+
+			FontSource& source = fontSources[id];
+			if (!source.path.empty()) {
+				fontPaths.erase(source.path);
+
+				os::unmapFile(source.data, source.size);
+			}
+
+			for (auto iter = fontHashes.begin(); iter != fontHashes.end(); ++iter) {
+				if (iter->second == id) {
+					fontHashes.erase(iter);
+					break;
+				}
+			}
+
+			//releases the decompressed data of embedded fonts
+			source = FontSource();
 		}
 
 		bool Font::hasKerning() const {
@@ -467,20 +1083,13 @@ namespace mc {
 			return id;
 		}
 
-		void Font::getCharacter(const wchar_t c, std::shared_ptr<Letter> character) const {
+		void Font::getCharacter(const char32_t c, std::shared_ptr<Letter> character) const {
 			checkFreetypeError(FT_Load_Char(fonts[id], c, FT_LOAD_RENDER | FT_LOAD_PEDANTIC | FT_LOAD_TARGET_LCD), "Failed to load glyph");
 
 			GlyphMetrics & metrics = character->glyphMetrics;
 
 			const FT_GlyphSlot glyph = fonts[id]->glyph;
-			const FT_Glyph_Metrics& gMetrics = glyph->metrics;
-			const FT_Vector& advance = glyph->advance;
-			metrics.width = gMetrics.width;
-			metrics.height = gMetrics.height;
-			metrics.bearingX = gMetrics.horiBearingY;
-			metrics.bearingY = gMetrics.horiBearingY;
-			metrics.advanceX = advance.x;
-			metrics.advanceY = advance.y;
+			loadGlyphMetrics(glyph, metrics);
 
 			if (metrics.width == 0 || metrics.height == 0) {
 				character->glyph = Colors::BLACK;
@@ -504,11 +1113,166 @@ namespace mc {
 			}
 		}
 
+		const Glyph& Font::getGlyph(const char32_t c) const {
+			GlyphAtlas& atlas = getAtlas();
+
+			const unsigned int code = static_cast<unsigned int>(c);
+
+			const Glyph* cached = atlas.getGlyph(code);
+			//a glyph that is still being rasterized in the background has no pixels yet, so it is rasterized here instead
+			if (cached != nullptr && (cached->width != 0 || !isQueued(code, false))) {
+				return *cached;
+			}
+
+			RasterizedGlyph glyph = RasterizedGlyph();
+			rasterizeGlyph(freetype, fonts[id], c, glyph);
+
+			return atlas.addGlyph(code, glyph.metrics, glyph.pixels.data(), glyph.width, glyph.height, glyph.pitch);
+		}
+
+		bool Font::hasCharacter(const char32_t c) const {
+			return FT_Get_Char_Index(fonts[id], c) != 0;
+		}
+
+		const Glyph& Font::requestGlyph(const char32_t c) const {
+			GlyphAtlas& atlas = getAtlas();
+
+			const unsigned int code = static_cast<unsigned int>(c);
+
+			const Glyph* cached = atlas.getGlyph(code);
+			if (cached != nullptr) {
+				return *cached;
+			}
+
+			//a layout only needs the metrics, which are much faster to load than the bitmap
+			checkFreetypeError(FT_Load_Char(fonts[id], c, FT_LOAD_PEDANTIC | FT_LOAD_TARGET_LCD), "Failed to load glyph");
+
+			GlyphMetrics metrics{};
+			loadGlyphMetrics(fonts[id]->glyph, metrics);
+
+			if (metrics.width != 0 && metrics.height != 0) {
+				queueGlyph(code, false);
+			}
+
+			return atlas.addGlyph(code, metrics, nullptr, 0, 0, 0);
+		}
+
+		void Font::prepareGlyphs(const char32_t first, const char32_t last) const {
+			const GlyphAtlas& atlas = getAtlas();
+
+			for (unsigned int code = static_cast<unsigned int>(first); code <= static_cast<unsigned int>(last); ++code) {
+				if (atlas.getGlyph(code) == nullptr) {
+					queueGlyph(code, false);
+				}
+			}
+		}
+
+		GlyphAtlas& Font::getAtlas() const {
+			return atlases[std::make_pair(id, height)];
+		}
+
+		const Glyph& Font::getDistanceFieldGlyph(const char32_t c) const {
+			GlyphAtlas& atlas = getDistanceFieldAtlas();
+
+			const unsigned int code = static_cast<unsigned int>(c);
+
+			const Glyph* cached = atlas.getGlyph(code);
+			if (cached != nullptr && (cached->width != 0 || !isQueued(code, true))) {
+				return *cached;
+			}
+
+			calculateDistanceFieldMetrics();
+
+			RasterizedGlyph glyph = RasterizedGlyph();
+			rasterizeDistanceFieldGlyph(fonts[id], c, glyph);
+
+			return atlas.addGlyph(code, glyph.metrics, glyph.pixels.data(), glyph.width, glyph.height, glyph.pitch);
+		}
+
+		const Glyph& Font::requestDistanceFieldGlyph(const char32_t c) const {
+			GlyphAtlas& atlas = getDistanceFieldAtlas();
+
+			const unsigned int code = static_cast<unsigned int>(c);
+
+			const Glyph* cached = atlas.getGlyph(code);
+			if (cached != nullptr) {
+				return *cached;
+			}
+
+			calculateDistanceFieldMetrics();
+
+			checkFreetypeError(FT_Load_Char(fonts[id], c, FT_LOAD_DEFAULT), "Failed to load glyph");
+
+			GlyphMetrics metrics{};
+			loadGlyphMetrics(fonts[id]->glyph, metrics);
+
+			if (metrics.width != 0 && metrics.height != 0) {
+				queueGlyph(code, true);
+			}
+
+			return atlas.addGlyph(code, metrics, nullptr, 0, 0, 0);
+		}
+
+		void Font::prepareDistanceFieldGlyphs(const char32_t first, const char32_t last) const {
+			const GlyphAtlas& atlas = getDistanceFieldAtlas();
+
+			for (unsigned int code = static_cast<unsigned int>(first); code <= static_cast<unsigned int>(last); ++code) {
+				if (atlas.getGlyph(code) == nullptr) {
+					queueGlyph(code, true);
+				}
+			}
+		}
+
+		void Font::updateGlyphs() {
+			std::vector<FinishedGlyph> finished = std::vector<FinishedGlyph>();
+			rasterizer.collect(finished);
+
+			for (const FinishedGlyph& result : finished) {
+				const GlyphJob& job = result.job;
+
+				GlyphAtlas* atlas = nullptr;
+				if (job.distanceField) {
+					const auto found = distanceFieldAtlases.find(job.fontID);
+					atlas = found == distanceFieldAtlases.end() ? nullptr : &found->second;
+				} else {
+					const auto found = atlases.find(std::make_pair(job.fontID, job.fontSize));
+					atlas = found == atlases.end() ? nullptr : &found->second;
+				}
+
+				if (atlas == nullptr) {
+					//the font was destroyed while the glyph was being rasterized
+					continue;
+				}
+
+				const Glyph* existing = atlas->getGlyph(job.code);
+				if (existing != nullptr && existing->width != 0) {
+					//it was already rasterized on this thread in the meantime
+					continue;
+				}
+
+				const RasterizedGlyph& glyph = result.glyph;
+				atlas->addGlyph(job.code, glyph.metrics, glyph.pixels.data(), glyph.width, glyph.height, glyph.pitch);
+			}
+		}
+
+		Size Font::getPendingGlyphCount() {
+			return rasterizer.getPendingCount();
+		}
+
+		GlyphAtlas& Font::getDistanceFieldAtlas() const {
+			const auto result = distanceFieldAtlases.find(id);
+			if (result != distanceFieldAtlases.end()) {
+				return result->second;
+			}
+
+			return distanceFieldAtlases.emplace(id, GlyphAtlas(MACE__GLYPH_ATLAS_WIDTH, 1)).first->second;
+		}
+
 		signed long Font::getHeight() const {
 			return fonts[id]->size->metrics.height;
 		}
 
-		Vector<signed long, 2> Font::getKerning(const wchar_t prev, const wchar_t current) const {
+		Vector<signed long, 2> Font::getKerning(const char32_t prev, const char32_t current) const {
 			FT_Vector vec;
 
 			checkFreetypeError(FT_Get_Kerning(fonts[id], prev, current, FT_KERNING_DEFAULT, &vec), "Failed to get kerning from font");
@@ -528,6 +1292,37 @@ namespace mc {
 			checkFreetypeError(FT_Set_Char_Size(fonts[id], 0, height << 6, dpi[0], dpi[1]), "Failed to change char size");
 		}
 
+		bool Font::isQueued(const unsigned int code, const bool distanceField) const {
+			GlyphJob job = GlyphJob();
+			job.fontID = id;
+			job.fontSize = height;
+			job.code = code;
+			job.distanceField = distanceField;
+
+			return rasterizer.isQueued(job);
+		}
+
+		void Font::queueGlyph(const unsigned int code, const bool distanceField) const {
+			GlyphJob job = GlyphJob();
+			job.data = fontSources[id].data;
+			job.dataSize = fontSources[id].size;
+			job.fontID = id;
+			job.fontSize = height;
+			job.code = code;
+			job.distanceField = distanceField;
+
+			if (!distanceField) {
+				job.dpi = getCurrentWindow()->getMonitor().getDPI();
+			}
+
+			rasterizer.queue(job);
+		}
+
+		void Font::calculateDistanceFieldMetrics() const {
+			//at 72 DPI, points and pixels are the same
+			checkFreetypeError(FT_Set_Char_Size(fonts[id], 0, MACE__DISTANCE_FIELD_GLYPH_SIZE << 6, 72, 72), "Failed to change char size");
+		}
+
 		bool Font::operator==(const Font & other) const {
 			return id == other.id && height == other.height;
 		}
@@ -539,39 +1334,30 @@ namespace mc {
 		Font::Font(const Index fontID, const unsigned int h) : id(fontID), height(h) {}
 
 		//font data, compiled in another file to increase compilation time
-		extern unsigned char sourceCodeProData[];
-		extern unsigned int sourceCodeProLength;
+		extern const unsigned char sourceCodeProData[];
+		extern const unsigned int sourceCodeProLength;
+		extern const unsigned int sourceCodeProUncompressedLength;
 
-		extern unsigned char sourceSansProData[];
-		extern unsigned int sourceSansProLength;
+		extern const unsigned char sourceSansProData[];
+		extern const unsigned int sourceSansProLength;
+		extern const unsigned int sourceSansProUncompressedLength;
 
-		extern unsigned char sourceSerifProData[];
-		extern unsigned int sourceSerifProLength;
+		extern const unsigned char sourceSerifProData[];
+		extern const unsigned int sourceSerifProLength;
+		extern const unsigned int sourceSerifProUncompressedLength;
 
 		Font::Font(const Fonts f, const unsigned int h) : Font(0, h) {
-			static Font sourceCodePro, sourceSerifPro, sourceSansPro;
+			static Index sourceCodePro = 0, sourceSerifPro = 0, sourceSansPro = 0;
 
 			switch (f) {
 			case Fonts::CODE:
-				if (sourceCodePro.getID() == 0) {
-					sourceCodePro = Font::loadFontFromMemory(sourceCodeProData, sourceCodeProLength);
-				}
-
-				id = sourceCodePro.getID();
+				id = loadEmbeddedFont(sourceCodePro, sourceCodeProData, sourceCodeProLength, sourceCodeProUncompressedLength);
 				break;
 			case Fonts::SANS:
-				if (sourceSansPro.getID() == 0) {
-					sourceSansPro = Font::loadFontFromMemory(sourceSansProData, sourceSansProLength);
-				}
-
-				id = sourceSansPro.getID();
+				id = loadEmbeddedFont(sourceSansPro, sourceSansProData, sourceSansProLength, sourceSansProUncompressedLength);
 				break;
 			case Fonts::SERIF:
-				if (sourceSerifPro.getID() == 0) {
-					sourceSerifPro = Font::loadFontFromMemory(sourceSerifProData, sourceSerifProLength);
-				}
-
-				id = sourceSerifPro.getID();
+				id = loadEmbeddedFont(sourceSerifPro, sourceSerifProData, sourceSerifProLength, sourceSerifProUncompressedLength);
 				break;
 				default MACE_UNLIKELY:
 				//should never be reached, but just to be safe
@@ -581,6 +1367,156 @@ namespace mc {
 
 		Font::Font(const Font & f) : Font(f.id, f.height) {}
 
+		GlyphAtlas::GlyphAtlas(const unsigned int w, const unsigned int c) : pixels(static_cast<Size>(w) * (w >> 2) * c, 0), width(w), height(w >> 2), channels(c), dirtyTop(height), dirtyBottom(0) {
+#ifdef MACE_DEBUG_CHECK_ARGS
+			if (channels != 1 && channels != 3) {
+				MACE__THROW(OutOfBounds, "A GlyphAtlas must have 1 or 3 channels");
+			}
+#endif
+		}
+
+		const Glyph* GlyphAtlas::getGlyph(const unsigned int code) const {
+			const auto result = glyphs.find(code);
+			if (result == glyphs.end()) {
+				return nullptr;
+			}
+
+			return &result->second;
+		}
+
+		const Glyph& GlyphAtlas::addGlyph(const unsigned int code, const GlyphMetrics& metrics, const Byte* data, const unsigned int w, const unsigned int h, const unsigned int pitch) {
+			if (glyphs.find(code) != glyphs.end()) {
+				//anything built with the old glyph has to be rebuilt
+				++generation;
+			}
+
+			Glyph glyph = Glyph();
+			glyph.metrics = metrics;
+
+			if (w > 0 && h > 0) {
+#ifdef MACE_DEBUG_CHECK_NULLPTR
+				if (data == nullptr) {
+					MACE__THROW(NullPointer, "Pixels for a glyph with a size can not be nullptr");
+				}
+#endif
+
+				//an empty pixel between glyphs keeps linear filtering from bleeding them together
+				const unsigned int paddedWidth = w + 1, paddedHeight = h + 1;
+				if (paddedWidth > width) {
+					MACE__THROW(OutOfBounds, "Glyph is " + std::to_string(w) + " pixels wide, which does not fit in a GlyphAtlas that is " + std::to_string(width) + " pixels wide");
+				}
+
+				if (penX + paddedWidth > width) {
+					penX = 0;
+					penY += rowHeight;
+					rowHeight = 0;
+				}
+
+				while (penY + paddedHeight > height) {
+					//rows are the full width of the atlas, so existing pixels don't move when it gets taller
+					height <<= 1;
+					pixels.resize(static_cast<Size>(width) * height * channels, 0);
+					++generation;
+				}
+
+				glyph.x = penX;
+				glyph.y = penY;
+				glyph.width = w;
+				glyph.height = h;
+
+				for (unsigned int row = 0; row < h; ++row) {
+					std::memcpy(&pixels[(static_cast<Size>(penY + row) * width + penX) * channels], data + static_cast<Size>(row) * pitch, static_cast<Size>(w) * channels);
+				}
+
+				penX += paddedWidth;
+				rowHeight = std::max(rowHeight, paddedHeight);
+
+				dirtyTop = std::min(dirtyTop, glyph.y);
+				dirtyBottom = std::max(dirtyBottom, glyph.y + h);
+			}
+
+			return glyphs[code] = glyph;
+		}
+
+		Texture& GlyphAtlas::getTexture() {
+			if (!texture.isCreated() || texture.getHeight() != height) {
+				if (texture.isCreated()) {
+					texture.destroy();
+				}
+
+				TextureDesc desc = TextureDesc(width, height);
+				if (channels == 1) {
+					desc.format = TextureDesc::Format::RED;
+					desc.internalFormat = TextureDesc::InternalFormat::R8;
+				} else {
+					desc.format = TextureDesc::Format::RGB;
+					desc.internalFormat = TextureDesc::InternalFormat::RGB8;
+				}
+				desc.type = TextureDesc::Type::UNSIGNED_BYTE;
+				desc.wrapS = TextureDesc::Wrap::CLAMP;
+				desc.wrapT = TextureDesc::Wrap::CLAMP;
+				desc.minFilter = TextureDesc::Filter::LINEAR;
+				desc.magFilter = TextureDesc::Filter::LINEAR;
+
+				texture.init(desc);
+				texture.bind();
+
+				texture.resetPixelStorage();
+				texture.setUnpackStorageHint(gfx::PixelStorage::ALIGNMENT, 1);
+
+				texture.setData(pixels.data());
+			} else if (dirtyTop < dirtyBottom) {
+				texture.resetPixelStorage();
+				texture.setUnpackStorageHint(gfx::PixelStorage::ALIGNMENT, 1);
+
+				texture.setSubData(&pixels[static_cast<Size>(dirtyTop) * width * channels], 0, dirtyTop, width, dirtyBottom - dirtyTop);
+			}
+
+			dirtyTop = height;
+			dirtyBottom = 0;
+
+			return texture;
+		}
+
+		unsigned int GlyphAtlas::getWidth() const {
+			return width;
+		}
+
+		unsigned int GlyphAtlas::getHeight() const {
+			return height;
+		}
+
+		unsigned int GlyphAtlas::getChannels() const {
+			return channels;
+		}
+
+		Size GlyphAtlas::getGlyphCount() const {
+			return glyphs.size();
+		}
+
+		Index GlyphAtlas::getGeneration() const {
+			return generation;
+		}
+
+		void GlyphAtlas::destroy() {
+			if (texture.isCreated()) {
+				texture.destroy();
+			}
+
+			glyphs.clear();
+
+			penX = 0;
+			penY = 0;
+			rowHeight = 0;
+
+			std::fill(pixels.begin(), pixels.end(), static_cast<Byte>(0));
+			dirtyTop = height;
+			dirtyBottom = 0;
+
+			//anything built with the old glyphs has to be rebuilt
+			++generation;
+		}
+
 		bool GlyphMetrics::operator==(const GlyphMetrics & other) const {
 			return width == other.width && height == other.height && bearingX == other.bearingX && bearingY == other.bearingY && advanceX == other.advanceX && advanceY == other.advanceY;
 		}
@@ -633,32 +1569,110 @@ namespace mc {
 
 		void Letter::onClean() {}
 
-		Text::Text(const std::string & s, const Font & f) : Text(os::toWideString(s), f) {}
-
-		Text::Text(const std::wstring & t, const Font & f) : TexturedEntity2D(), text(t), font(f) {}
+		Text::Text(const std::string & t, const Font & f) : TexturedEntity2D(), text(t), font(f) {}
 
-		void mc::gfx::Text::setText(const std::string & newText) {
-			setText(os::toWideString(newText));
-		}
+		Text::Text(const std::wstring & t, const Font & f) : Text(utf8::fromWideString(t), f) {}
 
-		void Text::setText(const std::wstring & newText) {
+		void Text::setText(const std::string & newText) {
 			if (text != newText) {
 				makeDirty();
 
 				text = newText;
+				textReplaced = true;
 			}
 		}
 
-		std::wstring& Text::getText() {
+		void Text::setText(const std::wstring & newText) {
+			setText(utf8::fromWideString(newText));
+		}
+
+		std::string& Text::getText() {
 			makeDirty();
 
+			//there is no way to know what will be changed, so everything is laid out again
+			textReplaced = true;
+
 			return text;
 		}
 
-		const std::wstring& Text::getText() const {
+		const std::string& Text::getText() const {
 			return text;
 		}
 
+		std::wstring Text::getWideText() const {
+			return utf8::toWideString(text);
+		}
+
+		void Text::append(const std::string & str) {
+			insert(text.length(), str);
+		}
+
+		void Text::append(const std::wstring & str) {
+			append(utf8::fromWideString(str));
+		}
+
+		void Text::insert(const Index position, const std::string & str) {
+#ifdef MACE_DEBUG_CHECK_ARGS
+			if (position > text.length()) {
+				MACE__THROW(OutOfBounds, "Can\'t insert at " + std::to_string(position) + " in a Text with " + std::to_string(text.length()) + " bytes");
+			} else if (position < text.length() && !utf8::isCodepointStart(text[position])) {
+				MACE__THROW(OutOfBounds, "Can\'t insert at " + std::to_string(position) + " because it is in the middle of a character");
+			}
+#endif
+
+			if (str.empty()) {
+				return;
+			}
+
+			//the rest of the text is already valid, so only the new part has to be checked
+			if (utf8::validate(str) == str.length()) MACE_LIKELY{
+				text.insert(position, str);
+
+				markEdited(position, text.length() - position - str.length());
+			} else {
+				const std::string sanitized = utf8::sanitize(str);
+				text.insert(position, sanitized);
+
+				markEdited(position, text.length() - position - sanitized.length());
+			}
+		}
+
+		void Text::insert(const Index position, const std::wstring & str) {
+			insert(position, utf8::fromWideString(str));
+		}
+
+		void Text::erase(const Index position, const Size length) {
+#ifdef MACE_DEBUG_CHECK_ARGS
+			if (position > text.length() || length > text.length() - position) {
+				MACE__THROW(OutOfBounds, "Can\'t erase " + std::to_string(length) + " bytes at " + std::to_string(position) + " in a Text with " + std::to_string(text.length()) + " bytes");
+			} else if ((position < text.length() && !utf8::isCodepointStart(text[position])) || (position + length < text.length() && !utf8::isCodepointStart(text[position + length]))) {
+				MACE__THROW(OutOfBounds, "Can\'t erase " + std::to_string(length) + " bytes at " + std::to_string(position) + " because it would split a character");
+			}
+#endif
+
+			if (length == 0) {
+				return;
+			}
+
+			text.erase(position, length);
+
+			markEdited(position, text.length() - position);
+		}
+
+		void Text::markEdited(const Index position, const Size suffix) {
+			makeDirty();
+
+			if (edited) {
+				//anything changed by an earlier edit still has to be laid out
+				editBegin = std::min(editBegin, position);
+				editSuffix = std::min(editSuffix, suffix);
+			} else {
+				edited = true;
+				editBegin = position;
+				editSuffix = suffix;
+			}
+		}
+
 		void Text::setFont(const Font & f) {
 			if (font != f) {
 				makeDirty();
@@ -677,10 +1691,93 @@ namespace mc {
 			return font;
 		}
 
+		bool TextLayout::Key::operator==(const Key & other) const {
+			return hasSameParameters(*this, other) && text == other.text;
+		}
+
+		bool TextLayout::Key::operator!=(const Key & other) const {
+			return !operator==(other);
+		}
+
 		const std::vector<std::shared_ptr<Letter>>& Text::getLetters() const {
 			return letters;
 		}
 
+		std::shared_ptr<const TextLayout> Text::getLayout() const {
+			return layout;
+		}
+
+		void Text::setLetterEntities(const bool enabled) {
+			if (letterEntities != enabled) {
+				makeDirty();
+
+				letterEntities = enabled;
+				//the lines weren't broken up while there were letters
+				wrapChanged = true;
+			}
+		}
+
+		bool Text::hasLetterEntities() const {
+			return letterEntities;
+		}
+
+		void Text::setDistanceField(const bool enabled) {
+			if (distanceField != enabled) {
+				makeDirty();
+
+				distanceField = enabled;
+			}
+		}
+
+		bool Text::hasDistanceField() const {
+			return distanceField;
+		}
+
+		void Text::setMaxWidth(const float width) {
+#ifdef MACE_DEBUG_CHECK_ARGS
+			if (width < 0.0f) {
+				MACE__THROW(OutOfBounds, "The maximum width of a Text can\'t be negative");
+			}
+#endif
+
+			if (maxWidth != width) {
+				makeDirty();
+
+				maxWidth = width;
+				wrapChanged = true;
+			}
+		}
+
+		float Text::getMaxWidth() const {
+			return maxWidth;
+		}
+
+		void Text::setOverflow(const TextOverflow o) {
+			if (overflow != o) {
+				makeDirty();
+
+				overflow = o;
+				wrapChanged = true;
+			}
+		}
+
+		TextOverflow Text::getOverflow() const {
+			return overflow;
+		}
+
+		Size Text::getRowCount() const {
+			return rowCount;
+		}
+
+		bool Text::LineWrap::operator==(const LineWrap & other) const {
+			return firstRow == other.firstRow && breaks == other.breaks && truncated == other.truncated
+				&& (!truncated || (visibleQuads == other.visibleQuads && ellipsisX == other.ellipsisX));
+		}
+
+		bool Text::LineWrap::operator!=(const LineWrap & other) const {
+			return !operator==(other);
+		}
+
 		void Text::setTexture(const Texture & tex) {
 			if (tex != texture) {
 				makeDirty();
@@ -700,7 +1797,7 @@ namespace mc {
 		}
 
 		bool Text::operator==(const Text & other) const {
-			return Entity2D::operator==(other) && letters == other.letters && text == other.text && texture == other.texture;
+			return Entity2D::operator==(other) && letters == other.letters && text == other.text && texture == other.texture && letterEntities == other.letterEntities && distanceField == other.distanceField;
 		}
 
 		bool Text::operator!=(const Text & other) const {
@@ -714,103 +1811,692 @@ namespace mc {
 		void Text::onRender(Painter & p) {
 			p.setForegroundColor(Colors::BLACK);
 			p.fillRect();
+
+			if (letterEntities || layout == nullptr || layoutWidth == 0.0f || layoutHeight == 0.0f) {
+				return;
+			}
+
+			//glyphs rasterized in the background are added here, which changes the generation of their atlas
+			Font::updateGlyphs();
+
+			GlyphAtlas& atlas = distanceField ? font.getDistanceFieldAtlas() : font.getAtlas();
+			if (atlas.getGeneration() != atlasGeneration) {
+				//another Text made the atlas grow, so the texture coordinates in every block are wrong
+				markLinesDirty(0, std::numeric_limits<Index>::max());
+				buildBlocks();
+			}
+
+			visibleBlocks.clear();
+			for (const MeshBlock& block : blocks) {
+				if (!block.empty) {
+					visibleBlocks.push_back(&block.mesh);
+				}
+			}
+
+			if (visibleBlocks.empty()) {
+				return;
+			}
+
+			p.setTexture(texture.isCreated() ? texture : Texture(Colors::WHITE), TextureSlot::FOREGROUND);
+			p.setTexture(atlas.getTexture(), TextureSlot::BACKGROUND);
+
+			//the blocks are in window space from the top left corner, which has to be mapped onto -1 to 1.
+			//doing it here means resizing the layout never rebuilds a block
+			p.push();
+			p.translate(-1.0f, 1.0f);
+			p.scale(1.0f / layoutWidth, 1.0f / layoutHeight);
+			p.drawModels(visibleBlocks, distanceField ? Painter::Brush::DISTANCE_FIELD : Painter::Brush::MULTICOMPONENT_BLEND);
+			p.pop();
 		}
 
-		void Text::onDestroy() {}
+		void Text::onDestroy() {
+			for (MeshBlock& block : blocks) {
+				if (block.created) {
+					block.mesh.destroy();
+				}
+			}
+
+			blocks.clear();
+			visibleBlocks.clear();
+			firstDirtyLine = lastDirtyLine = 0;
+
+			layout = nullptr;
+			textReplaced = true;
+			edited = false;
+		}
 
 		void Text::onClean() {
 			if (font.getID() == 0) {
 				MACE__THROW(InitializationFailed, "Can\'t render Text with unitialized font!");
 			}
 
-			while (letters.size() > text.length()) {
-				removeChild(letters.back());
-				letters.pop_back();
+			WindowModule* window = gfx::getCurrentWindow();
+
+			TextLayout::Key key = TextLayout::Key();
+			key.fontID = font.getID();
+			key.fontSize = font.height;
+			key.dpi = window->getMonitor().getDPI();
+			key.windowSize = {window->getLaunchConfig().width, window->getLaunchConfig().height};
+			//letters are always rasterized normally
+			key.distanceField = distanceField && !letterEntities;
+
+			bool layoutChanged = true;
+
+			//moving or resizing a Text also makes it dirty, but none of that changes the layout
+			if (layout == nullptr || textReplaced || !hasSameParameters(layout->key, key)) {
+				//getText() hands out the string itself, so anything could have been put in it
+				if (textReplaced && !utf8::isValid(text)) MACE_UNLIKELY{
+					text = utf8::sanitize(text);
+				}
+
+				key.text = text;
+
+				const std::size_t hash = hashLayoutKey(key);
+
+				const auto cached = layoutCache.find(hash);
+				if (cached != layoutCache.end() && cached->second->key == key) {
+					layout = cached->second;
+				} else {
+					if (layoutCache.size() >= MACE__TEXT_LAYOUT_CACHE_SIZE) MACE_UNLIKELY{
+						//layouts in use are kept alive by the Text that uses them
+						layoutCache.clear();
+					}
+
+					layout = createLayout(key);
+					layoutCache[hash] = layout;
+				}
+
+				markLinesDirty(0, std::numeric_limits<Index>::max());
+			} else if (edited) {
+				relayout();
+			} else {
+				layoutChanged = false;
 			}
-			while (letters.size() < text.length()) {
-				std::shared_ptr<Letter> letter = std::shared_ptr<Letter>(new Letter());
-				letters.push_back(letter);
-				addChild(letter);
+
+			textReplaced = false;
+			edited = false;
+
+			if (letterEntities) {
+				layoutWidth = layout->width;
+				layoutHeight = layout->height;
+				rowCount = layout->lines.size();
+
+				layoutLetters();
+			} else {
+				if (layoutChanged || wrapChanged) {
+					wrapLines(layoutChanged);
+					wrapChanged = false;
+				}
+
+				clearLetters();
+				buildBlocks();
 			}
 
-			font.calculateMetrics();
+			setWidth(layoutWidth);
+			setHeight(layoutHeight);
+		}
+
+		std::shared_ptr<TextLayout> Text::createLayout(const TextLayout::Key& key) {
+			std::shared_ptr<TextLayout> out = std::make_shared<TextLayout>();
+			out->key = key;
+			out->lines = layoutLines(*out, text, 0, text.length());
+
+			for (const TextLayout::Line& line : out->lines) {
+				out->maxLineWidth = std::max(out->maxLineWidth, line.width);
+			}
+
+			updateLayoutSize(*out);
+
+			return out;
+		}
+
+		std::vector<TextLayout::Line> Text::layoutLines(TextLayout& out, const std::string& str, const Index begin, const Index end) {
+			const TextLayout::Key& key = out.key;
+
+			//distance field glyphs are only rasterized at one size, so their metrics are scaled to the real size instead
+			float scaleX = 1.0f, scaleY = 1.0f;
+			if (key.distanceField) {
+				font.calculateDistanceFieldMetrics();
+
+				scaleX = static_cast<float>(key.fontSize * key.dpi[0]) / (72.0f * MACE__DISTANCE_FIELD_GLYPH_SIZE);
+				scaleY = static_cast<float>(key.fontSize * key.dpi[1]) / (72.0f * MACE__DISTANCE_FIELD_GLYPH_SIZE);
+			} else {
+				font.calculateMetrics();
+			}
 
 			const WindowModule* window = gfx::getCurrentWindow();
 
 			const bool hasKerning = font.hasKerning();
 
-			const signed long linegap = font.getAscent() - font.getDescent() + font.getHeight();
+			const signed long linegap = static_cast<signed long>((font.getAscent() - font.getDescent() + font.getHeight()) * scaleY);
+			const signed long descent = static_cast<signed long>(font.getDescent() * scaleY);
+
+			out.lineHeight = window->convertPixelsToRelativeYCoordinates(static_cast<float>(linegap) / 64.0f);
+
+			std::vector<TextLayout::Line> lines = std::vector<TextLayout::Line>();
+
+			TextLayout::Line line = TextLayout::Line();
+			line.begin = begin;
 
 			signed long x = 0;
+			//for kerning, 0 at the start of every line
+			char32_t previous = 0;
+			//whether the last character can be wrapped after
+			bool afterBreak = false;
 
-			std::vector<signed long> lineWidths{};
-			for (Index i = 0; i < text.length(); ++i) {
-				if (text[i] == '\n') {
-					lineWidths.push_back(x);
+			const char* data = str.data();
 
-					x = 0;
-					font.getCharacter(' ', letters[i]);
-					letters[i]->getPainter().setOpacity(0.0f);
-				} else {
-					font.getCharacter(text[i], letters[i]);
+			for (Index i = begin; i < end;) {
+				//where the character starts, since decoding moves i past it
+				const Index start = i;
+				const char32_t character = utf8::decode(data, i);
 
-					const GlyphMetrics& glyphMetrics = letters[i]->getGlpyhMetrics();
+				if (character == '\n') {
+					line.length = start - line.begin;
+					line.width = x;
+					lines.push_back(std::move(line));
 
-					//freetype uses absolute values (pixels) and we use relative. so by dividing the pixel by the size, we get relative values
-					letters[i]->setWidth(window->convertPixelsToRelativeXCoordinates(glyphMetrics.width >> 6));
-					letters[i]->setHeight(window->convertPixelsToRelativeYCoordinates(glyphMetrics.height >> 6));
+					line = TextLayout::Line();
+					line.begin = i;
+
+					x = 0;
+					previous = 0;
+					afterBreak = false;
+				} else {
+					//glyphs that haven't been rasterized yet are drawn blank until Font::updateGlyphs() adds them
+					const Glyph& glyph = key.distanceField ? font.requestDistanceFieldGlyph(character) : font.requestGlyph(character);
+
+					GlyphMetrics glyphMetrics = glyph.metrics;
+					if (key.distanceField) {
+						glyphMetrics.width = static_cast<signed long>(glyphMetrics.width * scaleX);
+						glyphMetrics.height = static_cast<signed long>(glyphMetrics.height * scaleY);
+						glyphMetrics.bearingX = static_cast<signed long>(glyphMetrics.bearingX * scaleX);
+						glyphMetrics.bearingY = static_cast<signed long>(glyphMetrics.bearingY * scaleY);
+						glyphMetrics.advanceX = static_cast<signed long>(glyphMetrics.advanceX * scaleX);
+						glyphMetrics.advanceY = static_cast<signed long>(glyphMetrics.advanceY * scaleY);
+					}
 
-					Vector<signed long, 2> position = {x, -static_cast<signed long>(lineWidths.size()) * linegap};
+					//lines are laid out on their own, so the y is relative to the top of the line
+					Vector<signed long, 2> position = {x, 0};
 
-					if (i > 0 && hasKerning) {
-						const Vector<signed long, 2> delta = font.getKerning(text[i - 1], text[i]);
+					if (previous != 0 && hasKerning) {
+						const Vector<signed long, 2> delta = font.getKerning(previous, character);
 
-						position[0] += delta[0];
-						position[1] += delta[1];
+						position[0] += static_cast<signed long>(delta[0] * scaleX);
+						position[1] += static_cast<signed long>(delta[1] * scaleY);
 					}
 
 					position[1] += glyphMetrics.height;
 					//i cant bear this
 					position[1] -= (glyphMetrics.height - glyphMetrics.bearingY) << 1;
 					position[1] -= linegap;
-					position[1] -= font.getDescent() << 1;
-
-					letters[i]->setX(window->convertPixelsToRelativeXCoordinates((position[0] + glyphMetrics.width) >> 6));
-					letters[i]->setY(window->convertPixelsToRelativeYCoordinates(position[1] >> 6));
-
-					letters[i]->getPainter().setOpacity(getPainter().getOpacity());
+					position[1] -= descent << 1;
+
+					if (glyphMetrics.width != 0 && glyphMetrics.height != 0) {
+						//freetype uses absolute values (pixels) and we use relative. so by dividing the pixel by the size, we get relative values
+						float halfWidth = window->convertPixelsToRelativeXCoordinates(glyphMetrics.width >> 6);
+						float halfHeight = window->convertPixelsToRelativeYCoordinates(glyphMetrics.height >> 6);
+						if (key.distanceField) {
+							//the quad also has to cover the spread around the glyph. it is sized from the metrics instead of the
+							//atlas, because a glyph that is still being rasterized has no size there yet and the layout is cached
+							halfWidth = window->convertPixelsToRelativeXCoordinates(((glyph.metrics.width >> 6) + MACE__DISTANCE_FIELD_SPREAD * 2) * scaleX);
+							halfHeight = window->convertPixelsToRelativeYCoordinates(((glyph.metrics.height >> 6) + MACE__DISTANCE_FIELD_SPREAD * 2) * scaleY);
+						}
+
+						const float centerX = window->convertPixelsToRelativeXCoordinates((position[0] + glyphMetrics.width) >> 6);
+						const float centerY = window->convertPixelsToRelativeYCoordinates(position[1] >> 6);
+
+						line.quads.push_back({character, start - line.begin, centerX - halfWidth, centerY + halfHeight, centerX + halfWidth, centerY - halfHeight, afterBreak || isIdeograph(character)});
+					}
 
 					x += glyphMetrics.advanceX;
 					x += glyphMetrics.width;
 
-					if (this->texture.isCreated()) {
-						letters[i]->texture = this->texture;
-					} else {
-						letters[i]->texture = Colors::WHITE;
+					previous = character;
+					afterBreak = isBreakingSpace(character) || character == '-' || isIdeograph(character);
+				}
+			}
+
+			//a range that ends in the middle of the text stops right after a newline, so its last line was already added
+			if (end == str.length()) {
+				line.length = end - line.begin;
+				line.width = x;
+				lines.push_back(std::move(line));
+			}
+
+			return lines;
+		}
+
+		void Text::relayout() {
+			if (layout.use_count() > 1) {
+				//the layout is shared with the cache or another Text, so it has to be copied before it can be changed
+				layout = std::make_shared<TextLayout>(*layout);
+			}
+
+			//the key no longer matches the text, and this layout can't be cached anyway
+			layout->key.text.clear();
+
+			std::vector<TextLayout::Line>& lines = layout->lines;
+
+			const Size oldLength = lines.back().begin + lines.back().length;
+			const Size newLength = text.length();
+
+			const Index prefix = std::min(editBegin, std::min(oldLength, newLength));
+			const Size suffix = std::min(editSuffix, std::min(oldLength, newLength) - prefix);
+
+			//the first line touched by an edit is the last one that starts at or before it
+			const Index first = static_cast<Index>(std::upper_bound(lines.begin(), lines.end(), prefix, [](const Index position, const TextLayout::Line& line) {
+				return position < line.begin;
+			}) - lines.begin()) - 1;
+
+			//lines can be reused when they, and the newline before them, are in the unchanged end of the text
+			const Index reusedBegin = oldLength - suffix + 1;
+			const Index reused = static_cast<Index>(std::lower_bound(lines.begin() + first + 1, lines.end(), reusedBegin, [](const TextLayout::Line& line, const Index position) {
+				return line.begin < position;
+			}) - lines.begin());
+
+			const Index end = reused == lines.size() ? newLength : lines[reused].begin + newLength - oldLength;
+
+			std::vector<TextLayout::Line> changed = layoutLines(*layout, text, lines[first].begin, end);
+
+			bool removedWidest = false;
+			for (Index i = first; i < reused; ++i) {
+				if (lines[i].width >= layout->maxLineWidth) {
+					removedWidest = true;
+				}
+			}
+
+			for (Index i = reused; i < lines.size(); ++i) {
+				lines[i].begin = lines[i].begin + newLength - oldLength;
+			}
+
+			const Size removedCount = reused - first, addedCount = changed.size();
+			const Size replacedCount = std::min(removedCount, addedCount);
+
+			std::move(changed.begin(), changed.begin() + replacedCount, lines.begin() + first);
+			if (addedCount > removedCount) {
+				lines.insert(lines.begin() + first + replacedCount, std::make_move_iterator(changed.begin() + replacedCount), std::make_move_iterator(changed.end()));
+			} else if (removedCount > addedCount) {
+				lines.erase(lines.begin() + first + replacedCount, lines.begin() + reused);
+			}
+
+			signed long widest = 0;
+			for (Index i = first; i < first + addedCount; ++i) {
+				widest = std::max(widest, lines[i].width);
+			}
+
+			if (removedWidest && widest < layout->maxLineWidth) MACE_UNLIKELY{
+				//the widest line got shorter, so every line has to be checked
+				layout->maxLineWidth = 0;
+				for (const TextLayout::Line& line : lines) {
+					layout->maxLineWidth = std::max(layout->maxLineWidth, line.width);
+				}
+			} else {
+				layout->maxLineWidth = std::max(layout->maxLineWidth, widest);
+			}
+
+			updateLayoutSize(*layout);
+
+			if (addedCount == removedCount) {
+				markLinesDirty(first, first + addedCount);
+			} else {
+				//every line after the edit moved up or down
+				markLinesDirty(first, std::numeric_limits<Index>::max());
+			}
+		}
+
+		void Text::wrapLines(const bool layoutChanged) {
+			const std::vector<TextLayout::Line>& lines = layout->lines;
+
+			if (layoutChanged) {
+				//it may be for a different font, so it is laid out again when it is needed
+				ellipsis = TextLayout::Line();
+			}
+
+			if (maxWidth == 0.0f) {
+				if (!wraps.empty()) {
+					wraps.clear();
+					markLinesDirty(0, std::numeric_limits<Index>::max());
+				}
+
+				rowCount = lines.size();
+				layoutWidth = layout->width;
+				layoutHeight = layout->height;
+				return;
+			}
+
+			const WindowModule* window = gfx::getCurrentWindow();
+
+			//quads are laid out from the left edge, across twice the width of this Entity
+			const float limit = maxWidth * 2.0f;
+
+			float ellipsisWidth = 0.0f;
+			if (overflow == TextOverflow::ELLIPSIS) {
+				if (ellipsis.length == 0) {
+					const std::string str = font.hasCharacter(0x2026) ? "\xe2\x80\xa6" : "...";
+
+					//everything but the text, which can be long
+					TextLayout scratch = TextLayout();
+					scratch.key.fontID = layout->key.fontID;
+					scratch.key.fontSize = layout->key.fontSize;
+					scratch.key.dpi = layout->key.dpi;
+					scratch.key.windowSize = layout->key.windowSize;
+					scratch.key.distanceField = layout->key.distanceField;
+					ellipsis = std::move(layoutLines(scratch, str, 0, str.length()).front());
+				}
+
+				ellipsisWidth = window->convertPixelsToRelativeXCoordinates(ellipsis.width >> 6);
+			}
+
+			std::vector<LineWrap> newWraps = std::vector<LineWrap>(lines.size());
+
+			Index row = 0;
+			float widest = 0.0f;
+			for (Index i = 0; i < lines.size(); ++i) {
+				const std::vector<TextLayout::GlyphQuad>& quads = lines[i].quads;
+
+				LineWrap& wrap = newWraps[i];
+				wrap.firstRow = row++;
+
+				float width = window->convertPixelsToRelativeXCoordinates(lines[i].width >> 6);
+				if (width <= limit || quads.empty()) MACE_LIKELY{
+					widest = std::max(widest, std::min(width, limit));
+					continue;
+				}
+
+				if (overflow == TextOverflow::WRAP) {
+					Index rowFirst = 0, opportunity = 0;
+					float rowLeft = 0.0f;
+
+					width = 0.0f;
+					//greedy, so a row is only broken once the next glyph doesn't fit. every row gets at least one glyph
+					for (Index q = rowFirst + 1; q < quads.size(); ++q) {
+						if (quads[q].breakBefore) {
+							opportunity = q;
+						}
+
+						if (quads[q].right - rowLeft > limit) {
+							//words that are too long for a row on their own are broken where they stop fitting
+							const Index next = opportunity > rowFirst ? opportunity : q;
+
+							width = std::max(width, quads[next - 1].right - rowLeft);
+
+							rowFirst = next;
+							rowLeft = quads[next].left;
+							wrap.breaks.emplace_back(next, rowLeft);
+							++row;
+
+							//the glyphs after the break were checked against the old row
+							q = next;
+						}
+					}
+
+					width = std::max(width, quads.back().right - rowLeft);
+				} else {
+					const float available = limit - ellipsisWidth;
+
+					Index visible = 0;
+					while (visible < quads.size() && quads[visible].right <= available) {
+						++visible;
+					}
+
+					if (visible == quads.size()) {
+						//only the spaces at the end didn't fit
+						widest = std::max(widest, limit);
+						continue;
 					}
+
+					wrap.truncated = true;
+					wrap.visibleQuads = visible;
+					wrap.ellipsisX = std::min(quads[visible].left, available);
+
+					width = wrap.ellipsisX + ellipsisWidth;
 				}
+
+				widest = std::max(widest, width);
 			}
 
-			lineWidths.push_back(x);
+			//only the lines that are broken up differently have to be rebuilt
+			Index firstChanged = newWraps.size(), lastChanged = 0;
+			for (Index i = 0; i < newWraps.size(); ++i) {
+				const LineWrap& wrap = newWraps[i];
 
-			signed long height = static_cast<signed long>(lineWidths.size()) * linegap;
-			signed long width = 0;
-			for(auto lineWidth : lineWidths){
-				if(lineWidth > width){
-					width = lineWidth;
+				//no wraps means every line is a single row
+				const bool unchanged = i < wraps.size() ? wrap == wraps[i] : wraps.empty() && wrap.firstRow == i && wrap.breaks.empty() && !wrap.truncated;
+				if (!unchanged) {
+					firstChanged = std::min(firstChanged, i);
+					lastChanged = i + 1;
 				}
 			}
 
-			// it is >> 7 instead of >> 6 because we also want to divide the total of it in half (so shift an additional bit to the right)
-			const float widthPx = window->convertPixelsToRelativeXCoordinates(width >> 7);
-			const float heightPx = window->convertPixelsToRelativeYCoordinates(height >> 7);
+			if (firstChanged < lastChanged) {
+				markLinesDirty(firstChanged, lastChanged);
+			}
 
-			setWidth(widthPx);
-			setHeight(heightPx);
+			wraps = std::move(newWraps);
 
+			rowCount = row;
+			layoutWidth = widest * 0.5f;
+			layoutHeight = layout->lineHeight * static_cast<float>(rowCount) * 0.5f;
+		}
+
+		void Text::clearLetters() {
 			for (auto letter : letters) {
-				letter->translate(-widthPx, heightPx);
+				removeChild(letter);
 			}
+
+			letters.clear();
+		}
+
+		void Text::layoutLetters() {
+			const Size letterCount = utf8::countCodepoints(text);
+
+			while (letters.size() > letterCount) {
+				removeChild(letters.back());
+				letters.pop_back();
+			}
+			while (letters.size() < letterCount) {
+				std::shared_ptr<Letter> letter = std::shared_ptr<Letter>(new Letter());
+				letters.push_back(letter);
+				addChild(letter);
+			}
+
+			//the layout may have come from the cache, so the size of the face has to be set again
+			font.calculateMetrics();
+
+			//there is a Letter for every character, but the layout uses byte offsets into the text
+			std::vector<Index> letterIndices = std::vector<Index>(text.length());
+
+			Index position = 0;
+			for (Index i = 0; i < letterCount; ++i) {
+				letterIndices[position] = i;
+
+				const char32_t character = utf8::decode(text.data(), position);
+				font.getCharacter(character == '\n' ? ' ' : character, letters[i]);
+
+				//characters without a quad, like spaces and newlines, take up no room
+				letters[i]->setWidth(0.0f);
+				letters[i]->setHeight(0.0f);
+
+				letters[i]->getPainter().setOpacity(getPainter().getOpacity());
+
+				if (this->texture.isCreated()) {
+					letters[i]->texture = this->texture;
+				} else {
+					letters[i]->texture = Colors::WHITE;
+				}
+			}
+
+			for (Index lineIndex = 0; lineIndex < layout->lines.size(); ++lineIndex) {
+				const TextLayout::Line& line = layout->lines[lineIndex];
+				const float offset = static_cast<float>(lineIndex) * layout->lineHeight;
+
+				for (const TextLayout::GlyphQuad& quad : line.quads) {
+					const std::shared_ptr<Letter>& letter = letters[letterIndices[line.begin + quad.index]];
+
+					letter->setWidth((quad.right - quad.left) * 0.5f);
+					letter->setHeight((quad.top - quad.bottom) * 0.5f);
+
+					//quads start from the top left corner, but letters are positioned from the center
+					letter->setX((quad.left + quad.right) * 0.5f - layout->width);
+					letter->setY((quad.top + quad.bottom) * 0.5f - offset + layout->height);
+				}
+			}
+
+			//the blocks are out of date by the time letters are turned off again
+			markLinesDirty(0, std::numeric_limits<Index>::max());
+		}
+
+		void Text::markLinesDirty(const Index first, const Index last) {
+			if (firstDirtyLine == lastDirtyLine) {
+				firstDirtyLine = first;
+				lastDirtyLine = last;
+			} else {
+				firstDirtyLine = std::min(firstDirtyLine, first);
+				lastDirtyLine = std::max(lastDirtyLine, last);
+			}
+		}
+
+		void Text::buildBlocks() {
+			const GlyphAtlas& atlas = layout != nullptr && layout->key.distanceField ? font.getDistanceFieldAtlas() : font.getAtlas();
+			atlasGeneration = atlas.getGeneration();
+
+			const Size lineCount = layout == nullptr ? 0 : layout->lines.size();
+			const Size blockCount = (lineCount + MACE__TEXT_BLOCK_LINES - 1) / MACE__TEXT_BLOCK_LINES;
+
+			while (blocks.size() > blockCount) {
+				if (blocks.back().created) {
+					blocks.back().mesh.destroy();
+				}
+
+				blocks.pop_back();
+			}
+			blocks.resize(blockCount);
+
+			if (firstDirtyLine < lastDirtyLine) {
+				const Index firstBlock = firstDirtyLine / MACE__TEXT_BLOCK_LINES;
+				const Index lastBlock = lastDirtyLine >= lineCount ? blockCount : (lastDirtyLine + MACE__TEXT_BLOCK_LINES - 1) / MACE__TEXT_BLOCK_LINES;
+
+				for (Index i = firstBlock; i < lastBlock; ++i) {
+					buildBlock(i);
+				}
+			}
+
+			firstDirtyLine = lastDirtyLine = 0;
+		}
+
+		void Text::buildBlock(const Index blockIndex) {
+			MeshBlock& block = blocks[blockIndex];
+			block.empty = true;
+
+			const GlyphAtlas& atlas = layout->key.distanceField ? font.getDistanceFieldAtlas() : font.getAtlas();
+
+			const Index firstLine = blockIndex * MACE__TEXT_BLOCK_LINES;
+			const Index lastLine = std::min(firstLine + MACE__TEXT_BLOCK_LINES, layout->lines.size());
+
+			Size quadCount = 0;
+			for (Index i = firstLine; i < lastLine; ++i) {
+				quadCount += layout->lines[i].quads.size();
+			}
+
+			if (quadCount == 0) {
+				return;
+			}
+
+			const float atlasWidth = static_cast<float>(atlas.getWidth()), atlasHeight = static_cast<float>(atlas.getHeight());
+
+			std::vector<float> vertices = std::vector<float>();
+			std::vector<float> textureCoordinates = std::vector<float>();
+			std::vector<unsigned int> indices = std::vector<unsigned int>();
+			vertices.reserve(quadCount * 12);
+			textureCoordinates.reserve(quadCount * 8);
+			indices.reserve(quadCount * 6);
+
+			//x is how far left the quad is moved by wrapping, and y is how far down its row is
+			const auto addQuad = [&](const TextLayout::GlyphQuad& quad, const float x, const float y) {
+				const Glyph* glyph = atlas.getGlyph(static_cast<unsigned int>(quad.character));
+				if (glyph == nullptr || glyph->width == 0 || glyph->height == 0) {
+					//the font was destroyed after this was laid out, or the glyph is still being rasterized
+					return;
+				}
+
+				const float u0 = static_cast<float>(glyph->x) / atlasWidth, u1 = static_cast<float>(glyph->x + glyph->width) / atlasWidth;
+				const float v0 = static_cast<float>(glyph->y) / atlasHeight, v1 = static_cast<float>(glyph->y + glyph->height) / atlasHeight;
+
+				const float left = quad.left - x, right = quad.right - x;
+				const float top = quad.top - y, bottom = quad.bottom - y;
+
+				const unsigned int base = static_cast<unsigned int>(vertices.size() / 3);
+
+				//same winding and texture orientation as Model::getQuad()
+				vertices.insert(vertices.end(), {
+					left, bottom, 0.0f,
+					left, top, 0.0f,
+					right, top, 0.0f,
+					right, bottom, 0.0f
+				});
+				textureCoordinates.insert(textureCoordinates.end(), {
+					u0, v1,
+					u0, v0,
+					u1, v0,
+					u1, v1
+				});
+				indices.insert(indices.end(), {
+					base, base + 1, base + 3,
+					base + 1, base + 2, base + 3
+				});
+			};
+
+			for (Index i = firstLine; i < lastLine; ++i) {
+				const std::vector<TextLayout::GlyphQuad>& quads = layout->lines[i].quads;
+
+				if (wraps.empty()) {
+					const float offset = static_cast<float>(i) * layout->lineHeight;
+
+					for (const TextLayout::GlyphQuad& quad : quads) {
+						addQuad(quad, 0.0f, offset);
+					}
+
+					continue;
+				}
+
+				const LineWrap& wrap = wraps[i];
+
+				Index row = wrap.firstRow, nextBreak = 0;
+				float x = 0.0f;
+
+				const Size visible = wrap.truncated ? wrap.visibleQuads : quads.size();
+				for (Index q = 0; q < visible; ++q) {
+					if (nextBreak < wrap.breaks.size() && wrap.breaks[nextBreak].first == q) {
+						x = wrap.breaks[nextBreak].second;
+						++row;
+						++nextBreak;
+					}
+
+					addQuad(quads[q], x, static_cast<float>(row) * layout->lineHeight);
+				}
+
+				if (wrap.truncated) {
+					for (const TextLayout::GlyphQuad& quad : ellipsis.quads) {
+						addQuad(quad, -wrap.ellipsisX, static_cast<float>(row) * layout->lineHeight);
+					}
+				}
+			}
+
+			if (vertices.empty()) {
+				return;
+			}
+
+			if (!block.created) {
+				block.mesh.init();
+				block.created = true;
+			}
+
+			block.mesh.createVertices(static_cast<unsigned int>(vertices.size()), vertices.data(), PrimitiveType::TRIANGLES);
+			block.mesh.createTextureCoordinates(static_cast<unsigned int>(textureCoordinates.size()), textureCoordinates.data());
+			block.mesh.createIndices(static_cast<unsigned int>(indices.size()), indices.data());
+
+			block.empty = false;
 		}
 
 		const Texture& Button::getTexture() const {
@@ -899,8 +2585,15 @@ namespace mc {
 			}
 		}
 
-		void Button::onHover() {
-			doHover();
+		void Button::onInput(InputEvent& event) {
+			const Byte oldProperties = selectableProperties;
+
+			handleInput(event);
+
+			//the textures it draws depend on whether it is hovered or clicked
+			if (selectableProperties != oldProperties) {
+				makeDirty();
+			}
 		}
 
 		void Button::onDestroy() {
@@ -0,0 +1,535 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <MACE/Graphics/Hierarchy.h>
+#include <MACE/Core/Error.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace mc {
+	namespace gfx {
+		namespace {
+			template<typename T>
+			void reorder(std::vector<T>& values, const std::vector<Index>& from) {
+				std::vector<T> out = std::vector<T>();
+				out.reserve(from.size());
+
+				for (const Index position : from) {
+					out.push_back(std::move(values[position]));
+				}
+
+				values = std::move(out);
+			}
+		}//anon namespace
+
+		MACE_CONSTEXPR const TransformHierarchy::Node TransformHierarchy::NONE;
+
+		TransformHierarchy::Node TransformHierarchy::create(Entity* owner) {
+			const std::unique_lock<std::recursive_mutex> guard = lock();
+
+			Node node;
+			if (freeNodes.empty()) {
+				node = positions.size();
+
+				positions.push_back(NONE);
+				parentNodes.push_back(NONE);
+				firstChildren.push_back(NONE);
+				nextSiblings.push_back(NONE);
+				previousSiblings.push_back(NONE);
+				markedGenerations.push_back(0);
+			} else {
+				node = freeNodes.back();
+				freeNodes.pop_back();
+			}
+
+			//new nodes are roots, which can go anywhere, so appending them doesn't break the order
+			positions[node] = owners.size();
+
+			Transforms identity = Transforms();
+			for (Index axis = 0; axis < 3; ++axis) {
+				identity.translation[axis] = 0.0f;
+				identity.rotation[axis] = 0.0f;
+				identity.scaler[axis] = 1.0f;
+			}
+			local.push_back(identity);
+			transform.push_back(identity);
+			inherited.push_back(identity);
+			parents.push_back(NONE);
+			subtreeSizes.push_back(1);
+			owners.push_back(owner);
+			nodes.push_back(node);
+			dirty.push_back(false);
+			watched.push_back(false);
+			moved.push_back(false);
+			setMoved(positions[node]);
+
+			markedGenerations[node] = 0;
+			++liveCount;
+
+			return node;
+		}
+
+		void TransformHierarchy::destroy(const Node node) {
+			const std::unique_lock<std::recursive_mutex> guard = lock();
+
+			while (firstChildren[node] != NONE) {
+				setParent(firstChildren[node], NONE);
+			}
+
+			unlink(node);
+
+			//the position is left empty until the next sort
+			const Index position = positions[node];
+			owners[position] = nullptr;
+			dirty[position] = false;
+			watched[position] = false;
+			moved[position] = false;
+
+			positions[node] = NONE;
+			freeNodes.push_back(node);
+
+			--liveCount;
+			++generation;
+			sorted = false;
+		}
+
+		void TransformHierarchy::setParent(const Node node, const Node parent) {
+			const std::unique_lock<std::recursive_mutex> guard = lock();
+
+			if (parentNodes[node] == parent) {
+				return;
+			}
+
+#ifdef MACE_DEBUG_CHECK_ARGS
+			for (Node ancestor = parent; ancestor != NONE; ancestor = parentNodes[ancestor]) {
+				if (ancestor == node) {
+					MACE__THROW(AssertionFailed, "A node can\'t be moved below itself");
+				}
+			}
+#endif
+
+			unlink(node);
+
+			if (parent != NONE) {
+				parentNodes[node] = parent;
+				nextSiblings[node] = firstChildren[parent];
+				if (firstChildren[parent] != NONE) {
+					previousSiblings[firstChildren[parent]] = node;
+				}
+				firstChildren[parent] = node;
+			}
+
+			const Index position = positions[node];
+			parents[position] = parent == NONE ? NONE : positions[parent];
+			setMoved(position);
+
+			//the node may be under a different root now
+			++generation;
+			sorted = false;
+		}
+
+		TransformHierarchy::Node TransformHierarchy::getParent(const Node node) const {
+			const std::unique_lock<std::recursive_mutex> guard = lock();
+
+			return parentNodes[node];
+		}
+
+		void TransformHierarchy::moveTo(TransformHierarchy& other, const Node node, const Node parent, const std::function<void(Entity*, Node)>& callback) {
+#ifdef MACE_DEBUG_CHECK_ARGS
+			if (&other == this) {
+				MACE__THROW(AssertionFailed, "A node can\'t be moved into the hierarchy it is already in");
+			}
+#endif
+
+			//either order could be locked by another thread moving the other way
+			std::lock(mutex, other.mutex);
+			const std::unique_lock<std::recursive_mutex> guard(mutex, std::adopt_lock), otherGuard(other.mutex, std::adopt_lock);
+
+			sort();
+
+			const Index begin = positions[node], end = begin + subtreeSizes[begin];
+
+			//the subtree is contiguous and parents first, so every parent was already moved when its children are
+			std::vector<Node> added = std::vector<Node>();
+			added.reserve(end - begin);
+			for (Index i = begin; i < end; ++i) {
+				const Node movedNode = other.create(owners[i]);
+				const Index position = other.positions[movedNode];
+
+				other.local[position] = local[i];
+				other.transform[position] = transform[i];
+				other.inherited[position] = inherited[i];
+				other.watched[position] = watched[i];
+				other.setDirty(movedNode, dirty[i] != 0);
+				other.setParent(movedNode, i == begin ? parent : added[parents[i] - begin]);
+
+				added.push_back(movedNode);
+			}
+
+			const std::vector<Entity*> movedOwners = std::vector<Entity*>(owners.begin() + static_cast<std::ptrdiff_t>(begin), owners.begin() + static_cast<std::ptrdiff_t>(end));
+
+			//destroy() doesn't sort, so the positions stay valid. children go first, so none of them are made roots on the way
+			for (Index i = end; i-- > begin;) {
+				destroy(nodes[i]);
+			}
+
+			for (Index i = 0; i < added.size(); ++i) {
+				callback(movedOwners[i], added[i]);
+			}
+		}
+
+		void TransformHierarchy::setLocal(const Node node, const TransformMatrix& transformation) {
+			const std::unique_lock<std::recursive_mutex> guard = lock();
+
+			const Index position = positions[node];
+
+			//roots are made dirty by anything below them, so most of the time nothing actually moved
+			bool different = false;
+			for (Index axis = 0; axis < 3; ++axis) {
+				different = different || local[position].translation[axis] != transformation.translation[axis]
+					|| local[position].rotation[axis] != transformation.rotation[axis] || local[position].scaler[axis] != transformation.scaler[axis];
+
+				local[position].translation[axis] = transformation.translation[axis];
+				local[position].rotation[axis] = transformation.rotation[axis];
+				local[position].scaler[axis] = transformation.scaler[axis];
+			}
+
+			if (different) {
+				setMoved(position);
+			}
+		}
+
+		void TransformHierarchy::setDirty(const Node node, const bool d) {
+			const std::unique_lock<std::recursive_mutex> guard = lock();
+
+			Byte& current = dirty[positions[node]];
+			if ((current != 0) == d) {
+				return;
+			}
+
+			current = d;
+			if (d) {
+				dirtyNodes.push_back(node);
+			} else {
+				//the cleared node may have been a root that other nodes stopped at in markPath()
+				++generation;
+			}
+		}
+
+		bool TransformHierarchy::isDirty(const Node node) const {
+			const std::unique_lock<std::recursive_mutex> guard = lock();
+
+			return dirty[positions[node]] != 0;
+		}
+
+		Entity* TransformHierarchy::markPath(const Node node) {
+			const std::unique_lock<std::recursive_mutex> guard = lock();
+
+			for (Node current = node; markedGenerations[current] != generation; current = parentNodes[current]) {
+				markedGenerations[current] = generation;
+
+				if (parentNodes[current] == NONE) {
+					return owners[positions[current]];
+				}
+			}
+
+			return nullptr;
+		}
+
+		void TransformHierarchy::setWatched(const Node node, const bool w) {
+			const std::unique_lock<std::recursive_mutex> guard = lock();
+
+			watched[positions[node]] = w;
+		}
+
+		Metrics TransformHierarchy::getMetrics(const Node node) const {
+			const std::unique_lock<std::recursive_mutex> guard = lock();
+
+			const Index position = positions[node];
+
+			Metrics out = Metrics();
+			for (Index axis = 0; axis < 3; ++axis) {
+				out.transform.translation[axis] = transform[position].translation[axis];
+				out.transform.rotation[axis] = transform[position].rotation[axis];
+				out.transform.scaler[axis] = transform[position].scaler[axis];
+				out.inherited.translation[axis] = inherited[position].translation[axis];
+				out.inherited.rotation[axis] = inherited[position].rotation[axis];
+				out.inherited.scaler[axis] = inherited[position].scaler[axis];
+			}
+			return out;
+		}
+
+		void TransformHierarchy::visitDirty(const Node root, const std::function<void(Entity*)>& callback) {
+			const std::unique_lock<std::recursive_mutex> guard = lock();
+
+			sort();
+
+			//nodes the callback didn't clear, like ones that aren't initialized yet. they are only visited once
+			std::vector<Node> skipped = std::vector<Node>();
+
+			for (std::vector<Node> pending = takeNodes(dirtyNodes, dirty, root); !pending.empty(); pending = takeNodes(dirtyNodes, dirty, root)) {
+				for (const Node node : pending) {
+					//the callback may have changed the tree, so the positions are sorted again before they are used
+					sort();
+
+					if (positions[node] == NONE || !dirty[positions[node]]) {
+						continue;
+					}
+
+					callback(owners[positions[node]]);
+
+					if (positions[node] != NONE && dirty[positions[node]]) {
+						skipped.push_back(node);
+					}
+				}
+
+				sort();
+			}
+
+			dirtyNodes.insert(dirtyNodes.end(), skipped.begin(), skipped.end());
+		}
+
+		void TransformHierarchy::visit(const Node root, const std::function<void(Entity*)>& callback) {
+			const std::unique_lock<std::recursive_mutex> guard = lock();
+
+			sort();
+
+			const Index begin = positions[root], end = begin + subtreeSizes[begin];
+			for (Index i = begin; i < end; ++i) {
+				callback(owners[i]);
+			}
+		}
+
+		void TransformHierarchy::update(const Node root, const std::function<void(Entity*, Metrics&)>& callback) {
+			const std::unique_lock<std::recursive_mutex> guard = lock();
+
+			sort();
+
+			changed.resize(owners.size());
+
+			//moved nodes come parents first, so nodes below one that was already updated are skipped
+			Index updatedEnd = 0;
+			for (const Node node : takeNodes(movedNodes, moved, root)) {
+				const Index position = positions[node];
+				if (position < updatedEnd) {
+					continue;
+				}
+
+				updatedEnd = position + subtreeSizes[position];
+				updateRange(position, updatedEnd, callback);
+			}
+		}
+
+		Size TransformHierarchy::size() const {
+			const std::unique_lock<std::recursive_mutex> guard = lock();
+
+			return liveCount;
+		}
+
+		std::unique_lock<std::recursive_mutex> TransformHierarchy::lock() const {
+			return std::unique_lock<std::recursive_mutex>(mutex);
+		}
+
+		void TransformHierarchy::unlink(const Node node) {
+			const Node parent = parentNodes[node];
+			if (parent == NONE) {
+				return;
+			}
+
+			if (previousSiblings[node] == NONE) {
+				firstChildren[parent] = nextSiblings[node];
+			} else {
+				nextSiblings[previousSiblings[node]] = nextSiblings[node];
+			}
+
+			if (nextSiblings[node] != NONE) {
+				previousSiblings[nextSiblings[node]] = previousSiblings[node];
+			}
+
+			parentNodes[node] = NONE;
+			nextSiblings[node] = NONE;
+			previousSiblings[node] = NONE;
+		}
+
+		void TransformHierarchy::sort() {
+			if (sorted) MACE_LIKELY{
+				return;
+			}
+
+			std::vector<Node> order = std::vector<Node>();
+			order.reserve(liveCount);
+
+			std::vector<Node> stack = std::vector<Node>();
+
+			//roots keep their current order
+			for (Index i = 0; i < nodes.size(); ++i) {
+				const Node root = nodes[i];
+				if (owners[i] == nullptr || parentNodes[root] != NONE) {
+					continue;
+				}
+
+				stack.push_back(root);
+				while (!stack.empty()) {
+					const Node node = stack.back();
+					stack.pop_back();
+
+					order.push_back(node);
+
+					//children are linked newest first, so the oldest one is popped first
+					for (Node child = firstChildren[node]; child != NONE; child = nextSiblings[child]) {
+						stack.push_back(child);
+					}
+				}
+			}
+
+			std::vector<Index> from = std::vector<Index>();
+			from.reserve(order.size());
+			for (const Node node : order) {
+				from.push_back(positions[node]);
+			}
+
+			reorder(local, from);
+			reorder(transform, from);
+			reorder(inherited, from);
+			reorder(owners, from);
+			reorder(dirty, from);
+			reorder(watched, from);
+			reorder(moved, from);
+
+			nodes = std::move(order);
+			for (Index i = 0; i < nodes.size(); ++i) {
+				positions[nodes[i]] = i;
+			}
+
+			parents.resize(nodes.size());
+			subtreeSizes.assign(nodes.size(), 1);
+			for (Index i = 0; i < nodes.size(); ++i) {
+				const Node parent = parentNodes[nodes[i]];
+				parents[i] = parent == NONE ? NONE : positions[parent];
+			}
+
+			//children are after their parents, so going backwards adds up every subtree before it is needed
+			for (Index i = nodes.size(); i-- > 0;) {
+				if (parents[i] != NONE) {
+					subtreeSizes[parents[i]] += subtreeSizes[i];
+				}
+			}
+
+			sorted = true;
+		}
+
+		void TransformHierarchy::setMoved(const Index position) {
+			if (!moved[position]) {
+				moved[position] = true;
+				movedNodes.push_back(nodes[position]);
+			}
+		}
+
+		std::vector<TransformHierarchy::Node> TransformHierarchy::takeNodes(std::vector<Node>& list, const std::vector<Byte>& flags, const Node root) {
+			const Index begin = positions[root], end = begin + subtreeSizes[begin];
+
+			std::vector<Node> taken = std::vector<Node>(), rest = std::vector<Node>();
+			for (const Node node : list) {
+				const Index position = positions[node];
+				//entries that were destroyed or cleared since they were added are dropped
+				if (position == NONE || !flags[position]) {
+					continue;
+				}
+
+				if (position >= begin && position < end) {
+					taken.push_back(node);
+				} else {
+					rest.push_back(node);
+				}
+			}
+			list = std::move(rest);
+
+			std::sort(taken.begin(), taken.end(), [this](const Node first, const Node second) {
+				return positions[first] < positions[second];
+			});
+			taken.erase(std::unique(taken.begin(), taken.end()), taken.end());
+
+			return taken;
+		}
+
+		void TransformHierarchy::updateRange(const Index begin, const Index end, const std::function<void(Entity*, Metrics&)>& callback) {
+			for (Index i = begin; i < end; ++i) {
+				const Index parent = parents[i];
+
+				//the parent of begin isn't part of this update, so whatever it has is already right
+				const bool parentChanged = parent != NONE && parent >= begin && changed[parent];
+				if (!moved[i] && !parentChanged) MACE_LIKELY{
+					changed[i] = false;
+					continue;
+				}
+
+				float inheritedTranslation[3] = {0.0f, 0.0f, 0.0f}, inheritedRotation[3] = {0.0f, 0.0f, 0.0f}, inheritedScaler[3] = {1.0f, 1.0f, 1.0f};
+				if (parent != NONE) {
+					for (Index axis = 0; axis < 3; ++axis) {
+						inheritedTranslation[axis] = transform[parent].translation[axis] + inherited[parent].translation[axis];
+						inheritedRotation[axis] = transform[parent].rotation[axis];
+						inheritedScaler[axis] = transform[parent].scaler[axis];
+					}
+				}
+
+				bool inheritedChanged = moved[i] != 0;
+				for (Index axis = 0; axis < 3; ++axis) {
+					inheritedChanged = inheritedChanged || inheritedTranslation[axis] != inherited[i].translation[axis]
+						|| inheritedRotation[axis] != inherited[i].rotation[axis] || inheritedScaler[axis] != inherited[i].scaler[axis];
+				}
+
+				if (!inheritedChanged) {
+					//the parent moved in a way that doesn't affect this node, so nothing below it changes either
+					changed[i] = false;
+					continue;
+				}
+
+				moved[i] = false;
+				changed[i] = true;
+
+				if (!watched[i]) MACE_LIKELY{
+					for (Index axis = 0; axis < 3; ++axis) {
+						inherited[i].translation[axis] = inheritedTranslation[axis];
+						inherited[i].rotation[axis] = inheritedRotation[axis];
+						inherited[i].scaler[axis] = inheritedScaler[axis];
+						transform[i].translation[axis] = local[i].translation[axis];
+						transform[i].rotation[axis] = local[i].rotation[axis] + inheritedRotation[axis];
+						transform[i].scaler[axis] = local[i].scaler[axis];
+					}
+					continue;
+				}
+
+				Metrics metrics = Metrics();
+				for (Index axis = 0; axis < 3; ++axis) {
+					metrics.inherited.translation[axis] = inheritedTranslation[axis];
+					metrics.inherited.rotation[axis] = inheritedRotation[axis];
+					metrics.inherited.scaler[axis] = inheritedScaler[axis];
+					metrics.transform.translation[axis] = local[i].translation[axis];
+					metrics.transform.rotation[axis] = local[i].rotation[axis] + inheritedRotation[axis];
+					metrics.transform.scaler[axis] = local[i].scaler[axis];
+				}
+
+				callback(owners[i], metrics);
+
+				for (Index axis = 0; axis < 3; ++axis) {
+					transform[i].translation[axis] = metrics.transform.translation[axis];
+					transform[i].rotation[axis] = metrics.transform.rotation[axis];
+					transform[i].scaler[axis] = metrics.transform.scaler[axis];
+					inherited[i].translation[axis] = metrics.inherited.translation[axis];
+					inherited[i].rotation[axis] = metrics.inherited.rotation[axis];
+					inherited[i].scaler[axis] = metrics.inherited.scaler[axis];
+				}
+			}
+		}
+
+		TransformHierarchy& getTransformHierarchy() {
+			//a function static, so Entities that are globals can be constructed before anything else
+			static TransformHierarchy hierarchy;
+
+			return hierarchy;
+		}
+	}//gfx
+}//mc
@@ -403,6 +403,10 @@ namespace mc {
 				glTexImage2D(target, mipmapLevel, internalFormat, width, height, 0, format, type, data);
 			}
 
+			void Texture2D::setSubData(const void* data, GLint x, GLint y, GLsizei width, GLsizei height, Enum type, Enum format, GLint mipmapLevel) {
+				glTexSubImage2D(target, mipmapLevel, x, y, width, height, format, type, data);
+			}
+
 			void Texture2D::setMultisampledData(const GLsizei samples, const GLsizei width, const GLsizei height, const Enum internalFormat, const bool fixedSamples) {
 				glTexImage2DMultisample(target, samples, internalFormat, width, height, fixedSamples);
 			}
@@ -479,11 +483,14 @@ namespace mc {
 			}
 
 			void Buffer::setDataRange(const Index offset, const ptrdiff_t & dataSize, const void* data) {
-				glBufferSubData(GL_UNIFORM_BUFFER, offset, dataSize, data);
+				glBufferSubData(bufferType, offset, dataSize, data);
 			}
 
 			void Buffer::copyData(Buffer & other, const ptrdiff_t & size, const Index readOffset, const Index writeOffset) {
-				glCopyBufferSubData(id, other.id, readOffset, writeOffset, size);
+				//glCopyBufferSubData takes binding targets, not buffer names
+				glBindBuffer(GL_COPY_READ_BUFFER, id);
+				glBindBuffer(GL_COPY_WRITE_BUFFER, other.id);
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, readOffset, writeOffset, size);
 			}
 
 			void* Buffer::map(const Enum access) {
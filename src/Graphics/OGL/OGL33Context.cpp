@@ -285,60 +285,418 @@ namespace mc {
 				}
 			}
 
+			void OGL33Texture::setSubData(const void* data, const unsigned int x, const unsigned int y, const unsigned int width, const unsigned int height, const int mipmap) {
+				ogl33::Texture2D::bind();
+				ogl33::Texture2D::setSubData(data, static_cast<GLint>(x), static_cast<GLint>(y), static_cast<GLsizei>(width), static_cast<GLsizei>(height), getType(desc.type), getFormat(desc.format), mipmap);
+
+				if (desc.minFilter == TextureDesc::Filter::MIPMAP_LINEAR || desc.minFilter == TextureDesc::Filter::MIPMAP_NEAREST) {
+					ogl33::Texture2D::generateMipmap();
+				}
+			}
+
 			void OGL33Texture::readPixels(void* data) const {
 				ogl33::Texture2D::bind();
 				ogl33::Texture2D::getImage(getFormat(desc.format), getType(desc.type), data);
 			}
 
-			void OGL33Model::init() {
-				ogl33::VertexArray::init();
+			bool RangeAllocator::allocate(const Size length, Range& out) {
+				for (auto iter = freeRanges.begin(); iter != freeRanges.end(); ++iter) {
+					if (iter->length >= length) {
+						out.offset = iter->offset;
+						out.length = length;
+
+						if (iter->length == length) {
+							freeRanges.erase(iter);
+						} else {
+							iter->offset += length;
+							iter->length -= length;
+						}
+
+						return true;
+					}
+				}
+
+				return false;
 			}
 
-			void OGL33Model::destroy() {
-				ogl33::VertexArray::destroy();
+			void RangeAllocator::free(const Range& range) {
+				if (range.length == 0) {
+					return;
+				}
+
+#ifdef MACE_DEBUG_CHECK_ARGS
+				if (range.offset + range.length > capacity) {
+					MACE__THROW(OutOfBounds, "Range being freed is outside of the allocator");
+				}
+#endif
+
+				auto next = freeRanges.begin();
+				while (next != freeRanges.end() && next->offset < range.offset) {
+					++next;
+				}
+
+				Range merged = range;
+				if (next != freeRanges.end() && merged.offset + merged.length == next->offset) {
+					merged.length += next->length;
+					next = freeRanges.erase(next);
+				}
+
+				if (next != freeRanges.begin()) {
+					Range& previous = *(next - 1);
+					if (previous.offset + previous.length == merged.offset) {
+						previous.length += merged.length;
+						return;
+					}
+				}
+
+				freeRanges.insert(next, merged);
 			}
 
-			void OGL33Model::bind() const {
-				ogl33::VertexArray::bind();
+			void RangeAllocator::grow(const Size newCapacity) {
+				if (newCapacity <= capacity) {
+					return;
+				}
+
+				Range added{};
+				added.offset = capacity;
+				added.length = newCapacity - capacity;
+				//increase capacity first so free() doesn't think the new range is out of bounds
+				capacity = newCapacity;
+				free(added);
+			}
+
+			Size RangeAllocator::getCapacity() const {
+				return capacity;
+			}
+
+			void RangeAllocator::clear() {
+				freeRanges.clear();
+				capacity = 0;
+			}
+
+			GeometryArena::GeometryArena(const std::vector<Attribute>& form, const Size initialVertices, const Size initialIndices) : format(form) {
+				vertexAllocator.grow(initialVertices);
+				indexAllocator.grow(initialIndices);
+			}
+
+			void GeometryArena::init() {
+				vao.init();
+				vao.bind();
+
+				vertexBuffers.resize(format.size());
+				for (Index i = 0; i < format.size(); ++i) {
+					VertexBuffer& buffer = vertexBuffers[i];
+					buffer.init();
+					buffer.bind();
+					buffer.setLocation(format[i].location);
+					buffer.setData(static_cast<ptrdiff_t>(vertexAllocator.getCapacity() * format[i].components * sizeof(float)), nullptr, GL_DYNAMIC_DRAW);
+					buffer.setAttributePointer(format[i].components, GL_FLOAT);
+					buffer.enable();
+				}
+
+				indexBuffer = ElementBuffer(0);
+				indexBuffer.init();
+				//binding while the vertex array is bound attaches the element buffer to it
+				indexBuffer.bind();
+				indexBuffer.setData(static_cast<ptrdiff_t>(indexAllocator.getCapacity() * sizeof(unsigned int)), nullptr, GL_DYNAMIC_DRAW);
+
+				ogl33::checkGLError(__LINE__, __FILE__, "Error creating GeometryArena");
+			}
+
+			void GeometryArena::destroy() {
+				for (VertexBuffer& buffer : vertexBuffers) {
+					if (buffer.isCreated()) {
+						buffer.destroy();
+					}
+				}
+				vertexBuffers.clear();
+
+				if (indexBuffer.isCreated()) {
+					indexBuffer.destroy();
+				}
+
+				vao.destroy();
+
+				vertexAllocator.clear();
+				indexAllocator.clear();
+			}
+
+			void GeometryArena::bind() const {
+				vao.bind();
+			}
+
+			void GeometryArena::unbind() const {
+				vao.unbind();
+			}
+
+			bool GeometryArena::isCreated() const {
+				return vao.getID() != 0;
+			}
+
+			GeometryArena::Range GeometryArena::allocateVertices(const Size count) {
+				Range out{};
+				if (!vertexAllocator.allocate(count, out)) {
+					growVertices(vertexAllocator.getCapacity() + count);
+					if (!vertexAllocator.allocate(count, out)) MACE_UNLIKELY{
+						MACE__THROW(OutOfMemory, "Internal Error: GeometryArena failed to allocate vertices after growing");
+					}
+				}
+				return out;
+			}
+
+			void GeometryArena::freeVertices(const Range& range) {
+				//the arena may have been destroyed before the models using it
+				if (isCreated()) {
+					vertexAllocator.free(range);
+				}
+			}
+
+			GeometryArena::Range GeometryArena::allocateIndices(const Size count) {
+				Range out{};
+				if (!indexAllocator.allocate(count, out)) {
+					growIndices(indexAllocator.getCapacity() + count);
+					if (!indexAllocator.allocate(count, out)) MACE_UNLIKELY{
+						MACE__THROW(OutOfMemory, "Internal Error: GeometryArena failed to allocate indices after growing");
+					}
+				}
+				return out;
+			}
+
+			void GeometryArena::freeIndices(const Range& range) {
+				if (isCreated()) {
+					indexAllocator.free(range);
+				}
+			}
+
+			void GeometryArena::setVertexData(const Index attribute, const Range& range, const float* data) {
+#ifdef MACE_DEBUG_CHECK_ARGS
+				if (attribute >= format.size()) {
+					MACE__THROW(OutOfBounds, "Attribute " + std::to_string(attribute) + " does not exist in this GeometryArena");
+				}
+#endif
+
+				const Size stride = format[attribute].components * sizeof(float);
+				vertexBuffers[attribute].bind();
+				vertexBuffers[attribute].setDataRange(range.offset * stride, static_cast<ptrdiff_t>(range.length * stride), data);
+			}
+
+			void GeometryArena::setIndexData(const Range& range, const unsigned int* data) {
+				//GL_ELEMENT_ARRAY_BUFFER binding is part of the vertex array state
+				bind();
+				indexBuffer.bind();
+				indexBuffer.setDataRange(range.offset * sizeof(unsigned int), static_cast<ptrdiff_t>(range.length * sizeof(unsigned int)), data);
+			}
+
+			void GeometryArena::multiDraw(const std::vector<const OGL33Model*>& models) const {
+				if (models.empty()) {
+					return;
+				}
+
+				const PrimitiveType primitive = models.front()->primitiveType;
+				const bool indexed = models.front()->indices.length > 0;
+
+				std::vector<GLsizei> counts = std::vector<GLsizei>();
+				std::vector<GLint> firsts = std::vector<GLint>();
+				std::vector<const GLvoid*> offsets = std::vector<const GLvoid*>();
+				counts.reserve(models.size());
+				firsts.reserve(models.size());
+				if (indexed) {
+					offsets.reserve(models.size());
+				}
 
-				for (Index i = 0; i < buffers.size(); ++i) {
-					buffers[i].bind();
+				for (const OGL33Model* model : models) {
+#ifdef MACE_DEBUG_CHECK_ARGS
+					if (model->arena.get() != this) {
+						MACE__THROW(InvalidState, "Model passed to GeometryArena::multiDraw() belongs to a different arena");
+					} else if (model->primitiveType != primitive) {
+						MACE__THROW(InvalidState, "All models passed to GeometryArena::multiDraw() must have the same PrimitiveType");
+					} else if ((model->indices.length > 0) != indexed) {
+						MACE__THROW(InvalidState, "GeometryArena::multiDraw() can not mix models with and without indices");
+					}
+#endif
+
+					firsts.push_back(static_cast<GLint>(model->vertices.offset));
+					if (indexed) {
+						counts.push_back(static_cast<GLsizei>(model->indices.length));
+						offsets.push_back(reinterpret_cast<const GLvoid*>(model->indices.offset * sizeof(unsigned int)));
+					} else {
+						counts.push_back(static_cast<GLsizei>(model->vertices.length));
+					}
 				}
 
-				if (indices.getIndiceNumber() > 0) {
-					indices.bind();
+				bind();
+
+				if (indexed) {
+					glMultiDrawElementsBaseVertex(lookupPrimitiveType(primitive), counts.data(), GL_UNSIGNED_INT, offsets.data(), static_cast<GLsizei>(models.size()), firsts.data());
+				} else {
+					glMultiDrawArrays(lookupPrimitiveType(primitive), firsts.data(), counts.data(), static_cast<GLsizei>(models.size()));
 				}
 			}
 
+			const std::vector<GeometryArena::Attribute>& GeometryArena::getFormat() const {
+				return format;
+			}
+
+			void GeometryArena::growVertices(const Size minimumCapacity) {
+				const Size oldCapacity = vertexAllocator.getCapacity();
+				const Size newCapacity = std::max(oldCapacity * 2, minimumCapacity);
+
+				bind();
+
+				for (Index i = 0; i < format.size(); ++i) {
+					const Size stride = format[i].components * sizeof(float);
+
+					VertexBuffer buffer = VertexBuffer();
+					buffer.init();
+					buffer.bind();
+					buffer.setLocation(format[i].location);
+					buffer.setData(static_cast<ptrdiff_t>(newCapacity * stride), nullptr, GL_DYNAMIC_DRAW);
+
+					vertexBuffers[i].copyData(buffer, static_cast<ptrdiff_t>(oldCapacity * stride));
+					vertexBuffers[i].destroy();
+
+					//the attribute pointer captures whichever buffer is bound to GL_ARRAY_BUFFER
+					buffer.bind();
+					buffer.setAttributePointer(format[i].components, GL_FLOAT);
+					buffer.enable();
+
+					vertexBuffers[i] = buffer;
+				}
+
+				vertexAllocator.grow(newCapacity);
+
+				ogl33::checkGLError(__LINE__, __FILE__, "Error growing vertices in GeometryArena");
+			}
+
+			void GeometryArena::growIndices(const Size minimumCapacity) {
+				const Size oldCapacity = indexAllocator.getCapacity();
+				const Size newCapacity = std::max(oldCapacity * 2, minimumCapacity);
+
+				bind();
+
+				ElementBuffer buffer = ElementBuffer(0);
+				buffer.init();
+				buffer.bind();
+				buffer.setData(static_cast<ptrdiff_t>(newCapacity * sizeof(unsigned int)), nullptr, GL_DYNAMIC_DRAW);
+
+				indexBuffer.copyData(buffer, static_cast<ptrdiff_t>(oldCapacity * sizeof(unsigned int)));
+				indexBuffer.destroy();
+
+				//rebind so the vertex array references the new element buffer
+				buffer.bind();
+				indexBuffer = buffer;
+
+				indexAllocator.grow(newCapacity);
+
+				ogl33::checkGLError(__LINE__, __FILE__, "Error growing indices in GeometryArena");
+			}
+
+			OGL33Model::OGL33Model(const std::shared_ptr<GeometryArena>& geometry) : arena(geometry) {}
+
+			OGL33Model::~OGL33Model() noexcept {
+				if (created) {
+					arena->freeVertices(vertices);
+					arena->freeIndices(indices);
+				}
+			}
+
+			void OGL33Model::init() {
+#ifdef MACE_DEBUG_INTERNAL_ERRORS
+				if (arena == nullptr || !arena->isCreated()) {
+					MACE__THROW(InvalidState, "Internal Error: OGL33Model has no GeometryArena");
+				}
+#endif
+
+				created = true;
+			}
+
+			void OGL33Model::destroy() {
+				arena->freeVertices(vertices);
+				arena->freeIndices(indices);
+
+				vertices = GeometryArena::Range();
+				indices = GeometryArena::Range();
+
+				created = false;
+			}
+
+			void OGL33Model::bind() const {
+				arena->bind();
+			}
+
 			void OGL33Model::unbind() const {
-				ogl33::VertexArray::unbind();
+				arena->unbind();
 			}
 
 			void OGL33Model::draw() const {
-				if (indices.getIndiceNumber() > 0) {
-					glDrawElements(lookupPrimitiveType(primitiveType), indices.getIndiceNumber(), GL_UNSIGNED_INT, nullptr);
+				if (indices.length > 0) {
+					glDrawElementsBaseVertex(lookupPrimitiveType(primitiveType), static_cast<GLsizei>(indices.length), GL_UNSIGNED_INT, reinterpret_cast<const GLvoid*>(indices.offset * sizeof(unsigned int)), static_cast<GLint>(vertices.offset));
 				} else {
-					glDrawArrays(lookupPrimitiveType(primitiveType), 0, getVertexNumber());
+					glDrawArrays(lookupPrimitiveType(primitiveType), static_cast<GLint>(vertices.offset), static_cast<GLsizei>(vertices.length));
 				}
 			}
 
 			void OGL33Model::loadTextureCoordinates(const unsigned int dataSize, const float* data) {
-				ogl33::VertexArray::storeDataInAttributeList(dataSize * sizeof(float), data, MACE__VAO_DEFAULT_TEXTURE_COORD_LOCATION, 2);
+				const Size count = dataSize / 2;
+				if (vertices.length == 0) {
+					reserveVertices(count);
+				}
+#ifdef MACE_DEBUG_CHECK_ARGS
+				else if (count != vertices.length) {
+					MACE__THROW(OutOfBounds, "Amount of texture coordinates must match the amount of vertices");
+				}
+#endif
+
+				//attribute 1 in the format is MACE__VAO_DEFAULT_TEXTURE_COORD_LOCATION
+				arena->setVertexData(1, vertices, data);
 			}
 
-			void OGL33Model::loadVertices(const unsigned int verticeSize, const float* vertices) {
-				ogl33::VertexArray::loadVertices(verticeSize, vertices, MACE__VAO_DEFAULT_VERTICES_LOCATION, 3);
+			void OGL33Model::loadVertices(const unsigned int verticeSize, const float* data) {
+				reserveVertices(verticeSize / 3);
+
+				arena->setVertexData(0, vertices, data);
 			}
 
 			void OGL33Model::loadIndices(const unsigned int indiceNum, const unsigned int* indiceData) {
-				ogl33::VertexArray::loadIndices(indiceNum, indiceData);
+				if (indices.length != indiceNum) {
+					arena->freeIndices(indices);
+					indices = arena->allocateIndices(indiceNum);
+				}
+
+				arena->setIndexData(indices, indiceData);
 			}
 
 			bool OGL33Model::isCreated() const {
-				return ogl33::VertexArray::isCreated();
+				return created && arena->isCreated();
+			}
+
+			const GeometryArena::Range& OGL33Model::getVertexRange() const {
+				return vertices;
+			}
+
+			const GeometryArena::Range& OGL33Model::getIndexRange() const {
+				return indices;
+			}
+
+			const GeometryArena* OGL33Model::getArena() const {
+				return arena.get();
+			}
+
+			void OGL33Model::reserveVertices(const Size count) {
+				//texture coordinates loaded before this are lost if the amount of vertices changes
+				if (vertices.length != count) {
+					arena->freeVertices(vertices);
+					vertices = arena->allocateVertices(count);
+				}
 			}
 
 			void OGL33Context::onInit(gfx::WindowModule*) {
+				geometry = std::shared_ptr<GeometryArena>(new GeometryArena({
+					{MACE__VAO_DEFAULT_VERTICES_LOCATION, 3},
+					{MACE__VAO_DEFAULT_TEXTURE_COORD_LOCATION, 2}
+				}));
+				geometry->init();
+
 				renderer = std::unique_ptr<Renderer>(new OGL33Renderer());
 			}
 
@@ -346,6 +704,10 @@ namespace mc {
 
 			void OGL33Context::onDestroy(gfx::WindowModule*) {
 				renderer.reset();
+
+				//models may outlive the context, so they keep the arena alive but its storage is released here
+				geometry->destroy();
+				geometry.reset();
 			}
 
 			OGL33Context::OGL33Context(gfx::WindowModule * win) : GraphicsContext(win) {}
@@ -355,7 +717,7 @@ namespace mc {
 			}
 
 			std::shared_ptr<ModelImpl> OGL33Context::createModelImpl() const {
-				return std::unique_ptr<ModelImpl>(new OGL33Model());
+				return std::unique_ptr<ModelImpl>(new OGL33Model(geometry));
 			}
 
 			std::shared_ptr<TextureImpl> OGL33Context::createTextureImpl(const TextureDesc & desc) const {
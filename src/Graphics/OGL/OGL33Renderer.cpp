@@ -12,7 +12,9 @@ See LICENSE.md for full copyright information
 #endif 
 
 #define MACE_EXPOSE_GLFW
+#define MACE_EXPOSE_OPENGL
 #include <MACE/Graphics/OGL/OGL33Renderer.h>
+#include <MACE/Graphics/OGL/OGL33Context.h>
 #include <MACE/Graphics/Context.h>
 #include <MACE/Core/System.h>
 
@@ -55,7 +57,9 @@ namespace mc {
 #define MACE__HAS_RENDER_FEATURE(features, feature) (features & Painter::RenderFeatures::feature) != Painter::RenderFeatures::NONE
 
 			namespace {
-				Shader createShader(const Enum type, const Painter::RenderFeatures features, const char* source) {
+				Shader createShader(const Enum type, const std::pair<Painter::Brush, Painter::RenderFeatures>& settings, const char* source) {
+					const Painter::RenderFeatures features = settings.second;
+
 					Shader s = Shader(type);
 					s.init();
 #define MACE__SHADER_MACRO(name, def) "#define " #name " " MACE_STRINGIFY_DEFINITION(def) "\n"
@@ -69,6 +73,14 @@ namespace mc {
 						MACE__SHADER_MACRO(MACE_DATA_ATTACHMENT_INDEX, MACE__DATA_ATTACHMENT_INDEX),
 						MACE__SHADER_MACRO(MACE_VAO_DEFAULT_VERTICES_LOCATION, MACE__VAO_DEFAULT_VERTICES_LOCATION),
 						MACE__SHADER_MACRO(MACE_VAO_DEFAULT_TEXTURE_COORD_LOCATION, MACE__VAO_DEFAULT_TEXTURE_COORD_LOCATION),
+						MACE__SHADER_MACRO(MACE_VAO_INSTANCE_X_LOCATION, MACE__VAO_INSTANCE_X_LOCATION),
+						MACE__SHADER_MACRO(MACE_VAO_INSTANCE_Y_LOCATION, MACE__VAO_INSTANCE_Y_LOCATION),
+						MACE__SHADER_MACRO(MACE_VAO_INSTANCE_SIZE_LOCATION, MACE__VAO_INSTANCE_SIZE_LOCATION),
+						MACE__SHADER_MACRO(MACE_VAO_INSTANCE_ROTATION_LOCATION, MACE__VAO_INSTANCE_ROTATION_LOCATION),
+						MACE__SHADER_MACRO(MACE_VAO_INSTANCE_RED_LOCATION, MACE__VAO_INSTANCE_RED_LOCATION),
+						MACE__SHADER_MACRO(MACE_VAO_INSTANCE_GREEN_LOCATION, MACE__VAO_INSTANCE_GREEN_LOCATION),
+						MACE__SHADER_MACRO(MACE_VAO_INSTANCE_BLUE_LOCATION, MACE__VAO_INSTANCE_BLUE_LOCATION),
+						MACE__SHADER_MACRO(MACE_VAO_INSTANCE_ALPHA_LOCATION, MACE__VAO_INSTANCE_ALPHA_LOCATION),
 #include <MACE/Graphics/OGL/Shaders/Shared.glsl>
 																				});
 #undef MACE__SHADER_MACRO
@@ -84,6 +96,11 @@ namespace mc {
 					MACE__SHADER_RENDER_FEATURE(STORE_ID);
 #undef MACE__SHADER_RENDER_FEATURE
 
+					if (settings.first == Painter::Brush::PARTICLE) {
+						//vertices are generated from gl_VertexID instead of being read from a Model
+						sources.insert(sources.begin(), "#define MACE_INSTANCED 1\n");
+					}
+
 					sources.insert(sources.begin(), "#version 330 core\n");
 
 					if (type == GL_VERTEX_SHADER) {
@@ -112,18 +129,24 @@ namespace mc {
 
 					ogl33::checkGLError(__LINE__, __FILE__, "Internal Error: Error initializing ShaderProgram");
 
-					program.attachShader(createShader(GL_VERTEX_SHADER, settings.second,
+					if (settings.first == Painter::Brush::PARTICLE) {
+						program.attachShader(createShader(GL_VERTEX_SHADER, settings,
+#							include <MACE/Graphics/OGL/Shaders/RenderTypes/instanced_quad.v.glsl>
+						));
+					} else {
+						program.attachShader(createShader(GL_VERTEX_SHADER, settings,
 #							include <MACE/Graphics/OGL/Shaders/RenderTypes/standard.v.glsl>
-					));
+						));
+					}
 
 					if (settings.first == Painter::Brush::COLOR) {
-						program.attachShader(createShader(GL_FRAGMENT_SHADER, settings.second,
+						program.attachShader(createShader(GL_FRAGMENT_SHADER, settings,
 #							include <MACE/Graphics/OGL/Shaders/Brushes/color.f.glsl>
 						));
 
 						program.link();
 					} else if (settings.first == Painter::Brush::TEXTURE) {
-						program.attachShader(createShader(GL_FRAGMENT_SHADER, settings.second,
+						program.attachShader(createShader(GL_FRAGMENT_SHADER, settings,
 #							include <MACE/Graphics/OGL/Shaders/Brushes/texture.f.glsl>
 						));
 
@@ -135,7 +158,7 @@ namespace mc {
 
 						program.setUniform("tex", static_cast<int>(TextureSlot::FOREGROUND));
 					} else if (settings.first == Painter::Brush::MASK) {
-						program.attachShader(createShader(GL_FRAGMENT_SHADER, settings.second,
+						program.attachShader(createShader(GL_FRAGMENT_SHADER, settings,
 #							include <MACE/Graphics/OGL/Shaders/Brushes/mask.f.glsl>
 						));
 
@@ -150,7 +173,7 @@ namespace mc {
 						program.setUniform("tex", static_cast<int>(TextureSlot::FOREGROUND));
 						program.setUniform("mask", static_cast<int>(TextureSlot::MASK));
 					} else if (settings.first == Painter::Brush::MASK) {
-						program.attachShader(createShader(GL_FRAGMENT_SHADER, settings.second,
+						program.attachShader(createShader(GL_FRAGMENT_SHADER, settings,
 #							include <MACE/Graphics/OGL/Shaders/Brushes/mask.f.glsl>
 						));
 
@@ -165,7 +188,7 @@ namespace mc {
 						program.setUniform("tex", static_cast<int>(TextureSlot::FOREGROUND));
 						program.setUniform("mask", static_cast<int>(TextureSlot::MASK));
 					} else if (settings.first == Painter::Brush::BLEND) {
-						program.attachShader(createShader(GL_FRAGMENT_SHADER, settings.second,
+						program.attachShader(createShader(GL_FRAGMENT_SHADER, settings,
 #							include <MACE/Graphics/OGL/Shaders/Brushes/blend.f.glsl>
 						));
 
@@ -179,7 +202,7 @@ namespace mc {
 						program.setUniform("tex1", static_cast<int>(TextureSlot::FOREGROUND));
 						program.setUniform("tex2", static_cast<int>(TextureSlot::BACKGROUND));
 					} else if (settings.first == Painter::Brush::CONDITIONAL_MASK) {
-						program.attachShader(createShader(GL_FRAGMENT_SHADER, settings.second,
+						program.attachShader(createShader(GL_FRAGMENT_SHADER, settings,
 #							include <MACE/Graphics/OGL/Shaders/Brushes/conditional_mask.f.glsl>
 						));
 
@@ -196,7 +219,7 @@ namespace mc {
 						program.setUniform("tex2", static_cast<int>(TextureSlot::BACKGROUND));
 						program.setUniform("mask", static_cast<int>(TextureSlot::MASK));
 					} else if (settings.first == Painter::Brush::MULTICOMPONENT_BLEND) {
-						program.attachShader(createShader(GL_FRAGMENT_SHADER, settings.second,
+						program.attachShader(createShader(GL_FRAGMENT_SHADER, settings,
 #							include <MACE/Graphics/OGL/Shaders/Brushes/multicomponent_blend.f.glsl>
 						));
 
@@ -214,6 +237,38 @@ namespace mc {
 						prot.destBlend = GL_ONE_MINUS_SRC1_COLOR;
 
 						prot.multitarget = false;
+					} else if (settings.first == Painter::Brush::PATH) {
+						program.attachShader(createShader(GL_FRAGMENT_SHADER, settings,
+#							include <MACE/Graphics/OGL/Shaders/Brushes/path.f.glsl>
+						));
+
+						program.link();
+					} else if (settings.first == Painter::Brush::PARTICLE) {
+						program.attachShader(createShader(GL_FRAGMENT_SHADER, settings,
+#							include <MACE/Graphics/OGL/Shaders/Brushes/particle.f.glsl>
+						));
+
+						program.link();
+
+						program.bind();
+
+						program.createUniform("tex");
+
+						program.setUniform("tex", static_cast<int>(TextureSlot::FOREGROUND));
+					} else if (settings.first == Painter::Brush::DISTANCE_FIELD) {
+						program.attachShader(createShader(GL_FRAGMENT_SHADER, settings,
+#							include <MACE/Graphics/OGL/Shaders/Brushes/distance_field.f.glsl>
+						));
+
+						program.link();
+
+						program.bind();
+
+						program.createUniform("tex1");
+						program.createUniform("tex2");
+
+						program.setUniform("tex1", static_cast<int>(TextureSlot::FOREGROUND));
+						program.setUniform("tex2", static_cast<int>(TextureSlot::BACKGROUND));
 					} else MACE_UNLIKELY{
 						MACE__THROW(BadFormat, "OpenGL 3.3 Renderer: Unsupported brush type: " + std::to_string(static_cast<unsigned int>(settings.first)));
 					}
@@ -698,6 +753,12 @@ namespace mc {
 				};
 
 				UniformBuffer::destroy(buffers, 2);
+
+				if (instanceArray.isCreated()) {
+					instanceBuffer.destroy();
+					instanceArray.destroy();
+					instanceCapacity = 0;
+				}
 			}
 
 			void OGL33Painter::begin() {
@@ -777,6 +838,96 @@ namespace mc {
 
 				checkGLError(__LINE__, __FILE__, "Internal Error: An error occured while drawing a model");
 			}
+
+			void OGL33Painter::drawModels(const std::vector<const Model*>& models, const Painter::Brush brush) {
+				renderer->bindProtocol(this, {brush, savedState.renderFeatures});
+
+				//consecutive models that can share a glMultiDraw call are batched together
+				std::vector<const OGL33Model*> batch = std::vector<const OGL33Model*>();
+				batch.reserve(models.size());
+
+				const auto flush = [&batch]() {
+					if (batch.size() == 1) {
+						batch.front()->bind();
+						batch.front()->draw();
+					} else if (!batch.empty()) {
+						batch.front()->getArena()->multiDraw(batch);
+					}
+
+					batch.clear();
+				};
+
+				PrimitiveType primitive = PrimitiveType::TRIANGLES;
+				for (const Model* m : models) {
+					const OGL33Model* model = static_cast<const OGL33Model*>(m->getImpl().get());
+#ifdef MACE_DEBUG_CHECK_NULLPTR
+					if (model == nullptr) {
+						MACE__THROW(NullPointer, "drawModels: Model has not had init() called yet");
+					}
+#endif
+
+					if (!batch.empty()) {
+						const OGL33Model* front = batch.front();
+						if (front->getArena() != model->getArena() || m->getPrimitiveType() != primitive
+							|| (front->getIndexRange().length > 0) != (model->getIndexRange().length > 0)) {
+							flush();
+						}
+					}
+
+					if (batch.empty()) {
+						primitive = m->getPrimitiveType();
+					}
+
+					batch.push_back(model);
+				}
+
+				flush();
+
+				checkGLError(__LINE__, __FILE__, "Internal Error: An error occured while drawing models");
+			}
+
+			void OGL33Painter::drawQuadInstances(const Painter::QuadInstances & instances) {
+				if (!instanceArray.isCreated()) {
+					instanceArray.init();
+					instanceBuffer.init();
+				}
+
+				instanceArray.bind();
+
+				instanceBuffer.bind();
+
+				if (instances.count > instanceCapacity) {
+					instanceCapacity = std::max(instances.count, instanceCapacity * 2);
+
+					instanceBuffer.setData(static_cast<ptrdiff_t>(instanceCapacity * MACE__VAO_INSTANCE_ATTRIBUTE_COUNT * sizeof(float)), nullptr, GL_STREAM_DRAW);
+
+					//every attribute is a separate array in the same buffer, so the offsets change whenever it grows
+					for (GLuint i = 0; i < MACE__VAO_INSTANCE_ATTRIBUTE_COUNT; ++i) {
+						instanceBuffer.setLocation(MACE__VAO_INSTANCE_X_LOCATION + i);
+						instanceBuffer.setAttributePointer(1, GL_FLOAT, false, 0, reinterpret_cast<const void*>(i * instanceCapacity * sizeof(float)));
+						instanceBuffer.setDivisor(1);
+						instanceBuffer.enable();
+					}
+				} else {
+					//orphaning the buffer means we don't have to wait for the GPU to finish with the last frame's instances
+					instanceBuffer.setData(static_cast<ptrdiff_t>(instanceCapacity * MACE__VAO_INSTANCE_ATTRIBUTE_COUNT * sizeof(float)), nullptr, GL_STREAM_DRAW);
+				}
+
+				const float* attributes[MACE__VAO_INSTANCE_ATTRIBUTE_COUNT] = {
+					instances.x, instances.y, instances.size, instances.rotation,
+					instances.red, instances.green, instances.blue, instances.alpha
+				};
+
+				for (Index i = 0; i < MACE__VAO_INSTANCE_ATTRIBUTE_COUNT; ++i) {
+					instanceBuffer.setDataRange(i * instanceCapacity * sizeof(float), static_cast<ptrdiff_t>(instances.count * sizeof(float)), attributes[i]);
+				}
+
+				renderer->bindProtocol(this, {Painter::Brush::PARTICLE, savedState.renderFeatures});
+
+				glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(instances.count));
+
+				checkGLError(__LINE__, __FILE__, "Internal Error: An error occured while drawing quad instances");
+			}
 		}//ogl33
 	}//gfx
 }//mc
@@ -0,0 +1,476 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <MACE/Graphics/Particles.h>
+#include <MACE/Core/Jobs.h>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#ifdef MACE_SSE
+#	include <emmintrin.h>
+#endif
+
+//updates can be far apart when the window is dragged or the program stalls. clamping the step stops particles from teleporting
+#define MACE__PARTICLE_MAX_TIMESTEP 0.1f
+//smallest amount of particles handed to each thread. below this, starting the threads costs more than simulating
+#define MACE__PARTICLE_THREAD_BATCH 8192
+
+namespace mc {
+	namespace gfx {
+		namespace {
+			inline float interpolate(const float a, const float b, const float t) {
+				return a + (b - a) * t;
+			}
+
+			inline Color interpolate(const Color& a, const Color& b, const float t) {
+				return Color(interpolate(a.r, b.r, t), interpolate(a.g, b.g, t), interpolate(a.b, b.b, t), interpolate(a.a, b.a, t));
+			}
+
+			inline Size roundToSimdWidth(const Size count) {
+				return (count + 3) & ~static_cast<Size>(3);
+			}
+		}//anon namespace
+
+		template<typename T>
+		ParticleCurve<T>::ParticleCurve(std::initializer_list<std::pair<float, T>> keyframes) : keys(keyframes) {
+#ifdef MACE_DEBUG_CHECK_ARGS
+			if (keys.empty()) {
+				MACE__THROW(OutOfBounds, "A ParticleCurve must have at least 1 key");
+			}
+#endif
+
+			bake();
+		}
+
+		template<typename T>
+		void ParticleCurve<T>::addKey(const float time, const T& value) {
+			keys.push_back({time, value});
+
+			bake();
+		}
+
+		template<typename T>
+		const std::vector<std::pair<float, T>>& ParticleCurve<T>::getKeys() const {
+			return keys;
+		}
+
+		template<typename T>
+		void ParticleCurve<T>::bake() {
+			std::stable_sort(keys.begin(), keys.end(), [](const std::pair<float, T>& left, const std::pair<float, T>& right) {
+				return left.first < right.first;
+			});
+
+			Index key = 0;
+			for (Index i = 0; i < MACE__PARTICLE_CURVE_RESOLUTION; ++i) {
+				const float time = static_cast<float>(i) / static_cast<float>(MACE__PARTICLE_CURVE_RESOLUTION - 1);
+
+				while (key + 1 < keys.size() && keys[key + 1].first <= time) {
+					++key;
+				}
+
+				if (time <= keys[key].first || key + 1 >= keys.size()) {
+					table[i] = keys[key].second;
+				} else {
+					const std::pair<float, T>& from = keys[key], &to = keys[key + 1];
+					table[i] = interpolate(from.second, to.second, (time - from.first) / (to.first - from.first));
+				}
+			}
+		}
+
+		template class ParticleCurve<float>;
+		template class ParticleCurve<Color>;
+
+		ParticleSystem::ParticleSystem(const Size max) : texture(), maxParticles(max) {
+			resizeStorage();
+		}
+
+		void ParticleSystem::setTexture(const Texture& tex) {
+			if (tex != texture) {
+				makeDirty();
+
+				texture = tex;
+			}
+		}
+
+		Texture& ParticleSystem::getTexture() {
+			makeDirty();
+
+			return texture;
+		}
+
+		const Texture& ParticleSystem::getTexture() const {
+			return texture;
+		}
+
+		Index ParticleSystem::addEmitter(const ParticleEmitter& emitter) {
+			emitters.push_back(emitter);
+			emitterAccumulators.push_back(0.0f);
+
+			return emitters.size() - 1;
+		}
+
+		ParticleEmitter& ParticleSystem::getEmitter(const Index i) {
+#ifdef MACE_DEBUG_CHECK_ARGS
+			if (i >= emitters.size()) {
+				MACE__THROW(OutOfBounds, std::to_string(i) + " is not a valid emitter index");
+			}
+#endif
+
+			return emitters[i];
+		}
+
+		const ParticleEmitter& ParticleSystem::getEmitter(const Index i) const {
+#ifdef MACE_DEBUG_CHECK_ARGS
+			if (i >= emitters.size()) {
+				MACE__THROW(OutOfBounds, std::to_string(i) + " is not a valid emitter index");
+			}
+#endif
+
+			return emitters[i];
+		}
+
+		std::vector<ParticleEmitter>& ParticleSystem::getEmitters() {
+			return emitters;
+		}
+
+		const std::vector<ParticleEmitter>& ParticleSystem::getEmitters() const {
+			return emitters;
+		}
+
+		void ParticleSystem::setSizeCurve(const ParticleCurve<float>& curve) {
+			sizeCurve = curve;
+		}
+
+		const ParticleCurve<float>& ParticleSystem::getSizeCurve() const {
+			return sizeCurve;
+		}
+
+		void ParticleSystem::setColorCurve(const ParticleCurve<Color>& curve) {
+			colorCurve = curve;
+		}
+
+		const ParticleCurve<Color>& ParticleSystem::getColorCurve() const {
+			return colorCurve;
+		}
+
+		void ParticleSystem::setGravity(const Vector<float, 2>& grav) {
+			gravity = grav;
+		}
+
+		const Vector<float, 2>& ParticleSystem::getGravity() const {
+			return gravity;
+		}
+
+		void ParticleSystem::setDrag(const float d) {
+			drag = math::clamp(d, 0.0f, 1.0f);
+		}
+
+		float ParticleSystem::getDrag() const {
+			return drag;
+		}
+
+		void ParticleSystem::setMaxParticles(const Size max) {
+			maxParticles = max;
+			particleCount = std::min(particleCount, maxParticles);
+
+			resizeStorage();
+		}
+
+		Size ParticleSystem::getMaxParticles() const {
+			return maxParticles;
+		}
+
+		void ParticleSystem::setThreadCount(const unsigned int threads) {
+			threadCount = std::max(threads, 1u);
+		}
+
+		unsigned int ParticleSystem::getThreadCount() const {
+			return threadCount;
+		}
+
+		Size ParticleSystem::getParticleCount() const {
+			return particleCount;
+		}
+
+		void ParticleSystem::clearParticles() {
+			if (particleCount > 0) {
+				particleCount = 0;
+				publishInstances();
+
+				makeDirty();
+			}
+		}
+
+		void ParticleSystem::simulate(const float delta) {
+			const float step = math::clamp(delta, 0.0f, MACE__PARTICLE_MAX_TIMESTEP);
+
+			removeDeadParticles(step);
+
+			//only split the work if each thread gets a full batch
+			const Size batches = std::min(static_cast<Size>(threadCount), particleCount / MACE__PARTICLE_THREAD_BATCH);
+			if (batches > 1) {
+				const Size batchSize = roundToSimdWidth(particleCount / batches);
+
+				JobSystem* const jobs = JobSystem::getCurrent();
+				if (jobs != nullptr) {
+					//the workers are shared with everything else, so the machine isn't oversubscribed
+					jobs->parallelFor(0, particleCount, batchSize, [this, step](const Index begin, const Index end) {
+						simulateRange(begin, end, step);
+					});
+				} else {
+					std::vector<std::thread> workers = std::vector<std::thread>();
+					workers.reserve(batches - 1);
+					for (Index i = 1; i < batches; ++i) {
+						const Index begin = batchSize * i, end = i == batches - 1 ? particleCount : batchSize * (i + 1);
+						workers.emplace_back(&ParticleSystem::simulateRange, this, begin, end, step);
+					}
+
+					simulateRange(0, batchSize, step);
+
+					for (std::thread& worker : workers) {
+						worker.join();
+					}
+				}
+			} else {
+				simulateRange(0, particleCount, step);
+			}
+
+			emitParticles(step);
+		}
+
+		void ParticleSystem::onInit() {
+			lastUpdate = std::chrono::steady_clock::now();
+		}
+
+		void ParticleSystem::onUpdate() {
+			const auto now = std::chrono::steady_clock::now();
+			const float delta = std::chrono::duration<float>(now - lastUpdate).count();
+			lastUpdate = now;
+
+			const bool wasEmpty = particleCount == 0;
+
+			simulate(delta);
+
+			//an empty system only has to be redrawn once, to clear out the last particles
+			if (particleCount > 0 || !wasEmpty) {
+				publishInstances();
+
+				makeDirty();
+			}
+		}
+
+		void ParticleSystem::onRender(Painter& p) {
+			//held until the instances are uploaded, so the update thread can't swap them out in the middle
+			const std::unique_lock<std::mutex> guard(sharedInstances.mutex);
+
+			const Instances& shared = sharedInstances.instances;
+			if (shared.count == 0) {
+				return;
+			}
+
+			p.setTexture(texture.isCreated() ? texture : Texture::getSolidColor(), TextureSlot::FOREGROUND);
+
+			Painter::QuadInstances instances = Painter::QuadInstances();
+			instances.x = shared.x.data();
+			instances.y = shared.y.data();
+			instances.size = shared.size.data();
+			instances.rotation = shared.rotation.data();
+			instances.red = shared.red.data();
+			instances.green = shared.green.data();
+			instances.blue = shared.blue.data();
+			instances.alpha = shared.alpha.data();
+			instances.count = shared.count;
+
+			p.drawQuadInstances(instances);
+		}
+
+		void ParticleSystem::onDestroy() {
+			if (texture.isCreated()) {
+				texture.destroy();
+			}
+		}
+
+		void ParticleSystem::onClean() {}
+
+		void ParticleSystem::publishInstances() {
+			const std::vector<float>* sources[] = {
+				&particles.x, &particles.y, &particles.size, &particles.rotation,
+				&particles.red, &particles.green, &particles.blue, &particles.alpha
+			};
+			std::vector<float>* destinations[] = {
+				&stagedInstances.x, &stagedInstances.y, &stagedInstances.size, &stagedInstances.rotation,
+				&stagedInstances.red, &stagedInstances.green, &stagedInstances.blue, &stagedInstances.alpha
+			};
+
+			//assign() reuses the capacity from earlier updates, so this only allocates when the system grows
+			for (Index i = 0; i < 8; ++i) {
+				destinations[i]->assign(sources[i]->begin(), sources[i]->begin() + static_cast<std::ptrdiff_t>(particleCount));
+			}
+			stagedInstances.count = particleCount;
+
+			const std::unique_lock<std::mutex> guard(sharedInstances.mutex);
+			std::swap(stagedInstances, sharedInstances.instances);
+		}
+
+		ParticleSystem::SharedInstances::SharedInstances(const SharedInstances& other) {
+			const std::unique_lock<std::mutex> guard(other.mutex);
+			instances = other.instances;
+		}
+
+		ParticleSystem::SharedInstances& ParticleSystem::SharedInstances::operator=(const SharedInstances& other) {
+			if (this != &other) {
+				std::lock(mutex, other.mutex);
+				const std::unique_lock<std::mutex> guard(mutex, std::adopt_lock), otherGuard(other.mutex, std::adopt_lock);
+				instances = other.instances;
+			}
+			return *this;
+		}
+
+		void ParticleSystem::resizeStorage() {
+			const Size capacity = roundToSimdWidth(maxParticles);
+
+			std::vector<float>* arrays[] = {
+				&particles.x, &particles.y, &particles.velocityX, &particles.velocityY, &particles.rotation, &particles.spin,
+				&particles.life, &particles.lifeRate, &particles.baseSize,
+				&particles.size, &particles.red, &particles.green, &particles.blue, &particles.alpha
+			};
+
+			for (std::vector<float>* array : arrays) {
+				array->resize(capacity, 0.0f);
+			}
+		}
+
+		void ParticleSystem::removeDeadParticles(const float delta) {
+			for (Index i = 0; i < particleCount;) {
+				if (particles.life[i] + particles.lifeRate[i] * delta < 1.0f) {
+					++i;
+					continue;
+				}
+
+				//order doesn't matter, so move the last particle into this slot
+				const Index last = --particleCount;
+				if (i != last) {
+					particles.x[i] = particles.x[last];
+					particles.y[i] = particles.y[last];
+					particles.velocityX[i] = particles.velocityX[last];
+					particles.velocityY[i] = particles.velocityY[last];
+					particles.rotation[i] = particles.rotation[last];
+					particles.spin[i] = particles.spin[last];
+					particles.life[i] = particles.life[last];
+					particles.lifeRate[i] = particles.lifeRate[last];
+					particles.baseSize[i] = particles.baseSize[last];
+				}
+			}
+		}
+
+		void ParticleSystem::simulateRange(const Index begin, const Index end, const float delta) {
+			const float damping = std::pow(1.0f - drag, delta);
+			const float gravityX = gravity[0] * delta, gravityY = gravity[1] * delta;
+
+			float* const x = particles.x.data(), *const y = particles.y.data();
+			float* const velocityX = particles.velocityX.data(), *const velocityY = particles.velocityY.data();
+			float* const rotation = particles.rotation.data(), *const life = particles.life.data();
+			const float* const spin = particles.spin.data(), *const lifeRate = particles.lifeRate.data();
+
+			Index i = begin;
+#ifdef MACE_SSE
+			//begin is always a multiple of 4 and the arrays are padded to one, so the last block can safely run past end
+			const __m128 deltaVector = _mm_set1_ps(delta), dampingVector = _mm_set1_ps(damping);
+			const __m128 gravityXVector = _mm_set1_ps(gravityX), gravityYVector = _mm_set1_ps(gravityY);
+			for (; i < end; i += 4) {
+				const __m128 vx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(velocityX + i), gravityXVector), dampingVector);
+				const __m128 vy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(velocityY + i), gravityYVector), dampingVector);
+				_mm_storeu_ps(velocityX + i, vx);
+				_mm_storeu_ps(velocityY + i, vy);
+
+				_mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(vx, deltaVector)));
+				_mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(vy, deltaVector)));
+				_mm_storeu_ps(rotation + i, _mm_add_ps(_mm_loadu_ps(rotation + i), _mm_mul_ps(_mm_loadu_ps(spin + i), deltaVector)));
+				_mm_storeu_ps(life + i, _mm_add_ps(_mm_loadu_ps(life + i), _mm_mul_ps(_mm_loadu_ps(lifeRate + i), deltaVector)));
+			}
+#else
+			for (; i < end; ++i) {
+				velocityX[i] = (velocityX[i] + gravityX) * damping;
+				velocityY[i] = (velocityY[i] + gravityY) * damping;
+
+				x[i] += velocityX[i] * delta;
+				y[i] += velocityY[i] * delta;
+				rotation[i] += spin[i] * delta;
+				life[i] += lifeRate[i] * delta;
+			}
+#endif
+
+			//the curves are lookup tables, so this is a gather that doesn't vectorize
+			for (i = begin; i < end; ++i) {
+				const Color& color = colorCurve.get(life[i]);
+
+				particles.size[i] = particles.baseSize[i] * sizeCurve.get(life[i]);
+				particles.red[i] = color.r;
+				particles.green[i] = color.g;
+				particles.blue[i] = color.b;
+				particles.alpha[i] = color.a;
+			}
+		}
+
+		void ParticleSystem::emitParticles(const float delta) {
+			for (Index e = 0; e < emitters.size(); ++e) {
+				ParticleEmitter& emitter = emitters[e];
+				if (!emitter.enabled) {
+					emitterAccumulators[e] = 0.0f;
+					continue;
+				}
+
+				float& accumulator = emitterAccumulators[e];
+				accumulator += emitter.rate * delta;
+
+				const Size whole = static_cast<Size>(accumulator);
+				accumulator -= static_cast<float>(whole);
+
+				Size count = whole + emitter.burst;
+				emitter.burst = 0;
+
+				count = std::min(count, maxParticles - particleCount);
+				for (Index i = 0; i < count; ++i) {
+					spawnParticle(emitter);
+				}
+			}
+		}
+
+		void ParticleSystem::spawnParticle(const ParticleEmitter& emitter) {
+			const Index i = particleCount++;
+
+			const float angle = emitter.direction + randomBetween(-emitter.spread, emitter.spread);
+			const float speed = randomBetween(emitter.minSpeed, emitter.maxSpeed);
+			const float lifetime = std::max(randomBetween(emitter.minLifetime, emitter.maxLifetime), 1e-3f);
+
+			particles.x[i] = emitter.position[0] + randomBetween(-emitter.area[0], emitter.area[0]);
+			particles.y[i] = emitter.position[1] + randomBetween(-emitter.area[1], emitter.area[1]);
+			particles.velocityX[i] = std::cos(angle) * speed;
+			particles.velocityY[i] = std::sin(angle) * speed;
+			particles.rotation[i] = 0.0f;
+			particles.spin[i] = randomBetween(emitter.minSpin, emitter.maxSpin);
+			particles.life[i] = 0.0f;
+			particles.lifeRate[i] = 1.0f / lifetime;
+			particles.baseSize[i] = randomBetween(emitter.minSize, emitter.maxSize);
+
+			const Color& color = colorCurve.get(0.0f);
+			particles.size[i] = particles.baseSize[i] * sizeCurve.get(0.0f);
+			particles.red[i] = color.r;
+			particles.green[i] = color.g;
+			particles.blue[i] = color.b;
+			particles.alpha[i] = color.a;
+		}
+
+		float ParticleSystem::randomBetween(const float minimum, const float maximum) {
+			if (maximum <= minimum) {
+				return minimum;
+			}
+
+			return std::uniform_real_distribution<float>(minimum, maximum)(randomEngine);
+		}
+	}//gfx
+}//mc
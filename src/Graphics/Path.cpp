@@ -0,0 +1,533 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <MACE/Graphics/Path.h>
+#include <MACE/Utility/Math.h>
+
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+namespace mc {
+	namespace gfx {
+		//curves are never split into more lines than this, no matter the tolerance
+#define MACE__PATH_MAX_CURVE_SEGMENTS 256
+		//how far a miter join can extend, in multiples of the half width, before it is clamped
+#define MACE__PATH_MITER_LIMIT 4.0f
+		//circles are made of this many cubic curves
+#define MACE__PATH_ELLIPSE_SEGMENTS 4
+
+		namespace {
+			using Point = Vector<float, 2>;
+
+			inline Point makePoint(const float x, const float y) {
+				Point p;
+				p[0] = x;
+				p[1] = y;
+				return p;
+			}
+
+			inline float cross(const Point& a, const Point& b) {
+				return a[0] * b[1] - a[1] * b[0];
+			}
+
+			inline float length(const Point& p) {
+				return std::sqrt(p[0] * p[0] + p[1] * p[1]);
+			}
+
+			inline Point normalize(const Point& p) {
+				const float len = length(p);
+				if (len <= 0.0f) {
+					return makePoint(0.0f, 0.0f);
+				}
+				return makePoint(p[0] / len, p[1] / len);
+			}
+
+			//normal pointing to the right of the direction from a to b
+			inline Point edgeNormal(const Point& a, const Point& b) {
+				const Point dir = normalize(b - a);
+				return makePoint(dir[1], -dir[0]);
+			}
+
+			unsigned int calculateSegments(const float deviation, const float tolerance) {
+				//Wang's formula for how many lines are needed to stay within tolerance of the curve
+				const float segments = std::ceil(std::sqrt(deviation / tolerance));
+				if (!(segments >= 1.0f)) {
+					return 1;
+				}
+				return math::min(static_cast<unsigned int>(segments), static_cast<unsigned int>(MACE__PATH_MAX_CURVE_SEGMENTS));
+			}
+
+			void flattenQuadratic(const Point& p0, const Point& p1, const Point& p2, const float tolerance, std::vector<Point>& out) {
+				const float deviation = 0.25f * length(p0 - p1 * 2.0f + p2);
+				const unsigned int segments = calculateSegments(deviation, tolerance);
+				for (unsigned int i = 1; i <= segments; ++i) {
+					const float t = static_cast<float>(i) / static_cast<float>(segments), mt = 1.0f - t;
+					out.push_back(p0 * (mt * mt) + p1 * (2.0f * mt * t) + p2 * (t * t));
+				}
+			}
+
+			void flattenCubic(const Point& p0, const Point& p1, const Point& p2, const Point& p3, const float tolerance, std::vector<Point>& out) {
+				const float deviation = 0.75f * math::max(length(p0 - p1 * 2.0f + p2), length(p1 - p2 * 2.0f + p3));
+				const unsigned int segments = calculateSegments(deviation, tolerance);
+				for (unsigned int i = 1; i <= segments; ++i) {
+					const float t = static_cast<float>(i) / static_cast<float>(segments), mt = 1.0f - t;
+					out.push_back(p0 * (mt * mt * mt) + p1 * (3.0f * mt * mt * t) + p2 * (3.0f * mt * t * t) + p3 * (t * t * t));
+				}
+			}
+
+			void removeDuplicatePoints(std::vector<Point>& contour, const bool closed) {
+				if (contour.empty()) {
+					return;
+				}
+
+				Index last = 0;
+				for (Index i = 1; i < contour.size(); ++i) {
+					if (contour[i] != contour[last]) {
+						contour[++last] = contour[i];
+					}
+				}
+				contour.resize(last + 1);
+
+				if (closed && contour.size() > 1 && contour.front() == contour.back()) {
+					contour.pop_back();
+				}
+			}
+
+			float signedArea(const std::vector<Point>& contour) {
+				float area = 0.0f;
+				for (Index i = 0, j = contour.size() - 1; i < contour.size(); j = i++) {
+					area += cross(contour[j], contour[i]);
+				}
+				return area * 0.5f;
+			}
+
+			/*
+			Offset direction for a point joining two edges, scaled so that moving along it by `d`
+			keeps both edges `d` away. Extremely sharp corners are clamped by MACE__PATH_MITER_LIMIT.
+			*/
+			Point miterNormal(const Point& n0, const Point& n1) {
+				Point n = n0 + n1;
+				const float len = length(n);
+				if (len < 1e-6f) {
+					//the edges fold back onto each other
+					return n0;
+				}
+				n = n * (1.0f / len);
+
+				const float cosine = n[0] * n0[0] + n[1] * n0[1];
+				const float scale = 1.0f / math::max(cosine, 1.0f / MACE__PATH_MITER_LIMIT);
+				return n * scale;
+			}
+
+			void computeMiters(const std::vector<Point>& contour, const bool closed, std::vector<Point>& out) {
+				const Size count = contour.size();
+				out.resize(count);
+
+				for (Index i = 0; i < count; ++i) {
+					const bool first = i == 0, last = i == count - 1;
+					if (!closed && first) {
+						out[i] = edgeNormal(contour[0], contour[1]);
+					} else if (!closed && last) {
+						out[i] = edgeNormal(contour[count - 2], contour[count - 1]);
+					} else {
+						const Point& prev = contour[first ? count - 1 : i - 1];
+						const Point& next = contour[last ? 0 : i + 1];
+						out[i] = miterNormal(edgeNormal(prev, contour[i]), edgeNormal(contour[i], next));
+					}
+				}
+			}
+
+			unsigned int addVertex(PathMesh& mesh, const Point& p, const float coverage) {
+				const unsigned int index = static_cast<unsigned int>(mesh.getVertexCount());
+
+				mesh.vertices.push_back(p[0]);
+				mesh.vertices.push_back(p[1]);
+				mesh.vertices.push_back(0.0f);
+
+				mesh.textureCoordinates.push_back(coverage);
+				mesh.textureCoordinates.push_back(0.0f);
+
+				return index;
+			}
+
+			void addQuad(PathMesh& mesh, const unsigned int a, const unsigned int b, const unsigned int c, const unsigned int d) {
+				//a-b is one side, d-c is the other
+				mesh.indices.insert(mesh.indices.end(), {a, b, c, a, c, d});
+			}
+
+			bool isPointInTriangle(const Point& p, const Point& a, const Point& b, const Point& c) {
+				return cross(b - a, p - a) >= 0.0f && cross(c - b, p - b) >= 0.0f && cross(a - c, p - c) >= 0.0f;
+			}
+
+			//ear clipping for a counter-clockwise simple polygon. `base` is the index of the first vertex in the mesh
+			void triangulate(const std::vector<Point>& polygon, const unsigned int base, std::vector<unsigned int>& out) {
+				std::vector<Index> remaining = std::vector<Index>(polygon.size());
+				for (Index i = 0; i < remaining.size(); ++i) {
+					remaining[i] = i;
+				}
+
+				Index i = 0, attempts = 0;
+				while (remaining.size() > 3) {
+					const Size count = remaining.size();
+					const Index prev = remaining[(i + count - 1) % count], current = remaining[i % count], next = remaining[(i + 1) % count];
+					const Point& a = polygon[prev], &b = polygon[current], &c = polygon[next];
+
+					bool ear = cross(b - a, c - b) > 0.0f;
+					for (Index j = 0; ear && j < count; ++j) {
+						const Index other = remaining[j];
+						if (other != prev && other != current && other != next && isPointInTriangle(polygon[other], a, b, c)) {
+							ear = false;
+						}
+					}
+
+					if (ear) {
+						out.insert(out.end(), {base + static_cast<unsigned int>(prev), base + static_cast<unsigned int>(current), base + static_cast<unsigned int>(next)});
+						remaining.erase(remaining.begin() + static_cast<std::ptrdiff_t>(i % count));
+						attempts = 0;
+					} else if (++attempts > count) {
+						//self intersecting or degenerate, so there are no more ears. fan the rest so something is drawn
+						for (Index j = 1; j + 1 < remaining.size(); ++j) {
+							out.insert(out.end(), {base + static_cast<unsigned int>(remaining[0]), base + static_cast<unsigned int>(remaining[j]), base + static_cast<unsigned int>(remaining[j + 1])});
+						}
+						return;
+					} else {
+						++i;
+					}
+
+					i %= remaining.size();
+				}
+
+				if (remaining.size() == 3) {
+					out.insert(out.end(), {base + static_cast<unsigned int>(remaining[0]), base + static_cast<unsigned int>(remaining[1]), base + static_cast<unsigned int>(remaining[2])});
+				}
+			}
+		}//anon namespace
+
+		Model PathMesh::createModel() const {
+			Model model = Model();
+			model.init();
+
+			model.createVertices(static_cast<unsigned int>(vertices.size()), vertices.data(), PrimitiveType::TRIANGLES);
+			model.createTextureCoordinates(static_cast<unsigned int>(textureCoordinates.size()), textureCoordinates.data());
+			model.createIndices(static_cast<unsigned int>(indices.size()), indices.data());
+
+			return model;
+		}
+
+		Size PathMesh::getVertexCount() const {
+			return vertices.size() / 3;
+		}
+
+		void PathMesh::clear() {
+			vertices.clear();
+			textureCoordinates.clear();
+			indices.clear();
+		}
+
+		Path Path::rect(const float x, const float y, const float w, const float h) {
+			Path p = Path();
+			p.moveTo(x, y).lineTo(x + w, y).lineTo(x + w, y + h).lineTo(x, y + h).close();
+			return p;
+		}
+
+		Path Path::roundedRect(const float x, const float y, const float w, const float h, const float radius) {
+			const float r = math::min(radius, math::min(math::abs(w), math::abs(h)) * 0.5f);
+			if (r <= 0.0f) {
+				return rect(x, y, w, h);
+			}
+
+			const float halfPi = math::pi<float>() * 0.5f;
+
+			Path p = Path();
+			p.moveTo(x + r, y);
+			p.arc(x + w - r, y + r, r, -halfPi, 0.0f);
+			p.arc(x + w - r, y + h - r, r, 0.0f, halfPi);
+			p.arc(x + r, y + h - r, r, halfPi, 2.0f * halfPi);
+			p.arc(x + r, y + r, r, 2.0f * halfPi, 3.0f * halfPi);
+			p.close();
+			return p;
+		}
+
+		Path Path::ellipse(const float centerX, const float centerY, const float radiusX, const float radiusY) {
+			//distance of the control points for a cubic curve approximating a quarter circle
+			const float k = 0.5522847498f;
+
+			Path p = Path();
+			p.moveTo(centerX + radiusX, centerY);
+			p.cubicTo(centerX + radiusX, centerY + radiusY * k, centerX + radiusX * k, centerY + radiusY, centerX, centerY + radiusY);
+			p.cubicTo(centerX - radiusX * k, centerY + radiusY, centerX - radiusX, centerY + radiusY * k, centerX - radiusX, centerY);
+			p.cubicTo(centerX - radiusX, centerY - radiusY * k, centerX - radiusX * k, centerY - radiusY, centerX, centerY - radiusY);
+			p.cubicTo(centerX + radiusX * k, centerY - radiusY, centerX + radiusX, centerY - radiusY * k, centerX + radiusX, centerY);
+			p.close();
+			return p;
+		}
+
+		Path Path::circle(const float centerX, const float centerY, const float radius) {
+			return ellipse(centerX, centerY, radius, radius);
+		}
+
+		Path& Path::moveTo(const float x, const float y) {
+			addCommand(Command::MOVE, {x, y});
+			return *this;
+		}
+
+		Path& Path::lineTo(const float x, const float y) {
+			addCommand(Command::LINE, {x, y});
+			return *this;
+		}
+
+		Path& Path::quadraticTo(const float controlX, const float controlY, const float x, const float y) {
+			addCommand(Command::QUADRATIC, {controlX, controlY, x, y});
+			return *this;
+		}
+
+		Path& Path::cubicTo(const float control1X, const float control1Y, const float control2X, const float control2Y, const float x, const float y) {
+			addCommand(Command::CUBIC, {control1X, control1Y, control2X, control2Y, x, y});
+			return *this;
+		}
+
+		Path& Path::arc(const float centerX, const float centerY, const float radius, const float startAngle, const float endAngle) {
+			const float sweep = endAngle - startAngle;
+			const float startX = centerX + std::cos(startAngle) * radius, startY = centerY + std::sin(startAngle) * radius;
+
+			if (commands.empty() || commands.back() == Command::CLOSE) {
+				moveTo(startX, startY);
+			} else {
+				lineTo(startX, startY);
+			}
+
+			//each cubic curve covers at most a quarter turn to keep the error small
+			const unsigned int segments = math::max(1u, static_cast<unsigned int>(std::ceil(math::abs(sweep) / (math::pi<float>() * 0.5f))));
+			const float step = sweep / static_cast<float>(segments);
+			const float k = (4.0f / 3.0f) * std::tan(step * 0.25f) * radius;
+
+			float angle = startAngle;
+			for (unsigned int i = 0; i < segments; ++i) {
+				const float cos0 = std::cos(angle), sin0 = std::sin(angle);
+				const float cos1 = std::cos(angle + step), sin1 = std::sin(angle + step);
+
+				cubicTo(centerX + cos0 * radius - sin0 * k, centerY + sin0 * radius + cos0 * k,
+						centerX + cos1 * radius + sin1 * k, centerY + sin1 * radius - cos1 * k,
+						centerX + cos1 * radius, centerY + sin1 * radius);
+
+				angle += step;
+			}
+
+			return *this;
+		}
+
+		Path& Path::close() {
+			addCommand(Command::CLOSE, {});
+			return *this;
+		}
+
+		void Path::clear() {
+			commands.clear();
+			points.clear();
+			hashDirty = true;
+		}
+
+		bool Path::isEmpty() const {
+			return commands.empty();
+		}
+
+		std::size_t Path::getHash() const {
+			if (hashDirty) {
+				std::size_t seed = commands.size();
+				for (const Command c : commands) {
+					hashCombine(seed, static_cast<std::size_t>(c));
+				}
+				for (const float f : points) {
+					std::uint32_t bits;
+					std::memcpy(&bits, &f, sizeof(bits));
+					hashCombine(seed, static_cast<std::size_t>(bits));
+				}
+
+				hash = seed;
+				hashDirty = false;
+			}
+
+			return hash;
+		}
+
+		std::vector<std::vector<Vector<float, 2>>> Path::flatten(const float tolerance, std::vector<bool>& closed) const {
+			std::vector<std::vector<Point>> contours = std::vector<std::vector<Point>>();
+			closed.clear();
+
+			Point current = makePoint(0.0f, 0.0f);
+			Index p = 0;
+			for (const Command c : commands) {
+				//any drawing command without a contour implicitly starts one at the current point
+				if (c != Command::MOVE && c != Command::CLOSE && (contours.empty() || closed.back())) {
+					contours.push_back({current});
+					closed.push_back(false);
+				}
+
+				switch (c) {
+				case Command::MOVE:
+					current = makePoint(points[p], points[p + 1]);
+					p += 2;
+
+					contours.push_back({current});
+					closed.push_back(false);
+					break;
+				case Command::LINE:
+					current = makePoint(points[p], points[p + 1]);
+					p += 2;
+
+					contours.back().push_back(current);
+					break;
+				case Command::QUADRATIC: {
+					const Point control = makePoint(points[p], points[p + 1]), end = makePoint(points[p + 2], points[p + 3]);
+					p += 4;
+
+					flattenQuadratic(current, control, end, tolerance, contours.back());
+					current = end;
+					break;
+				}
+				case Command::CUBIC: {
+					const Point control1 = makePoint(points[p], points[p + 1]), control2 = makePoint(points[p + 2], points[p + 3]), end = makePoint(points[p + 4], points[p + 5]);
+					p += 6;
+
+					flattenCubic(current, control1, control2, end, tolerance, contours.back());
+					current = end;
+					break;
+				}
+				case Command::CLOSE:
+					if (!contours.empty() && !closed.back()) {
+						closed.back() = true;
+						current = contours.back().front();
+					}
+					break;
+				default MACE_UNLIKELY:
+					MACE__THROW(BadFormat, "Internal Error: Unknown Path command");
+				}
+			}
+
+			for (Index i = 0; i < contours.size(); ++i) {
+				removeDuplicatePoints(contours[i], closed[i]);
+			}
+
+			return contours;
+		}
+
+		void Path::tessellateFill(const float feather, PathMesh& out) const {
+			std::vector<bool> closed;
+			std::vector<std::vector<Point>> contours = flatten(feather > 0.0f ? feather * 0.25f : 0.01f, closed);
+
+			std::vector<Point> normals;
+			std::vector<Point> inner;
+			for (std::vector<Point>& contour : contours) {
+				if (contour.size() < 3) {
+					continue;
+				}
+
+				//everything below expects counter-clockwise winding
+				if (signedArea(contour) < 0.0f) {
+					std::reverse(contour.begin(), contour.end());
+				}
+
+				const unsigned int base = static_cast<unsigned int>(out.getVertexCount());
+
+				if (feather <= 0.0f) {
+					for (const Point& p : contour) {
+						addVertex(out, p, 1.0f);
+					}
+
+					triangulate(contour, base, out.indices);
+					continue;
+				}
+
+				//the fringe straddles the edge, half inside the shape and half outside
+				computeMiters(contour, true, normals);
+
+				inner.resize(contour.size());
+				for (Index i = 0; i < contour.size(); ++i) {
+					inner[i] = contour[i] - normals[i] * (feather * 0.5f);
+					addVertex(out, inner[i], 1.0f);
+				}
+				triangulate(inner, base, out.indices);
+
+				const unsigned int outerBase = static_cast<unsigned int>(out.getVertexCount());
+				for (Index i = 0; i < contour.size(); ++i) {
+					addVertex(out, contour[i] + normals[i] * (feather * 0.5f), 0.0f);
+				}
+
+				const unsigned int count = static_cast<unsigned int>(contour.size());
+				for (unsigned int i = 0; i < count; ++i) {
+					const unsigned int next = (i + 1) % count;
+					addQuad(out, base + i, base + next, outerBase + next, outerBase + i);
+				}
+			}
+		}
+
+		void Path::tessellateStroke(const float width, const float feather, PathMesh& out) const {
+			std::vector<bool> closed;
+			const std::vector<std::vector<Point>> contours = flatten(feather > 0.0f ? feather * 0.25f : 0.01f, closed);
+
+			const float halfWidth = width * 0.5f, halfFeather = feather * 0.5f;
+			//lines thinner than the fringe fade out instead of getting thinner, which looks much smoother
+			const float core = math::max(halfWidth - halfFeather, 0.0f);
+			const float coreCoverage = feather > 0.0f ? math::min(width / feather, 1.0f) : 1.0f;
+			const float edge = math::max(halfWidth + halfFeather, core);
+
+			std::vector<Point> normals;
+			for (Index c = 0; c < contours.size(); ++c) {
+				const std::vector<Point>& contour = contours[c];
+				const bool isClosed = closed[c] && contour.size() > 2;
+				if (contour.size() < 2) {
+					continue;
+				}
+
+				computeMiters(contour, isClosed, normals);
+
+				const unsigned int base = static_cast<unsigned int>(out.getVertexCount());
+				for (Index i = 0; i < contour.size(); ++i) {
+					const Point& p = contour[i];
+					const Point& n = normals[i];
+
+					//each point produces a row of 4 vertices across the line, from left to right
+					addVertex(out, p - n * edge, 0.0f);
+					addVertex(out, p - n * core, coreCoverage);
+					addVertex(out, p + n * core, coreCoverage);
+					addVertex(out, p + n * edge, 0.0f);
+				}
+
+				const unsigned int count = static_cast<unsigned int>(contour.size());
+				const unsigned int segments = isClosed ? count : count - 1;
+				for (unsigned int i = 0; i < segments; ++i) {
+					const unsigned int row = base + i * 4, nextRow = base + ((i + 1) % count) * 4;
+					for (unsigned int j = 0; j < 3; ++j) {
+						addQuad(out, row + j, row + j + 1, nextRow + j + 1, nextRow + j);
+					}
+				}
+			}
+		}
+
+		const std::vector<Path::Command>& Path::getCommands() const {
+			return commands;
+		}
+
+		const std::vector<float>& Path::getPoints() const {
+			return points;
+		}
+
+		bool Path::operator==(const Path& other) const {
+			return commands == other.commands && points == other.points;
+		}
+
+		bool Path::operator!=(const Path& other) const {
+			return !operator==(other);
+		}
+
+		void Path::addCommand(const Command command, std::initializer_list<float> args) {
+			commands.push_back(command);
+			points.insert(points.end(), args);
+			hashDirty = true;
+		}
+	}//gfx
+}//mc
@@ -7,6 +7,10 @@ See LICENSE.md for full copyright information
 #include <MACE/Graphics/Context.h>
 #include <MACE/Graphics/Entity2D.h>
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
 //debug purposes
 #include <iostream>
 
@@ -25,6 +29,11 @@ namespace mc {
 				resized = false;
 			}
 
+			lastFrame = currentFrame;
+			currentFrame = drawCount;
+
+			sceneChanged = true;
+
 			onSetUp(win);
 		}//setUp
 
@@ -37,37 +46,42 @@ namespace mc {
 
 			onQueue(e);
 
-			//it adds 1 so 0 (NULL) represents a non-initalized value
-
-			for (EntityID i = 0; i < renderQueue.size(); ++i) {
-				if (renderQueue[i].entity == nullptr || renderQueue[i].entity->needsRemoval() || renderQueue[i].entity == e) {
-					renderQueue[i].entity = e;
-					//0 is a null ID, so we increment by one
-					p.id = i + 1;
-					p.entity = e;
-					p.impl = renderQueue[i].painterImpl;
-					renderQueue[i].painterImpl->painter = &p;
-				}
+			//IDs are the index in the render queue plus 1, so 0 (NULL) represents a non-initalized value
+			Index slot;
+			if (p.id != 0 && p.id <= renderQueue.size() && renderQueue[p.id - 1].entity == e) {
+				//queued again without being removed, so it keeps its slot
+				slot = p.id - 1;
+			} else if (!freeIDs.empty()) {
+				slot = freeIDs.back() - 1;
+				freeIDs.pop_back();
+			} else {
+				std::shared_ptr<PainterImpl> impl = std::move(createPainterImpl());
+				impl->painter = &p;
+				impl->init();
+
+				slot = renderQueue.size();
+				renderQueue.push_back({nullptr, std::move(impl)});
 			}
 
-			std::shared_ptr<PainterImpl> impl = std::move(createPainterImpl());
-			p.impl = impl;
-			p.id = static_cast<EntityID>(renderQueue.size()) + 1;
+			renderQueue[slot].entity = e;
+			p.id = static_cast<EntityID>(slot) + 1;
 			p.entity = e;
-			impl->painter = &p;
-			impl->init();
-
-			renderQueue.push_back({e, std::move(impl)});
+			p.impl = renderQueue[slot].painterImpl;
+			renderQueue[slot].painterImpl->painter = &p;
 		}//queue
 
-		void Renderer::remove(const EntityID id) {
+		void Renderer::remove(const GraphicsEntity* const e, const EntityID id) {
 #ifdef MACE_DEBUG_CHECK_ARGS
-			if (id <= 0 || id > renderQueue.size()) {
+			if (id == 0 || id > renderQueue.size()) {
 				MACE__THROW(OutOfBounds, "Invalid GraphicsEntity ID to remove");
 			}
 #endif
 
-			renderQueue[id - 1].entity = nullptr;
+			//copies of a GraphicsEntity have the ID of the original, which isn't theirs to free
+			if (renderQueue[id - 1].entity == e) {
+				renderQueue[id - 1].entity = nullptr;
+				freeIDs.push_back(id);
+			}
 		}
 
 		void Renderer::flagResize() {
@@ -91,17 +105,129 @@ namespace mc {
 			onTearDown(win);
 		}//tearDown
 
-		void Renderer::checkInput(gfx::WindowModule*) {
-			const int mouseX = gfx::Input::getMouseX(), mouseY = gfx::Input::getMouseY();
-			if (mouseX >= 0 && mouseY >= 0) {
-				GraphicsEntity* hovered = getEntityAt(static_cast<unsigned int>(mouseX), static_cast<unsigned int>(mouseY));
+		void Renderer::checkInput(gfx::WindowModule* win) {
+			win->takeInput(events);
+
+			if (events.empty() && !sceneChanged) MACE_LIKELY{
+				return;
+			}
+
+			//moves are merged, as only where the mouse ended up matters
+			bool moved = false;
+			InputEvent lastMove = InputEvent();
 
-				if (hovered != nullptr && !hovered->needsRemoval()) {
-					hovered->hover();
+			for (const InputEvent& event : events) {
+				if (event.type == InputEvent::MOVE) {
+					moved = true;
+					lastMove = event;
+
+					mouseX = event.x;
+					mouseY = event.y;
+					continue;
+				}
+
+				//buttons go to whatever was under the mouse when they were pressed
+				if (moved || sceneChanged) {
+					updateHovered(win);
 				}
+				if (moved) {
+					sendToHovered(lastMove);
+					moved = false;
+				}
+
+				sendToHovered(event);
 			}
+
+			if (moved || sceneChanged) {
+				updateHovered(win);
+			}
+			if (moved) {
+				sendToHovered(lastMove);
+			}
+
+			events.clear();
 		}//checkInput
 
+		GraphicsEntity* Renderer::pick(gfx::WindowModule* win) {
+			if (mouseX < 0 || mouseY < 0) {
+				return nullptr;
+			}
+
+			GraphicsEntity* entity = nullptr;
+			if (pixelExactHover) {
+				entity = getEntityAt(static_cast<unsigned int>(mouseX), static_cast<unsigned int>(mouseY));
+			} else {
+				const Vector<int, 2> size = win->getFramebufferSize();
+				if (size.x() <= 0 || size.y() <= 0) {
+					return nullptr;
+				}
+
+				//the mouse starts at the top left, while y goes up for entities
+				entity = getEntityAt((static_cast<float>(mouseX) / size.x()) * 2.0f - 1.0f, 1.0f - (static_cast<float>(mouseY) / size.y()) * 2.0f);
+			}
+
+			if (entity == nullptr || entity->needsRemoval()) {
+				return nullptr;
+			}
+
+			return entity;
+		}
+
+		void Renderer::updateHovered(gfx::WindowModule* win) {
+			sceneChanged = false;
+
+			GraphicsEntity* const entity = pick(win);
+			if (entity == hovered) MACE_LIKELY{
+				return;
+			}
+
+			std::vector<Entity*> left = std::vector<Entity*>();
+			for (Entity* e = hovered; e != nullptr; e = e->getParent()) {
+				left.push_back(e);
+			}
+
+			std::vector<Entity*> entered = std::vector<Entity*>();
+			for (Entity* e = entity; e != nullptr; e = e->getParent()) {
+				entered.push_back(e);
+			}
+
+			//the parents they share are still under the mouse
+			while (!left.empty() && !entered.empty() && left.back() == entered.back()) {
+				left.pop_back();
+				entered.pop_back();
+			}
+
+			InputEvent event = InputEvent();
+			event.x = mouseX;
+			event.y = mouseY;
+
+			event.type = InputEvent::LEAVE;
+			event.target = hovered;
+			for (Entity* e : left) {
+				event.bubbles = false;
+				e->sendInput(event);
+			}
+
+			hovered = entity;
+
+			//parents are entered before their children
+			event.type = InputEvent::ENTER;
+			event.target = entity;
+			for (auto e = entered.rbegin(); e != entered.rend(); ++e) {
+				event.bubbles = false;
+				(*e)->sendInput(event);
+			}
+		}
+
+		void Renderer::sendToHovered(InputEvent event) {
+			if (hovered == nullptr) {
+				return;
+			}
+
+			event.target = hovered;
+			hovered->sendInput(event);
+		}
+
 		void Renderer::destroy() {
 			onDestroy();
 
@@ -110,14 +236,26 @@ namespace mc {
 			}
 
 			renderQueue.clear();
+			freeIDs.clear();
+
+			spatialIndex.clear();
+
+			events.clear();
+			hovered = nullptr;
 		}//destroy()
 
 		GraphicsEntity* Renderer::getEntityAt(const float x, const float y) {
-			return getEntityAt(static_cast<unsigned int>(getWidth() * ((x * 0.5f) + 0.5f)), static_cast<unsigned int>(getHeight() * ((y * 0.5f) + 0.5f)));
+			std::vector<GraphicsEntity*> hits = std::vector<GraphicsEntity*>();
+			getEntitiesAt(x, y, hits);
+
+			return hits.empty() ? nullptr : hits.front();
 		}
 
 		const GraphicsEntity * Renderer::getEntityAt(const float x, const float y) const {
-			return getEntityAt(static_cast<unsigned int>(getWidth() * ((x * 0.5f) + 0.5f)), static_cast<unsigned int>(getHeight() * ((y * 0.5f) + 0.5f)));
+			std::vector<GraphicsEntity*> hits = std::vector<GraphicsEntity*>();
+			getEntitiesAt(x, y, hits);
+
+			return hits.empty() ? nullptr : hits.front();
 		}
 
 		GraphicsEntity * Renderer::getEntityAt(const unsigned int x, const unsigned int y) {
@@ -134,6 +272,20 @@ namespace mc {
 			return getEntityByID(id);
 		}
 
+		void Renderer::getEntitiesAt(const float x, const float y, std::vector<GraphicsEntity*>& out) const {
+			std::vector<SpatialIndex::Proxy> proxies = std::vector<SpatialIndex::Proxy>();
+			spatialIndex.query(x, y, proxies);
+
+			appendDrawn(proxies, out);
+		}
+
+		void Renderer::getEntitiesIn(const Bounds& area, std::vector<GraphicsEntity*>& out) const {
+			std::vector<SpatialIndex::Proxy> proxies = std::vector<SpatialIndex::Proxy>();
+			spatialIndex.query(area, proxies);
+
+			appendDrawn(proxies, out);
+		}
+
 		Color Renderer::getPixelAt(const float x, const float y, const FrameBufferTarget target) const {
 			return getPixelAt(static_cast<unsigned int>(getWidth() * ((x * 0.5f) + 0.5f)), static_cast<unsigned int>(getHeight() * ((y * 0.5f) + 0.5f)), target);
 		}
@@ -176,17 +328,13 @@ namespace mc {
 
 			const EntityID id = inId - 1;
 
-			if (id > renderQueue.size()) {
+			if (id >= renderQueue.size()) {
 				return nullptr;
 			}
 
 			GraphicsEntity* out = renderQueue[id].entity;
-			if (out == nullptr) {
-				return nullptr;
-			}
-
-			if (out->needsRemoval()) {
-				renderQueue[id].entity = nullptr;
+			if (out == nullptr || out->needsRemoval()) {
+				//the slot is freed when the entity is destroyed
 				return nullptr;
 			}
 
@@ -201,16 +349,12 @@ namespace mc {
 
 			const EntityID id = inId - 1;
 
-			if (id > renderQueue.size()) {
+			if (id >= renderQueue.size()) {
 				return nullptr;
 			}
 
-			GraphicsEntity* out = renderQueue[id].entity;
-			if (out == nullptr) {
-				return nullptr;
-			}
-
-			if (out->needsRemoval()) {
+			const GraphicsEntity* out = renderQueue[id].entity;
+			if (out == nullptr || out->needsRemoval()) {
 				return nullptr;
 			}
 
@@ -229,6 +373,42 @@ namespace mc {
 			return context;
 		}
 
+		SpatialIndex& Renderer::getSpatialIndex() {
+			return spatialIndex;
+		}
+
+		const SpatialIndex& Renderer::getSpatialIndex() const {
+			return spatialIndex;
+		}
+
+		void Renderer::setPixelExactHover(const bool exact) {
+			pixelExactHover = exact;
+		}
+
+		bool Renderer::isPixelExactHover() const {
+			return pixelExactHover;
+		}
+
+		bool Renderer::wasDrawn(const SpatialIndex::Proxy proxy) const {
+			//entities that were never drawn have an order of 0
+			return spatialIndex.getOrder(proxy) > lastFrame;
+		}
+
+		void Renderer::appendDrawn(std::vector<SpatialIndex::Proxy>& proxies, std::vector<GraphicsEntity*>& out) const {
+			proxies.erase(std::remove_if(proxies.begin(), proxies.end(), [this](const SpatialIndex::Proxy proxy) {
+				return !wasDrawn(proxy) || spatialIndex.getEntity(proxy)->needsRemoval();
+			}), proxies.end());
+
+			std::sort(proxies.begin(), proxies.end(), [this](const SpatialIndex::Proxy a, const SpatialIndex::Proxy b) {
+				return spatialIndex.getOrder(a) > spatialIndex.getOrder(b);
+			});
+
+			out.reserve(out.size() + proxies.size());
+			for (const SpatialIndex::Proxy proxy : proxies) {
+				out.push_back(spatialIndex.getEntity(proxy));
+			}
+		}
+
 		Painter::Painter() : entity(nullptr), id(0), impl(nullptr) {}
 
 		Painter::Painter(GraphicsEntity * const en, const EntityID i, const std::shared_ptr<PainterImpl> pimpl) : entity(en), id(i), impl(pimpl) {}
@@ -327,6 +507,102 @@ namespace mc {
 			impl->draw(m, brush);
 		}
 
+		void Painter::drawModels(const std::vector<const Model*>& models, const Painter::Brush brush) {
+#ifdef MACE_DEBUG_CHECK_NULLPTR
+			if (impl == nullptr) {
+				MACE__THROW(NullPointer, "Internal Error: drawModels: PainterImpl was nullptr");
+			}
+
+			for (const Model* m : models) {
+				if (m == nullptr) {
+					MACE__THROW(NullPointer, "drawModels: Model was nullptr");
+				}
+			}
+#endif
+
+			if (models.empty()) {
+				return;
+			}
+
+			impl->loadSettings(state);
+			impl->drawModels(models, brush);
+		}
+
+		void Painter::drawQuadInstances(const QuadInstances & instances) {
+#ifdef MACE_DEBUG_CHECK_NULLPTR
+			if (impl == nullptr) {
+				MACE__THROW(NullPointer, "Internal Error: drawQuadInstances: PainterImpl was nullptr");
+			}
+#endif
+
+			if (instances.count == 0) {
+				return;
+			}
+
+#ifdef MACE_DEBUG_CHECK_ARGS
+			if (instances.x == nullptr || instances.y == nullptr || instances.size == nullptr || instances.rotation == nullptr
+				|| instances.red == nullptr || instances.green == nullptr || instances.blue == nullptr || instances.alpha == nullptr) {
+				MACE__THROW(NullPointer, "drawQuadInstances: Every attribute in QuadInstances must be set");
+			}
+#endif
+
+			impl->loadSettings(state);
+			impl->drawQuadInstances(instances);
+		}
+
+		void Painter::drawPathMesh(const Path & path, const float width, const bool stroke) {
+			if (path.isEmpty()) {
+				return;
+			}
+
+			GraphicsContext* context = gfx::getCurrentWindow()->getContext();
+#ifdef MACE_DEBUG_CHECK_NULLPTR
+			if (context == nullptr) {
+				MACE__THROW(NullPointer, "No graphics context found in window!");
+			}
+#endif
+
+			//the fringe should be about a pixel wide, so it depends on how large the path ends up on screen
+			Vector<float, 3> scale = state.transformation.scaler;
+			if (entity != nullptr) {
+				const Metrics& metrics = entity->getMetrics();
+				for (Index i = 0; i < 3; ++i) {
+					scale[i] *= metrics.transform.scaler[i] * metrics.inherited.scaler[i];
+				}
+			}
+
+			const Renderer* renderer = context->getRenderer();
+			const float pixelX = 2.0f / math::max(static_cast<float>(renderer->getWidth()) * math::abs(scale[0]), 1e-6f);
+			const float pixelY = 2.0f / math::max(static_cast<float>(renderer->getHeight()) * math::abs(scale[1]), 1e-6f);
+
+			//rounding to a power of two means small changes in scale reuse the same mesh
+			int exponent;
+			std::frexp(math::min(pixelX, pixelY), &exponent);
+			const float feather = std::ldexp(1.0f, exponent);
+
+			Model* mesh = context->findPathMesh(path, width, exponent, stroke);
+			if (mesh == nullptr) {
+				PathMesh tessellated = PathMesh();
+				if (stroke) {
+					path.tessellateStroke(width, feather, tessellated);
+				} else {
+					path.tessellateFill(feather, tessellated);
+				}
+
+				if (tessellated.indices.empty()) {
+					return;
+				}
+
+				mesh = &context->storePathMesh(path, width, exponent, stroke, tessellated.createModel());
+			}
+
+			push();
+			//coverage is passed through the texture coordinates
+			enableRenderFeatures(Painter::RenderFeatures::TEXTURE);
+			draw(*mesh, Painter::Brush::PATH);
+			pop();
+		}
+
 		const GraphicsEntity* const Painter::getEntity() const {
 			return entity;
 		}
@@ -379,6 +655,14 @@ namespace mc {
 			fillRect(dim.x(), dim.y(), dim.z(), dim.w());
 		}
 
+		void Painter::fillPath(const Path & path) {
+			drawPathMesh(path, 0.0f, false);
+		}
+
+		void Painter::drawPath(const Path & path, const float width) {
+			drawPathMesh(path, width, true);
+		}
+
 		void Painter::drawImage(const Texture & img) {
 			push();
 			setTexture(img, TextureSlot::FOREGROUND);
@@ -637,14 +921,24 @@ namespace mc {
 			return !operator==(other);
 		}
 
-		GraphicsEntity::GraphicsEntity() noexcept : Entity(), painter(this, 0, nullptr) {}
+		GraphicsEntity::GraphicsEntity() noexcept : Entity(), painter(this, 0, nullptr) {
+			watchMetrics(true);
+		}
 
-		GraphicsEntity::~GraphicsEntity() noexcept {}
+		GraphicsEntity::~GraphicsEntity() noexcept {
+			removeFromRenderer();
+		}
 
 		void GraphicsEntity::init() {
-			gfx::getCurrentWindow()->getContext()->getRenderer()->queue(this, painter);
+			renderer = gfx::getCurrentWindow()->getContext()->getRenderer();
+
+			renderer->queue(this, painter);
 			painter.init();
 
+			if (!isIndexed()) {
+				proxy = renderer->spatialIndex.insert(this, SpatialIndex::getBounds(getMetrics()));
+			}
+
 			Entity::init();
 		}
 
@@ -652,6 +946,8 @@ namespace mc {
 			Entity::destroy();
 
 			painter.destroy();
+
+			removeFromRenderer();
 		}
 
 		Painter& GraphicsEntity::getPainter() {
@@ -689,14 +985,47 @@ namespace mc {
 		}
 
 		void GraphicsEntity::onRender() {
+			if (isIndexed()) {
+				renderer->spatialIndex.setOrder(proxy, ++renderer->drawCount);
+			}
+
 			const Beginner beginner(painter);
 			onRender(painter);
 		}
 
-		void GraphicsEntity::clean() {
-			Entity::clean();
-
+		void GraphicsEntity::onMetricsChanged() {
 			painter.clean();
+
+			if (isIndexed()) {
+				renderer->spatialIndex.move(proxy, SpatialIndex::getBounds(getMetrics()));
+			}
+		}
+
+		bool GraphicsEntity::isIndexed() const {
+			//copies have the proxy of the original, which isn't theirs
+			return renderer != nullptr && renderer->spatialIndex.getEntity(proxy) == this;
+		}
+
+		void GraphicsEntity::removeFromRenderer() {
+			if (renderer == nullptr) {
+				return;
+			}
+
+			if (painter.id != 0 && painter.id <= renderer->renderQueue.size()) {
+				renderer->remove(this, painter.id);
+			}
+
+			if (isIndexed()) {
+				renderer->spatialIndex.remove(proxy);
+
+				if (renderer->hovered == this) {
+					renderer->hovered = nullptr;
+					renderer->sceneChanged = true;
+				}
+			}
+
+			renderer = nullptr;
+			proxy = SpatialIndex::NONE;
 		}
 	}//gfx
 }//mc
@@ -0,0 +1,394 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <MACE/Graphics/SpatialIndex.h>
+#include <MACE/Core/Error.h>
+
+#include <algorithm>
+#include <cmath>
+
+//how far past its bounds a proxy can move before the tree has to change
+#ifndef MACE__SPATIAL_INDEX_MARGIN
+#	define MACE__SPATIAL_INDEX_MARGIN 0.05f
+#endif
+
+namespace mc {
+	namespace gfx {
+		namespace {
+			Bounds expand(const Bounds& bounds, const float amount) {
+				Bounds out = bounds;
+				out.left -= amount;
+				out.bottom -= amount;
+				out.right += amount;
+				out.top += amount;
+				return out;
+			}
+		}//anon namespace
+
+		bool Bounds::contains(const float x, const float y) const {
+			return x >= left && x <= right && y >= bottom && y <= top;
+		}
+
+		bool Bounds::contains(const Bounds& other) const {
+			return other.left >= left && other.right <= right && other.bottom >= bottom && other.top <= top;
+		}
+
+		bool Bounds::overlaps(const Bounds& other) const {
+			return other.left <= right && other.right >= left && other.bottom <= top && other.top >= bottom;
+		}
+
+		float Bounds::getPerimeter() const {
+			return 2.0f * ((right - left) + (top - bottom));
+		}
+
+		Bounds Bounds::merge(const Bounds& other) const {
+			Bounds out = Bounds();
+			out.left = std::min(left, other.left);
+			out.bottom = std::min(bottom, other.bottom);
+			out.right = std::max(right, other.right);
+			out.top = std::max(top, other.top);
+			return out;
+		}
+
+		bool Bounds::operator==(const Bounds& other) const {
+			return left == other.left && bottom == other.bottom && right == other.right && top == other.top;
+		}
+
+		bool Bounds::operator!=(const Bounds& other) const {
+			return !operator==(other);
+		}
+
+		MACE_CONSTEXPR const SpatialIndex::Proxy SpatialIndex::NONE;
+
+		Bounds SpatialIndex::getBounds(const Metrics& metrics) {
+			const TransformMatrix& transform = metrics.transform;
+			const TransformMatrix& inherited = metrics.inherited;
+
+			//matches mcGetEntityPosition() in the vertex shader, where the parent rotates the translation and the entity rotates the quad
+			const float x = transform.translation[0] * inherited.scaler[0], y = transform.translation[1] * inherited.scaler[1];
+			const float parentCos = std::cos(inherited.rotation[2]), parentSin = std::sin(inherited.rotation[2]);
+			const float centerX = x * parentCos + y * parentSin + inherited.translation[0];
+			const float centerY = y * parentCos - x * parentSin + inherited.translation[1];
+
+			const float halfWidth = std::abs(transform.scaler[0] * inherited.scaler[0]), halfHeight = std::abs(transform.scaler[1] * inherited.scaler[1]);
+			const float cos = std::abs(std::cos(transform.rotation[2])), sin = std::abs(std::sin(transform.rotation[2]));
+			const float extentX = halfWidth * cos + halfHeight * sin, extentY = halfWidth * sin + halfHeight * cos;
+
+			Bounds out = Bounds();
+			out.left = centerX - extentX;
+			out.right = centerX + extentX;
+			out.bottom = centerY - extentY;
+			out.top = centerY + extentY;
+			return out;
+		}
+
+		SpatialIndex::Proxy SpatialIndex::insert(GraphicsEntity* entity, const Bounds& bounds) {
+			const Index leaf = allocate();
+
+			nodes[leaf].bounds = bounds;
+			nodes[leaf].fat = expand(bounds, MACE__SPATIAL_INDEX_MARGIN);
+			nodes[leaf].height = 0;
+			nodes[leaf].entity = entity;
+			nodes[leaf].order = 0;
+
+			insertLeaf(leaf);
+			++leafCount;
+
+			return leaf;
+		}
+
+		void SpatialIndex::remove(const Proxy proxy) {
+#ifdef MACE_DEBUG_CHECK_ARGS
+			if (proxy >= nodes.size() || !nodes[proxy].isLeaf()) {
+				MACE__THROW(ObjectNotFound, "Proxy passed to SpatialIndex::remove() isn\'t in the index");
+			}
+#endif
+
+			removeLeaf(proxy);
+			release(proxy);
+			--leafCount;
+		}
+
+		bool SpatialIndex::move(const Proxy proxy, const Bounds& bounds) {
+#ifdef MACE_DEBUG_CHECK_ARGS
+			if (proxy >= nodes.size() || !nodes[proxy].isLeaf()) {
+				MACE__THROW(ObjectNotFound, "Proxy passed to SpatialIndex::move() isn\'t in the index");
+			}
+#endif
+
+			nodes[proxy].bounds = bounds;
+
+			//proxies that shrunk a lot are refit as well, or their margin would only grow
+			const Bounds& fat = nodes[proxy].fat;
+			if (fat.contains(bounds) && expand(bounds, MACE__SPATIAL_INDEX_MARGIN * 4.0f).contains(fat)) MACE_LIKELY{
+				return false;
+			}
+
+			removeLeaf(proxy);
+			nodes[proxy].fat = expand(bounds, MACE__SPATIAL_INDEX_MARGIN);
+			insertLeaf(proxy);
+
+			return true;
+		}
+
+		void SpatialIndex::setOrder(const Proxy proxy, const Size order) {
+			nodes[proxy].order = order;
+		}
+
+		Size SpatialIndex::getOrder(const Proxy proxy) const {
+			return nodes[proxy].order;
+		}
+
+		GraphicsEntity* SpatialIndex::getEntity(const Proxy proxy) const {
+			return proxy < nodes.size() && nodes[proxy].isLeaf() ? nodes[proxy].entity : nullptr;
+		}
+
+		const Bounds& SpatialIndex::getBounds(const Proxy proxy) const {
+			return nodes[proxy].bounds;
+		}
+
+		void SpatialIndex::query(const float x, const float y, std::vector<Proxy>& out) const {
+			if (root == NONE) {
+				return;
+			}
+
+			std::vector<Index> stack = std::vector<Index>();
+			stack.reserve(getHeight() * 2);
+			stack.push_back(root);
+
+			while (!stack.empty()) {
+				const Node& node = nodes[stack.back()];
+				const Index index = stack.back();
+				stack.pop_back();
+
+				if (!node.fat.contains(x, y)) {
+					continue;
+				}
+
+				if (node.isLeaf()) {
+					if (node.bounds.contains(x, y)) {
+						out.push_back(index);
+					}
+				} else {
+					stack.push_back(node.left);
+					stack.push_back(node.right);
+				}
+			}
+		}
+
+		void SpatialIndex::query(const Bounds& area, std::vector<Proxy>& out) const {
+			if (root == NONE) {
+				return;
+			}
+
+			std::vector<Index> stack = std::vector<Index>();
+			stack.reserve(getHeight() * 2);
+			stack.push_back(root);
+
+			while (!stack.empty()) {
+				const Node& node = nodes[stack.back()];
+				const Index index = stack.back();
+				stack.pop_back();
+
+				if (!node.fat.overlaps(area)) {
+					continue;
+				}
+
+				if (node.isLeaf()) {
+					if (node.bounds.overlaps(area)) {
+						out.push_back(index);
+					}
+				} else {
+					stack.push_back(node.left);
+					stack.push_back(node.right);
+				}
+			}
+		}
+
+		void SpatialIndex::clear() {
+			nodes.clear();
+			freeNodes.clear();
+			root = NONE;
+			leafCount = 0;
+		}
+
+		Size SpatialIndex::size() const {
+			return leafCount;
+		}
+
+		Size SpatialIndex::getHeight() const {
+			return root == NONE ? 0 : static_cast<Size>(nodes[root].height + 1);
+		}
+
+		bool SpatialIndex::Node::isLeaf() const {
+			return height == 0;
+		}
+
+		Index SpatialIndex::allocate() {
+			if (freeNodes.empty()) {
+				nodes.push_back(Node());
+				return nodes.size() - 1;
+			}
+
+			const Index node = freeNodes.back();
+			freeNodes.pop_back();
+			nodes[node] = Node();
+			return node;
+		}
+
+		void SpatialIndex::release(const Index node) {
+			nodes[node].height = -1;
+			nodes[node].entity = nullptr;
+			freeNodes.push_back(node);
+		}
+
+		void SpatialIndex::insertLeaf(const Index leaf) {
+			if (root == NONE) {
+				root = leaf;
+				nodes[leaf].parent = NONE;
+				return;
+			}
+
+			const Bounds bounds = nodes[leaf].fat;
+
+			//walks down to the sibling that makes the tree grow the least
+			Index sibling = root;
+			while (!nodes[sibling].isLeaf()) {
+				const Node& node = nodes[sibling];
+
+				const float combined = node.fat.merge(bounds).getPerimeter();
+				//making a new parent for this node and the leaf
+				const float cost = 2.0f * combined;
+				//every node above the leaf grows by at least this much
+				const float inheritance = 2.0f * (combined - node.fat.getPerimeter());
+
+				float childCosts[2];
+				const Index children[2] = {node.left, node.right};
+				for (Index i = 0; i < 2; ++i) {
+					const Node& child = nodes[children[i]];
+					const float merged = child.fat.merge(bounds).getPerimeter();
+					childCosts[i] = (child.isLeaf() ? merged : merged - child.fat.getPerimeter()) + inheritance;
+				}
+
+				if (cost < childCosts[0] && cost < childCosts[1]) {
+					break;
+				}
+
+				sibling = childCosts[0] < childCosts[1] ? children[0] : children[1];
+			}
+
+			//allocating can move the nodes, so nothing is held by reference here
+			const Index oldParent = nodes[sibling].parent;
+			const Index newParent = allocate();
+
+			nodes[newParent].parent = oldParent;
+			nodes[newParent].fat = bounds.merge(nodes[sibling].fat);
+			nodes[newParent].height = nodes[sibling].height + 1;
+			nodes[newParent].left = sibling;
+			nodes[newParent].right = leaf;
+
+			nodes[sibling].parent = newParent;
+			nodes[leaf].parent = newParent;
+
+			if (oldParent == NONE) {
+				root = newParent;
+			} else if (nodes[oldParent].left == sibling) {
+				nodes[oldParent].left = newParent;
+			} else {
+				nodes[oldParent].right = newParent;
+			}
+
+			refit(newParent);
+		}
+
+		void SpatialIndex::removeLeaf(const Index leaf) {
+			if (leaf == root) {
+				root = NONE;
+				return;
+			}
+
+			const Index parent = nodes[leaf].parent;
+			const Index grandParent = nodes[parent].parent;
+			const Index sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+			release(parent);
+
+			nodes[sibling].parent = grandParent;
+			if (grandParent == NONE) {
+				root = sibling;
+				return;
+			}
+
+			if (nodes[grandParent].left == parent) {
+				nodes[grandParent].left = sibling;
+			} else {
+				nodes[grandParent].right = sibling;
+			}
+
+			refit(grandParent);
+		}
+
+		Index SpatialIndex::balance(const Index a) {
+			if (nodes[a].isLeaf() || nodes[a].height < 2) {
+				return a;
+			}
+
+			const int difference = nodes[nodes[a].right].height - nodes[nodes[a].left].height;
+			if (difference >= -1 && difference <= 1) MACE_LIKELY{
+				return a;
+			}
+
+			//the taller child takes the place of a
+			const Index up = difference > 1 ? nodes[a].right : nodes[a].left;
+			const Index stay = difference > 1 ? nodes[a].left : nodes[a].right;
+
+			const Index f = nodes[up].left, g = nodes[up].right;
+
+			nodes[up].left = a;
+			nodes[up].parent = nodes[a].parent;
+			nodes[a].parent = up;
+
+			if (nodes[up].parent == NONE) {
+				root = up;
+			} else if (nodes[nodes[up].parent].left == a) {
+				nodes[nodes[up].parent].left = up;
+			} else {
+				nodes[nodes[up].parent].right = up;
+			}
+
+			//the taller grandchild stays below up, and the other one moves below a where up was
+			const Index taller = nodes[f].height > nodes[g].height ? f : g;
+			const Index shorter = taller == f ? g : f;
+
+			nodes[up].right = taller;
+			if (difference > 1) {
+				nodes[a].right = shorter;
+			} else {
+				nodes[a].left = shorter;
+			}
+			nodes[shorter].parent = a;
+
+			nodes[a].fat = nodes[stay].fat.merge(nodes[shorter].fat);
+			nodes[a].height = 1 + std::max(nodes[stay].height, nodes[shorter].height);
+
+			nodes[up].fat = nodes[a].fat.merge(nodes[taller].fat);
+			nodes[up].height = 1 + std::max(nodes[a].height, nodes[taller].height);
+
+			return up;
+		}
+
+		void SpatialIndex::refit(Index node) {
+			while (node != NONE) {
+				node = balance(node);
+
+				const Index left = nodes[node].left, right = nodes[node].right;
+				nodes[node].height = 1 + std::max(nodes[left].height, nodes[right].height);
+				nodes[node].fat = nodes[left].fat.merge(nodes[right].fat);
+
+				node = nodes[node].parent;
+			}
+		}
+	}//gfx
+}//mc
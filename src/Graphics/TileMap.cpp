@@ -0,0 +1,297 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <MACE/Graphics/TileMap.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mc {
+	namespace gfx {
+		MACE_CONSTEXPR const TileMap::Tile TileMap::EMPTY;
+
+		TileMap::TileMap(const unsigned int c, const unsigned int r, const unsigned int ac, const unsigned int ar) : texture(), columns(c), rows(r), atlasColumns(ac), atlasRows(ar),
+			chunkColumns((c + MACE__TILEMAP_CHUNK_SIZE - 1) / MACE__TILEMAP_CHUNK_SIZE), chunkRows((r + MACE__TILEMAP_CHUNK_SIZE - 1) / MACE__TILEMAP_CHUNK_SIZE) {
+#ifdef MACE_DEBUG_CHECK_ARGS
+			if (columns == 0 || rows == 0) {
+				MACE__THROW(OutOfBounds, "A TileMap must have at least 1 row and column");
+			} else if (atlasColumns == 0 || atlasRows == 0) {
+				MACE__THROW(OutOfBounds, "A TileMap atlas must have at least 1 row and column");
+			}
+#endif
+
+			chunks.resize(static_cast<Size>(chunkColumns) * chunkRows);
+		}
+
+		void TileMap::setTexture(const Texture& tex) {
+			if (tex != texture) {
+				makeDirty();
+
+				texture = tex;
+			}
+		}
+
+		Texture& TileMap::getTexture() {
+			makeDirty();
+
+			return texture;
+		}
+
+		const Texture& TileMap::getTexture() const {
+			return texture;
+		}
+
+		void TileMap::setTile(const unsigned int x, const unsigned int y, const Tile tile) {
+			Chunk& chunk = getChunk(x, y);
+
+			Tile& current = chunk.tiles[(y % MACE__TILEMAP_CHUNK_SIZE) * MACE__TILEMAP_CHUNK_SIZE + (x % MACE__TILEMAP_CHUNK_SIZE)];
+			if (current == tile) {
+				return;
+			}
+
+			if (current == EMPTY) {
+				++chunk.tileCount;
+			} else if (tile == EMPTY) {
+				--chunk.tileCount;
+			}
+
+			current = tile;
+			chunk.dirty = true;
+
+			makeDirty();
+		}
+
+		TileMap::Tile TileMap::getTile(const unsigned int x, const unsigned int y) const {
+			return getChunk(x, y).tiles[(y % MACE__TILEMAP_CHUNK_SIZE) * MACE__TILEMAP_CHUNK_SIZE + (x % MACE__TILEMAP_CHUNK_SIZE)];
+		}
+
+		void TileMap::fill(const Tile tile) {
+			for (unsigned int chunkY = 0; chunkY < chunkRows; ++chunkY) {
+				for (unsigned int chunkX = 0; chunkX < chunkColumns; ++chunkX) {
+					Chunk& chunk = chunks[chunkY * chunkColumns + chunkX];
+
+					//chunks on the right and bottom edges can hang off the map, and those tiles must stay empty
+					const unsigned int width = std::min(columns - chunkX * MACE__TILEMAP_CHUNK_SIZE, static_cast<unsigned int>(MACE__TILEMAP_CHUNK_SIZE));
+					const unsigned int height = std::min(rows - chunkY * MACE__TILEMAP_CHUNK_SIZE, static_cast<unsigned int>(MACE__TILEMAP_CHUNK_SIZE));
+					for (unsigned int y = 0; y < height; ++y) {
+						std::fill_n(chunk.tiles.begin() + y * MACE__TILEMAP_CHUNK_SIZE, width, tile);
+					}
+
+					chunk.tileCount = tile == EMPTY ? 0 : static_cast<Size>(width) * height;
+					chunk.dirty = true;
+				}
+			}
+
+			makeDirty();
+		}
+
+		unsigned int TileMap::getColumns() const {
+			return columns;
+		}
+
+		unsigned int TileMap::getRows() const {
+			return rows;
+		}
+
+		void TileMap::setAtlasLayout(const unsigned int ac, const unsigned int ar) {
+#ifdef MACE_DEBUG_CHECK_ARGS
+			if (ac == 0 || ar == 0) {
+				MACE__THROW(OutOfBounds, "A TileMap atlas must have at least 1 row and column");
+			}
+#endif
+
+			if (ac == atlasColumns && ar == atlasRows) {
+				return;
+			}
+
+			atlasColumns = ac;
+			atlasRows = ar;
+
+			for (Chunk& chunk : chunks) {
+				chunk.dirty = true;
+			}
+
+			makeDirty();
+		}
+
+		unsigned int TileMap::getAtlasColumns() const {
+			return atlasColumns;
+		}
+
+		unsigned int TileMap::getAtlasRows() const {
+			return atlasRows;
+		}
+
+		Size TileMap::getChunkCount() const {
+			return chunks.size();
+		}
+
+		void TileMap::onInit() {}
+
+		void TileMap::onUpdate() {}
+
+		void TileMap::onRender(Painter& p) {
+			//the tile range that can be seen, starting with the whole map
+			float left = 0.0f, top = 0.0f, right = static_cast<float>(columns), bottom = static_cast<float>(rows);
+
+			const Metrics& metrics = getMetrics();
+			const TransformMatrix& transform = metrics.transform;
+			const TransformMatrix& inherited = metrics.inherited;
+
+			//rotated maps are rare, so they are never culled instead of testing every chunk against a rotated window
+			if (transform.rotation == Vector<float, 3>({0.0f, 0.0f, 0.0f})) {
+				for (Index i = 0; i < 2; ++i) {
+					//same math as the vertex shader. the window spans -1 to 1
+					const float scale = transform.scaler[i] * inherited.scaler[i];
+					const float offset = transform.translation[i] * inherited.scaler[i] + inherited.translation[i];
+					if (scale == 0.0f) {
+						return;
+					}
+
+					const float first = (-1.0f - offset) / scale, second = (1.0f - offset) / scale;
+					const float minimum = std::min(first, second), maximum = std::max(first, second);
+
+					if (i == 0) {
+						left = (minimum + 1.0f) * 0.5f * static_cast<float>(columns);
+						right = (maximum + 1.0f) * 0.5f * static_cast<float>(columns);
+					} else {
+						//y goes up, but rows go down
+						top = (1.0f - maximum) * 0.5f * static_cast<float>(rows);
+						bottom = (1.0f - minimum) * 0.5f * static_cast<float>(rows);
+					}
+				}
+			}
+
+			const float chunkSize = static_cast<float>(MACE__TILEMAP_CHUNK_SIZE);
+			const unsigned int firstChunkX = static_cast<unsigned int>(math::clamp(std::floor(left / chunkSize), 0.0f, static_cast<float>(chunkColumns)));
+			const unsigned int lastChunkX = static_cast<unsigned int>(math::clamp(std::ceil(right / chunkSize), 0.0f, static_cast<float>(chunkColumns)));
+			const unsigned int firstChunkY = static_cast<unsigned int>(math::clamp(std::floor(top / chunkSize), 0.0f, static_cast<float>(chunkRows)));
+			const unsigned int lastChunkY = static_cast<unsigned int>(math::clamp(std::ceil(bottom / chunkSize), 0.0f, static_cast<float>(chunkRows)));
+
+			visibleMeshes.clear();
+			for (unsigned int chunkY = firstChunkY; chunkY < lastChunkY; ++chunkY) {
+				for (unsigned int chunkX = firstChunkX; chunkX < lastChunkX; ++chunkX) {
+					Chunk& chunk = chunks[chunkY * chunkColumns + chunkX];
+					if (chunk.dirty) {
+						rebuildChunk(chunkX, chunkY);
+					}
+
+					if (chunk.tileCount > 0) {
+						visibleMeshes.push_back(&chunk.mesh);
+					}
+				}
+			}
+
+			if (visibleMeshes.empty()) {
+				return;
+			}
+
+			p.setTexture(texture.isCreated() ? texture : Texture::getSolidColor(), TextureSlot::FOREGROUND);
+			p.drawModels(visibleMeshes, Painter::Brush::TEXTURE);
+		}
+
+		void TileMap::onDestroy() {
+			for (Chunk& chunk : chunks) {
+				if (chunk.meshCreated) {
+					chunk.mesh.destroy();
+					chunk.meshCreated = false;
+				}
+
+				chunk.dirty = true;
+			}
+
+			if (texture.isCreated()) {
+				texture.destroy();
+			}
+		}
+
+		void TileMap::onClean() {}
+
+		TileMap::Chunk& TileMap::getChunk(const unsigned int x, const unsigned int y) {
+#ifdef MACE_DEBUG_CHECK_ARGS
+			if (x >= columns || y >= rows) {
+				MACE__THROW(OutOfBounds, "Tile (" + std::to_string(x) + ", " + std::to_string(y) + ") is outside of the TileMap");
+			}
+#endif
+
+			return chunks[(y / MACE__TILEMAP_CHUNK_SIZE) * chunkColumns + (x / MACE__TILEMAP_CHUNK_SIZE)];
+		}
+
+		const TileMap::Chunk& TileMap::getChunk(const unsigned int x, const unsigned int y) const {
+#ifdef MACE_DEBUG_CHECK_ARGS
+			if (x >= columns || y >= rows) {
+				MACE__THROW(OutOfBounds, "Tile (" + std::to_string(x) + ", " + std::to_string(y) + ") is outside of the TileMap");
+			}
+#endif
+
+			return chunks[(y / MACE__TILEMAP_CHUNK_SIZE) * chunkColumns + (x / MACE__TILEMAP_CHUNK_SIZE)];
+		}
+
+		void TileMap::rebuildChunk(const unsigned int chunkX, const unsigned int chunkY) {
+			Chunk& chunk = chunks[chunkY * chunkColumns + chunkX];
+			chunk.dirty = false;
+
+			if (chunk.tileCount == 0) {
+				//the old mesh is kept for when tiles are added again, it just isn't drawn
+				return;
+			}
+
+			const float tileWidth = 2.0f / static_cast<float>(columns), tileHeight = 2.0f / static_cast<float>(rows);
+			const float cellWidth = 1.0f / static_cast<float>(atlasColumns), cellHeight = 1.0f / static_cast<float>(atlasRows);
+
+			std::vector<float> vertices = std::vector<float>();
+			std::vector<float> textureCoordinates = std::vector<float>();
+			std::vector<unsigned int> indices = std::vector<unsigned int>();
+			vertices.reserve(chunk.tileCount * 12);
+			textureCoordinates.reserve(chunk.tileCount * 8);
+			indices.reserve(chunk.tileCount * 6);
+
+			for (unsigned int y = 0; y < MACE__TILEMAP_CHUNK_SIZE; ++y) {
+				for (unsigned int x = 0; x < MACE__TILEMAP_CHUNK_SIZE; ++x) {
+					const Tile tile = chunk.tiles[y * MACE__TILEMAP_CHUNK_SIZE + x];
+					if (tile == EMPTY) {
+						continue;
+					}
+
+					const float left = -1.0f + static_cast<float>(chunkX * MACE__TILEMAP_CHUNK_SIZE + x) * tileWidth;
+					const float top = 1.0f - static_cast<float>(chunkY * MACE__TILEMAP_CHUNK_SIZE + y) * tileHeight;
+					const float right = left + tileWidth, bottom = top - tileHeight;
+
+					const float u = static_cast<float>(tile % atlasColumns) * cellWidth;
+					const float v = static_cast<float>((tile / atlasColumns) % atlasRows) * cellHeight;
+
+					const unsigned int base = static_cast<unsigned int>(vertices.size() / 3);
+
+					//same winding and texture orientation as Model::getQuad()
+					vertices.insert(vertices.end(), {
+						left, bottom, 0.0f,
+						left, top, 0.0f,
+						right, top, 0.0f,
+						right, bottom, 0.0f
+					});
+					textureCoordinates.insert(textureCoordinates.end(), {
+						u, v + cellHeight,
+						u, v,
+						u + cellWidth, v,
+						u + cellWidth, v + cellHeight
+					});
+					indices.insert(indices.end(), {
+						base, base + 1, base + 3,
+						base + 1, base + 2, base + 3
+					});
+				}
+			}
+
+			if (!chunk.meshCreated) {
+				chunk.mesh.init();
+				chunk.meshCreated = true;
+			}
+
+			chunk.mesh.createVertices(static_cast<unsigned int>(vertices.size()), vertices.data(), PrimitiveType::TRIANGLES);
+			chunk.mesh.createTextureCoordinates(static_cast<unsigned int>(textureCoordinates.size()), textureCoordinates.data());
+			chunk.mesh.createIndices(static_cast<unsigned int>(indices.size()), indices.data());
+		}
+	}//gfx
+}//mc
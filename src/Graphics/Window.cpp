@@ -11,6 +11,7 @@ See LICENSE.md for full copyright information
 #include <MACE/Graphics/Window.h>
 #include <MACE/Graphics/Renderer.h>
 #include <MACE/Graphics/Context.h>
+#include <MACE/Graphics/Hierarchy.h>
 #include <MACE/Graphics/OGL/OGL33.h>
 #include <MACE/Graphics/OGL/OGL33Renderer.h>
 #include <MACE/Graphics/OGL/OGL33Context.h>
@@ -38,6 +39,13 @@ namespace mc {
 				keys[key] = action;
 			}
 
+			void pushMouseEvent(GLFWwindow* window, InputEvent event) {
+				event.x = mouseX;
+				event.y = mouseY;
+
+				convertGLFWWindowToModule(window)->pushInput(event);
+			}
+
 			GLFWwindow* createWindow(const WindowModule::LaunchConfig& config) {
 				if (config.fullscreen) {
 					GLFWmonitor* mon = glfwGetPrimaryMonitor();
@@ -117,7 +125,7 @@ namespace mc {
 				pushKeyEvent(static_cast<short int>(key), actions);
 			}
 
-			void onWindowMouseButton(GLFWwindow*, int button, int action, int mods) {
+			void onWindowMouseButton(GLFWwindow* window, int button, int action, int mods) {
 				Byte actions = 0x00;
 				if (action == GLFW_PRESS) {
 					actions |= Input::PRESSED;
@@ -143,20 +151,46 @@ namespace mc {
 
 				//in case that we dont have it mapped the same way that GLFW does, we add MOUSE_FIRST which is the offset to the mouse bindings.
 				pushKeyEvent(static_cast<short int>(button) + Input::MOUSE_FIRST, actions);
+
+				if (action == GLFW_PRESS || action == GLFW_RELEASE) {
+					InputEvent event = InputEvent();
+					event.type = action == GLFW_PRESS ? InputEvent::PRESS : InputEvent::RELEASE;
+					event.button = static_cast<short int>(button) + Input::MOUSE_FIRST;
+					event.modifiers = static_cast<Byte>(actions & (Input::MODIFIER_SHIFT | Input::MODIFIER_CONTROL | Input::MODIFIER_ALT | Input::MODIFIER_SUPER));
+					pushMouseEvent(window, event);
+				}
 			}
 
 			void onWindowCursorPosition(GLFWwindow * window, double xpos, double ypos) {
 				mouseX = static_cast<int>(mc::math::floor(xpos));
 				mouseY = static_cast<int>(mc::math::floor(ypos));
 
+				pushMouseEvent(window, InputEvent());
+
 				WindowModule* win = convertGLFWWindowToModule(window);
 				win->getLaunchConfig().onMouseMove(*win, mouseX, mouseY);
 			}
 
+			void onWindowCursorEnter(GLFWwindow * window, int entered) {
+				if (!entered) {
+					//so whatever was under the mouse gets a LEAVE event
+					mouseX = -1;
+					mouseY = -1;
+
+					pushMouseEvent(window, InputEvent());
+				}
+			}
+
 			void onWindowScrollWheel(GLFWwindow * window, double xoffset, double yoffset) {
 				scrollY = yoffset;
 				scrollX = xoffset;
 
+				InputEvent event = InputEvent();
+				event.type = InputEvent::SCROLL;
+				event.scrollX = xoffset;
+				event.scrollY = yoffset;
+				pushMouseEvent(window, event);
+
 				WindowModule* win = convertGLFWWindowToModule(window);
 				win->getLaunchConfig().onScroll(*win, scrollX, scrollY);
 			}
@@ -172,7 +206,16 @@ namespace mc {
 			}
 		}//anon namespace
 
-		WindowModule::WindowModule(const LaunchConfig & c) : config(c), properties(0), window(nullptr) {}
+		WindowModule::WindowModule(const LaunchConfig & c) : config(c), properties(0), window(nullptr), transformHierarchy(new TransformHierarchy()) {
+			setChildrenIndependent(config.parallelUpdate);
+
+			useHierarchy(*transformHierarchy);
+		}
+
+		WindowModule::~WindowModule() noexcept {
+			//anything still in the tree outlives the hierarchy of this window
+			useHierarchy(getTransformHierarchy());
+		}
 
 		void WindowModule::create() {
 			glfwSetErrorCallback(&onGLFWError);
@@ -269,6 +312,7 @@ namespace mc {
 			glfwSetKeyCallback(window, &onWindowKeyButton);
 			glfwSetMouseButtonCallback(window, &onWindowMouseButton);
 			glfwSetCursorPosCallback(window, &onWindowCursorPosition);
+			glfwSetCursorEnterCallback(window, &onWindowCursorEnter);
 			glfwSetScrollCallback(window, &onWindowScrollWheel);
 
 			glfwSetFramebufferSizeCallback(window, &onWindowFramebufferResized);
@@ -307,9 +351,6 @@ namespace mc {
 				using TimeStamp = std::chrono::time_point<Clock>;
 				using Duration = std::chrono::microseconds;
 
-				//mutex for this function.
-				std::mutex mutex;
-
 				//now is set to be now() every loop, and the delta is calculated from now and last frame.
 				TimeStamp now = Clock::now();
 				//each time the frame is swapped, lastFrame is updated with the new time
@@ -319,7 +360,8 @@ namespace mc {
 				Duration windowDelay = Duration::zero();
 
 				try {
-					const std::unique_lock<std::mutex> guard(mutex);//in case there is an exception, the unique lock will unlock the mutex
+					//the main thread can already be adding children
+					const std::unique_lock<std::recursive_mutex> guard = transformHierarchy->lock();//in case there is an exception, the unique lock will unlock the mutex
 
 					configureThread();
 
@@ -340,14 +382,16 @@ namespace mc {
 				//we loop infinitely until break is called. break is called when an exception is thrown or MACE::isRunning is false
 				for (;;) {//( ;_;)
 					try {
-						//thread doesn't own window, so we have to lock the mutex
-						const std::unique_lock<std::mutex> guard(mutex);//in case there is an exception, the unique lock will unlock the mutex
-
-						if (getProperty(Entity::DIRTY)) {
-							Renderer* const renderer = context->getRenderer();
-							renderer->setUp(this);
-							Entity::render();
-							renderer->tearDown(this);
+						{
+							//the main thread changes the tree while it updates, so it is kept out until the frame is built
+							const std::unique_lock<std::recursive_mutex> guard = transformHierarchy->lock();//in case there is an exception, the unique lock will unlock the mutex
+
+							if (getProperty(Entity::DIRTY)) {
+								Renderer* const renderer = context->getRenderer();
+								renderer->setUp(this);
+								Entity::render();
+								renderer->tearDown(this);
+							}
 						}
 
 						context->render();
@@ -376,7 +420,7 @@ namespace mc {
 				os::checkError(__LINE__, __FILE__, "A system error occurred during the window loop");
 
 				try {
-					const std::unique_lock<std::mutex> guard(mutex);//in case there is an exception, the unique lock will unlock the mutex
+					const std::unique_lock<std::recursive_mutex> guard = transformHierarchy->lock();//in case there is an exception, the unique lock will unlock the mutex
 
 					Entity::destroy();
 
@@ -416,18 +460,16 @@ namespace mc {
 		}
 
 		void WindowModule::update() {
-			std::mutex mutex;
-			const std::unique_lock<std::mutex> guard(mutex);
-
+			//the hierarchy isn't held here, as independent children are updated on other threads that lock it themselves
 			glfwPollEvents();
 
+			components.update();
 			Entity::update();
 		}//update
 
 		void WindowModule::destroy() {
 			{
-				std::mutex mutex;
-				const std::unique_lock<std::mutex> guard(mutex);
+				const std::unique_lock<std::recursive_mutex> guard = transformHierarchy->lock();
 				setProperty(gfx::Entity::DEAD, true);
 			}
 
@@ -478,6 +520,29 @@ namespace mc {
 			return context.get();
 		}
 
+		ComponentStore& WindowModule::getComponentStore() {
+			return components;
+		}
+
+		const ComponentStore& WindowModule::getComponentStore() const {
+			return components;
+		}
+
+		void WindowModule::pushInput(const InputEvent& event) {
+			const std::unique_lock<std::mutex> guard(inputMutex);
+			input.push_back(event);
+		}
+
+		void WindowModule::takeInput(std::vector<InputEvent>& out) {
+			const std::unique_lock<std::mutex> guard(inputMutex);
+			if (out.empty()) {
+				out.swap(input);
+			} else {
+				out.insert(out.end(), input.begin(), input.end());
+				input.clear();
+			}
+		}
+
 		Monitor WindowModule::getMonitor() {
 			GLFWmonitor* const mon = glfwGetWindowMonitor(window);
 			if (mon != nullptr) {
@@ -535,7 +600,8 @@ namespace mc {
 				&& fps == other.fps && contextType == other.contextType
 				&& terminateOnClose == other.terminateOnClose
 				&& decorated == other.decorated && fullscreen == other.fullscreen
-				&& resizable == other.resizable && vsync == other.vsync;
+				&& resizable == other.resizable && vsync == other.vsync
+				&& parallelUpdate == other.parallelUpdate;
 		}
 
 		bool WindowModule::LaunchConfig::operator!=(const LaunchConfig & other) const {
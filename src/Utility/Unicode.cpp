@@ -0,0 +1,183 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <MACE/Utility/Unicode.h>
+
+#ifdef MACE_SSE
+#	include <emmintrin.h>
+#endif
+
+namespace mc {
+	namespace utf8 {
+		Size validate(const char* data, const Size length) {
+			Index i = 0;
+
+			while (i < length) {
+#ifdef MACE_SSE
+				//a chunk is only ASCII if none of its bytes have the high bit set
+				while (i + 16 <= length && _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i))) == 0) {
+					i += 16;
+				}
+
+				if (i >= length) {
+					break;
+				}
+#endif
+
+				const unsigned char lead = static_cast<unsigned char>(data[i]);
+
+				if (lead < 0x80) {
+					++i;
+					continue;
+				}
+
+				Size size;
+				char32_t minimum;
+				if ((lead & 0xE0) == 0xC0) {
+					size = 2;
+					minimum = 0x80;
+				} else if ((lead & 0xF0) == 0xE0) {
+					size = 3;
+					minimum = 0x800;
+				} else if ((lead & 0xF8) == 0xF0) {
+					size = 4;
+					minimum = 0x10000;
+				} else {
+					return i;
+				}
+
+				if (size > length - i) {
+					return i;
+				}
+
+				char32_t codepoint = lead & (0x7F >> size);
+				for (Index j = 1; j < size; ++j) {
+					const unsigned char continuation = static_cast<unsigned char>(data[i + j]);
+					if ((continuation & 0xC0) != 0x80) {
+						return i;
+					}
+
+					codepoint = (codepoint << 6) | (continuation & 0x3F);
+				}
+
+				if (codepoint < minimum || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+					return i;
+				}
+
+				i += size;
+			}
+
+			return length;
+		}
+
+		Size validate(const std::string& str) {
+			return validate(str.data(), str.length());
+		}
+
+		bool isValid(const std::string& str) {
+			return validate(str) == str.length();
+		}
+
+		std::string sanitize(const std::string& str) {
+			Size invalid = validate(str);
+			if (invalid == str.length()) {
+				return str;
+			}
+
+			std::string out = std::string();
+			out.reserve(str.length());
+
+			Index start = 0;
+			while (invalid < str.length()) {
+				out.append(str, start, invalid - start);
+				append(out, REPLACEMENT_CHARACTER);
+
+				//the rest of a broken sequence is skipped along with it
+				start = invalid + 1;
+				while (start < str.length() && !isCodepointStart(str[start])) {
+					++start;
+				}
+
+				invalid = start + validate(str.data() + start, str.length() - start);
+			}
+
+			out.append(str, start, std::string::npos);
+
+			return out;
+		}
+
+		Size countCodepoints(const std::string& str) {
+			Size count = 0;
+			for (const char c : str) {
+				if (isCodepointStart(c)) {
+					++count;
+				}
+			}
+
+			return count;
+		}
+
+		void append(std::string& out, const char32_t codepoint) {
+			if (codepoint < 0x80) {
+				out.push_back(static_cast<char>(codepoint));
+			} else if (codepoint < 0x800) {
+				out.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+				out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+			} else if (codepoint < 0x10000) {
+				out.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+				out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+				out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+			} else {
+				out.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+				out.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+				out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+				out.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+			}
+		}
+
+		std::string fromWideString(const std::wstring& str) {
+			std::string out = std::string();
+			out.reserve(str.length());
+
+			for (Index i = 0; i < str.length(); ++i) {
+				char32_t codepoint = static_cast<char32_t>(str[i]);
+
+				if (codepoint >= 0xD800 && codepoint <= 0xDFFF) {
+					//only UTF-16 has surrogates, and they have to come in pairs
+					if (sizeof(wchar_t) == 2 && codepoint <= 0xDBFF && i + 1 < str.length() && str[i + 1] >= 0xDC00 && str[i + 1] <= 0xDFFF) {
+						codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (static_cast<char32_t>(str[i + 1]) - 0xDC00);
+						++i;
+					} else {
+						codepoint = REPLACEMENT_CHARACTER;
+					}
+				} else if (codepoint > 0x10FFFF) {
+					codepoint = REPLACEMENT_CHARACTER;
+				}
+
+				append(out, codepoint);
+			}
+
+			return out;
+		}
+
+		std::wstring toWideString(const std::string& str) {
+			std::wstring out = std::wstring();
+			out.reserve(str.length());
+
+			for (Index i = 0; i < str.length();) {
+				const char32_t codepoint = decode(str.data(), i);
+
+				if (sizeof(wchar_t) == 2 && codepoint >= 0x10000) {
+					out.push_back(static_cast<wchar_t>(0xD800 + ((codepoint - 0x10000) >> 10)));
+					out.push_back(static_cast<wchar_t>(0xDC00 + ((codepoint - 0x10000) & 0x3FF)));
+				} else {
+					out.push_back(static_cast<wchar_t>(codepoint));
+				}
+			}
+
+			return out;
+		}
+	}//utf8
+}//mc
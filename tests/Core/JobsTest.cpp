@@ -0,0 +1,71 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <catch2/catch.hpp>
+#include <MACE/Core/Jobs.h>
+#include <MACE/Core/Error.h>
+
+#include <atomic>
+#include <vector>
+
+namespace mc {
+	TEST_CASE("Testing JobSystem", "[system][jobs]") {
+		JobSystem::Config config = JobSystem::Config();
+		config.workers = 3;
+
+		JobSystem jobs(config);
+		REQUIRE(jobs.getWorkerCount() == 3);
+
+		SECTION("Parents are done once every child is") {
+			std::atomic<int> count(0);
+
+			const JobHandle parent = jobs.create([&count]() {
+				++count;
+			});
+
+			for (int i = 0; i < 100; ++i) {
+				jobs.run([&jobs, &count, parent]() {
+					//children can have children of their own
+					jobs.run([&count]() {
+						++count;
+					}, parent);
+
+					++count;
+				}, parent);
+			}
+
+			jobs.run(parent);
+			jobs.wait(parent);
+
+			REQUIRE(parent->isDone());
+			REQUIRE(count == 201);
+		}
+
+		SECTION("parallelFor() covers the whole range once") {
+			std::vector<int> visits = std::vector<int>(1000, 0);
+
+			jobs.parallelFor(0, visits.size(), 64, [&visits](const Index begin, const Index end) {
+				for (Index i = begin; i < end; ++i) {
+					++visits[i];
+				}
+			});
+
+			for (const int visit : visits) {
+				REQUIRE(visit == 1);
+			}
+		}
+
+		SECTION("Exceptions are thrown by wait()") {
+			const JobHandle parent = jobs.create([]() {});
+			jobs.run([]() {
+				MACE__THROW(AssertionFailed, "Thrown from a job");
+			}, parent);
+			jobs.run(parent);
+
+			REQUIRE_THROWS_AS(jobs.wait(parent), AssertionFailedError);
+			REQUIRE(parent->isDone());
+		}
+	}
+}//mc
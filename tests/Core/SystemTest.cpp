@@ -0,0 +1,35 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <catch2/catch.hpp>
+#include <MACE/Core/System.h>
+#include <MACE/Core/Error.h>
+
+#include <cstdio>
+#include <fstream>
+
+namespace mc {
+	TEST_CASE("Testing mapping files", "[system]") {
+		const char* path = "mace_map_file_test.bin";
+
+		{
+			std::ofstream file(path, std::ios::binary);
+			file << "mapped file";
+		}
+
+		Size size = 0;
+		const Byte* data = os::mapFile(path, &size);
+
+		REQUIRE(data != nullptr);
+		REQUIRE(size == 11);
+		REQUIRE(std::string(reinterpret_cast<const char*>(data), size) == "mapped file");
+
+		os::unmapFile(data, size);
+
+		std::remove(path);
+
+		REQUIRE_THROWS_AS(os::mapFile(path, &size), FileNotFoundError);
+	}
+}//mc
@@ -0,0 +1,192 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <catch2/catch.hpp>
+#include <MACE/Graphics/Components.h>
+
+#include <chrono>
+#include <thread>
+
+namespace mc {
+	namespace gfx {
+		TEST_CASE("Testing ComponentArray", "[component][graphics]") {
+			ComponentArray<int> array = ComponentArray<int>();
+
+			const PoolHandle first = array.add(nullptr, 1);
+			const PoolHandle second = array.add(nullptr, 2);
+			const PoolHandle third = array.add(nullptr, 3);
+
+			array.remove(first);
+
+			REQUIRE(array.size() == 2);
+			REQUIRE_FALSE(array.isValid(first));
+			//the last one was moved into the hole, and its handle still works
+			REQUIRE(array.getData()[0] == 3);
+			REQUIRE(*array.get(third) == 3);
+			REQUIRE(*array.get(second) == 2);
+
+			const PoolHandle fourth = array.add(nullptr, 4);
+			REQUIRE(fourth != first);
+			REQUIRE(array.get(first) == nullptr);
+			REQUIRE(*array.get(fourth) == 4);
+		}
+
+		TEST_CASE("Testing EaseSystem", "[component][graphics]") {
+			ComponentStore store = ComponentStore();
+			EaseSystem& system = store.getSystem<EaseSystem>();
+			REQUIRE(&store.getSystem<EaseSystem>() == &system);
+
+			EaseSettings settings = EaseSettings();
+			settings.ease = EaseFunctions::LINEAR;
+			settings.ms = 1000;
+
+			float value = -1.0f;
+			bool done = false;
+			settings.done = [&done](Entity*) {
+				done = true;
+			};
+
+			const PoolHandle ease = system.add(nullptr, [&value](Entity*, float v) {
+				value = v;
+			}, settings, 2.0f, 4.0f);
+
+			REQUIRE(store.size() == 1);
+
+			system.advance(0.5f);
+			REQUIRE(value == Approx(3.0f).margin(0.05f));
+			REQUIRE(system.getProgress(ease) == Approx(0.5f).margin(0.05f));
+
+			SECTION("Eases are removed once they are done") {
+				system.advance(0.6f);
+
+				REQUIRE(value == 4.0f);
+				REQUIRE(done);
+				REQUIRE_FALSE(system.isEasing(ease));
+				REQUIRE(system.size() == 0);
+			}
+
+			SECTION("Removing an ease from a callback") {
+				const PoolHandle other = system.add(nullptr, [&system, ease](Entity*, float) {
+					system.remove(ease);
+				}, settings);
+
+				system.advance(0.1f);
+
+				REQUIRE_FALSE(system.isEasing(ease));
+				REQUIRE(system.isEasing(other));
+				REQUIRE_FALSE(done);
+			}
+
+			SECTION("Eases added between advances start at the next one") {
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+				const PoolHandle other = system.add(nullptr, [](Entity*, float) {}, settings);
+
+				system.advance(0.5f);
+				REQUIRE(system.getProgress(other) == Approx(0.5f).margin(0.001f));
+			}
+		}
+
+		TEST_CASE("Testing TweenSystem", "[component][graphics]") {
+			ComponentStore store = ComponentStore();
+			TweenSystem& system = store.getSystem<TweenSystem>();
+
+			EaseSettings settings = EaseSettings();
+			settings.ease = EaseFunctions::LINEAR;
+			settings.ms = 1000;
+
+			bool done = false;
+			settings.done = [&done](Entity*) {
+				done = true;
+			};
+
+			//more than fit in one SIMD register, so the remainder is tested as well
+			float values[7] = {};
+			PoolHandle tweens[7];
+			for (Index i = 0; i < 7; ++i) {
+				tweens[i] = system.add(&values[i], 2.0f, 4.0f, settings);
+			}
+
+			REQUIRE(system.size() == 7);
+			REQUIRE(system.getGroupCount() == 1);
+
+			system.advance(0.5f);
+			for (Index i = 0; i < 7; ++i) {
+				REQUIRE(values[i] == Approx(3.0f).margin(0.05f));
+			}
+			REQUIRE(system.getProgress(tweens[6]) == Approx(0.5f).margin(0.05f));
+
+			SECTION("Tweens are removed once they are done") {
+				system.advance(0.6f);
+
+				for (Index i = 0; i < 7; ++i) {
+					REQUIRE(values[i] == 4.0f);
+					REQUIRE_FALSE(system.isTweening(tweens[i]));
+				}
+				REQUIRE(done);
+				REQUIRE(system.size() == 0);
+
+				//handles aren't mixed up with the tweens that reuse their slots
+				const PoolHandle next = system.add(&values[0], 0.0f, 1.0f, settings);
+				REQUIRE(system.isTweening(next));
+				REQUIRE_FALSE(system.isTweening(tweens[6]));
+			}
+
+			SECTION("Removing a tween moves the last one into its place") {
+				system.remove(tweens[0]);
+				REQUIRE_FALSE(system.isTweening(tweens[0]));
+				REQUIRE(system.size() == 6);
+				REQUIRE_THROWS_AS(system.remove(tweens[0]), ObjectNotFoundError);
+
+				system.advance(0.25f);
+				REQUIRE(values[0] == Approx(3.0f).margin(0.05f));
+				REQUIRE(values[6] == Approx(3.5f).margin(0.05f));
+				REQUIRE(system.getProgress(tweens[6]) == Approx(0.75f).margin(0.05f));
+			}
+
+			SECTION("Groups are made per ease function") {
+				settings.ease = EaseFunctions::QUADRATIC_IN;
+				settings.repeats = 2;
+				settings.reverseOnRepeat = true;
+
+				float value = -1.0f;
+				const PoolHandle tween = system.add(&value, 0.0f, 1.0f, settings);
+				REQUIRE(system.getGroupCount() == 2);
+
+				system.advance(0.5f);
+				REQUIRE(value == Approx(0.25f).margin(0.05f));
+
+				system.advance(0.6f);
+				REQUIRE(value == 1.0f);
+				REQUIRE(system.isTweening(tween));
+
+				//the second repetition goes backwards
+				system.advance(0.5f);
+				REQUIRE(value == Approx(0.75f).margin(0.05f));
+			}
+
+			SECTION("Tweens added between advances start at the next one") {
+				//nothing calls update(), so the time since the system was made doesn't count
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+				float value = -1.0f;
+				const PoolHandle tween = system.add(&value, 0.0f, 1.0f, settings);
+
+				system.advance(0.5f);
+				REQUIRE(value == Approx(0.5f).margin(0.001f));
+				REQUIRE(system.getProgress(tween) == Approx(0.5f).margin(0.001f));
+			}
+
+			SECTION("Only plain functions can be used") {
+				settings.ease = [](float t, const float b, const float c, const float d) {
+					return b + c * (t / d);
+				};
+
+				float value = 0.0f;
+				REQUIRE_THROWS_AS(system.add(&value, 0.0f, 1.0f, settings), InvalidTypeError);
+			}
+		}
+	}//gfx
+}//mc
@@ -0,0 +1,71 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <catch2/catch.hpp>
+#include <MACE/Graphics/Components.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mc {
+	namespace gfx {
+		namespace {
+			template<float(*Function)(float, const float, const float, const float), Size Resolution>
+			float getMaximumError() {
+				float error = 0.0f;
+				for (Index i = 0; i <= 1000; ++i) {
+					const float t = static_cast<float>(i) / 1000.0f;
+					error = std::max(error, std::abs(EaseTable<Function, Resolution>::get(t) - Function(t, 0.0f, 1.0f, 1.0f)));
+				}
+				return error;
+			}
+		}//anon namespace
+
+		TEST_CASE("Testing EaseTable", "[component][graphics]") {
+			SECTION("The ends match the function") {
+				REQUIRE(EaseTable<EaseFunctions::ELASTIC_OUT>::get(0.0f) == EaseFunctions::ELASTIC_OUT(0.0f, 0.0f, 1.0f, 1.0f));
+				REQUIRE(EaseTable<EaseFunctions::ELASTIC_OUT>::get(1.0f) == EaseFunctions::ELASTIC_OUT(1.0f, 0.0f, 1.0f, 1.0f));
+				REQUIRE(EaseTable<EaseFunctions::BACK_IN>::get(1.0f) == EaseFunctions::BACK_IN(1.0f, 0.0f, 1.0f, 1.0f));
+
+				//progress is clamped
+				REQUIRE(EaseTable<EaseFunctions::LINEAR>::get(-1.0f) == 0.0f);
+				REQUIRE(EaseTable<EaseFunctions::LINEAR>::get(2.0f) == 1.0f);
+			}
+
+			SECTION("Interpolating is close to the function") {
+				REQUIRE(getMaximumError<EaseFunctions::LINEAR, 16>() < 0.0001f);
+				REQUIRE(getMaximumError<EaseFunctions::SINUSOIDAL_IN_OUT, 256>() < 0.001f);
+				REQUIRE(getMaximumError<EaseFunctions::CUBIC_IN_OUT, 256>() < 0.001f);
+				//the circle is vertical at the end, which a straight line can't follow
+				REQUIRE(getMaximumError<EaseFunctions::CIRCLE_IN, 256>() < 0.05f);
+				REQUIRE(getMaximumError<EaseFunctions::ELASTIC_OUT, 256>() < 0.01f);
+				REQUIRE(getMaximumError<EaseFunctions::BOUNCE_OUT, 1024>() < 0.01f);
+
+				//more samples are more accurate
+				REQUIRE(getMaximumError<EaseFunctions::ELASTIC_OUT, 1024>() < getMaximumError<EaseFunctions::ELASTIC_OUT, 64>());
+			}
+
+			SECTION("It can be used like any other ease") {
+				REQUIRE(EaseTable<EaseFunctions::QUADRATIC_IN>::ease(500.0f, 2.0f, 2.0f, 1000.0f) == Approx(2.5f).margin(0.001f));
+
+				const float progress[5] = {0.0f, 0.25f, 0.5f, 0.75f, 1.0f};
+				float out[5];
+				EaseTable<EaseFunctions::QUADRATIC_IN>::get(progress, out, 5);
+				for (Index i = 0; i < 5; ++i) {
+					REQUIRE(out[i] == Approx(progress[i] * progress[i]).margin(0.001f));
+				}
+
+				EaseSettings settings = EaseSettings();
+				settings.ease = EaseTable<EaseFunctions::QUADRATIC_IN>::ease;
+
+				float value = 0.0f;
+				TweenSystem system;
+				system.add(&value, 0.0f, 1.0f, settings);
+				system.advance(0.5f);
+				REQUIRE(value == Approx(0.25f).margin(0.05f));
+			}
+		}
+	}//gfx
+}//mc
@@ -6,6 +6,8 @@ See LICENSE.md for full copyright information
 #include <catch2/catch.hpp>
 #include <MACE/Graphics/Entity.h>
 #include <MACE/Graphics/Entity2D.h>
+#include <MACE/Graphics/Hierarchy.h>
+#include <MACE/Core/Jobs.h>
 
 
 namespace mc {
@@ -44,6 +46,55 @@ namespace mc {
 			}
 		};
 
+		//adds a child the first time it is updated
+		class SpawningEntity: public DummyEntity {
+		public:
+			Size sizeAfterAdding = 0;
+		protected:
+			void onUpdate() override {
+				DummyEntity::onUpdate();
+
+				if (isEmpty()) {
+					addChild(std::make_shared<DummyEntity>());
+					sizeAfterAdding = size();
+				}
+			}
+		};
+
+		//has its own TransformHierarchy, like a WindowModule
+		class HierarchyRoot: public DummyEntity {
+		public:
+			TransformHierarchy ownHierarchy{};
+
+			HierarchyRoot() {
+				useHierarchy(ownHierarchy);
+			}
+
+			~HierarchyRoot() {
+				useHierarchy(getTransformHierarchy());
+			}
+		};
+
+		//records the input it receives, and can stop it from bubbling
+		class InputEntity: public DummyEntity {
+		public:
+			std::vector<mc::gfx::InputEvent::Type> received = std::vector<mc::gfx::InputEvent::Type>();
+			bool stopsInput = false;
+			int hovers = 0;
+		protected:
+			void onInput(mc::gfx::InputEvent& event) override {
+				received.push_back(event.type);
+
+				if (stopsInput) {
+					event.bubbles = false;
+				}
+			}
+
+			void onHover() override {
+				++hovers;
+			}
+		};
+
 		class DummyGroup: public mc::gfx::Group {
 		public:
 			using Entity::init;
@@ -76,6 +127,12 @@ namespace mc {
 			void render() override {
 			
 			}
+
+			int hovers = 0;
+
+			void hover() override {
+				++hovers;
+			}
 		};
 
 		DummyGroup c = DummyGroup();
@@ -108,6 +165,209 @@ namespace mc {
 			}
 		}
 
+		TEST_CASE("Testing inherited transforms", "[entity][graphics]") {
+			DummyEntity root = DummyEntity();
+			DummyEntity child = DummyEntity();
+			DummyEntity grandchild = DummyEntity();
+
+			root.addChild(child);
+			child.addChild(grandchild);
+			root.init();
+
+			root.setX(0.5f);
+			root.setWidth(2.0f);
+			child.setY(0.25f);
+			grandchild.setX(0.125f);
+
+			root.clean();
+
+			REQUIRE(child.isCleaned);
+			REQUIRE(grandchild.isCleaned);
+			REQUIRE_FALSE(grandchild.getProperty(Entity::DIRTY));
+
+			REQUIRE(child.getMetrics().inherited.translation == Vector<float, 3>({0.5f, 0.0f, 0.0f}));
+			REQUIRE(child.getMetrics().inherited.scaler[0] == 2.0f);
+			REQUIRE(grandchild.getMetrics().inherited.translation == Vector<float, 3>({0.5f, 0.25f, 0.0f}));
+			REQUIRE(grandchild.getMetrics().transform.translation[0] == 0.125f);
+
+			SECTION("Only dirty entities are cleaned") {
+				child.isCleaned = false;
+				grandchild.isCleaned = false;
+
+				root.setX(-0.5f);
+				root.clean();
+
+				REQUIRE_FALSE(child.isCleaned);
+				REQUIRE_FALSE(grandchild.isCleaned);
+				//but everything below it still inherits the move
+				REQUIRE(grandchild.getMetrics().inherited.translation == Vector<float, 3>({-0.5f, 0.25f, 0.0f}));
+			}
+
+			SECTION("Moving an entity to another parent") {
+				child.removeChild(grandchild);
+				root.addChild(grandchild);
+
+				root.clean();
+
+				REQUIRE(grandchild.getMetrics().inherited.translation == Vector<float, 3>({0.5f, 0.0f, 0.0f}));
+			}
+
+			SECTION("Dirty entities make the root dirty") {
+				REQUIRE_FALSE(root.getProperty(Entity::DIRTY));
+
+				grandchild.makeDirty();
+				REQUIRE(root.getProperty(Entity::DIRTY));
+
+				child.makeDirty();
+				REQUIRE(child.getProperty(Entity::DIRTY));
+
+				root.clean();
+				REQUIRE_FALSE(root.getProperty(Entity::DIRTY));
+				REQUIRE_FALSE(child.getProperty(Entity::DIRTY));
+
+				//the path from the last clean can't be reused
+				grandchild.makeDirty();
+				REQUIRE(root.getProperty(Entity::DIRTY));
+			}
+		}
+
+		TEST_CASE("Testing separate hierarchies", "[entity][graphics]") {
+			HierarchyRoot root;
+			DummyEntity child = DummyEntity();
+			DummyEntity grandchild = DummyEntity();
+
+			child.setX(0.25f);
+			child.addChild(grandchild);
+
+			const Size shared = getTransformHierarchy().size();
+
+			//the whole subtree is moved into the hierarchy of its new root
+			root.addChild(child);
+			REQUIRE(root.ownHierarchy.size() == 3);
+			REQUIRE(getTransformHierarchy().size() == shared - 2);
+
+			root.init();
+			root.setX(0.5f);
+			root.clean();
+
+			REQUIRE(child.isCleaned);
+			REQUIRE(grandchild.getMetrics().inherited.translation == Vector<float, 3>({0.75f, 0.0f, 0.0f}));
+
+			SECTION("Entities moved to another tree go to its hierarchy") {
+				DummyEntity other = DummyEntity();
+
+				root.removeChild(child);
+				other.addChild(child);
+
+				REQUIRE(root.ownHierarchy.size() == 1);
+				REQUIRE(getTransformHierarchy().size() == shared + 1);
+				//their metrics are kept until the other tree is cleaned
+				REQUIRE(grandchild.getMetrics().inherited.translation == Vector<float, 3>({0.75f, 0.0f, 0.0f}));
+
+				other.clean();
+
+				REQUIRE(grandchild.getMetrics().inherited.translation == Vector<float, 3>({0.25f, 0.0f, 0.0f}));
+			}
+		}
+
+		TEST_CASE("Testing parallel updates", "[entity][graphics]") {
+			SpawningEntity first = SpawningEntity(), second = SpawningEntity();
+			DummyEntity dependent = DummyEntity();
+			DummyGroup root = DummyGroup();
+
+			first.setProperty(Entity::INDEPENDENT, true);
+			second.setProperty(Entity::INDEPENDENT, true);
+
+			root.addChild(first);
+			root.addChild(second);
+			root.addChild(dependent);
+			root.init();
+			root.clean();
+
+			root.update();
+
+			REQUIRE(first.isUpdated);
+			REQUIRE(second.isUpdated);
+			REQUIRE(dependent.isUpdated);
+
+			SECTION("Structural changes are made after every task is done") {
+				REQUIRE(first.sizeAfterAdding == 0);
+				REQUIRE(first.size() == 1);
+				REQUIRE(second.size() == 1);
+				REQUIRE(first[0].getProperty(Entity::INIT));
+				REQUIRE(root.getProperty(Entity::DIRTY));
+			}
+
+			SECTION("Dead entities are removed after every task is done") {
+				first[0].setProperty(Entity::DEAD, true);
+
+				root.update();
+
+				REQUIRE(first.isEmpty());
+				REQUIRE(second.size() == 1);
+				REQUIRE(EntityCommandBuffer::getCurrent() == nullptr);
+			}
+
+			SECTION("Tasks run on the current JobSystem") {
+				JobSystem::Config config = JobSystem::Config();
+				config.workers = 2;
+				JobSystem jobs(config);
+
+				second[0].setProperty(Entity::DEAD, true);
+
+				JobSystem::setCurrent(&jobs);
+				root.update();
+				JobSystem::setCurrent(nullptr);
+
+				REQUIRE(first.size() == 1);
+				REQUIRE(second.isEmpty());
+			}
+
+			root.clearChildren();
+		}
+
+		TEST_CASE("Testing input events", "[entity][graphics]") {
+			InputEntity parent = InputEntity(), child = InputEntity();
+			parent.addChild(child);
+
+			DummyComponent* component = new DummyComponent();
+			child.addComponent(std::shared_ptr<Component>(component));
+
+			InputEvent event = InputEvent();
+			event.target = &child;
+
+			SECTION("Events bubble up to the parent") {
+				event.type = InputEvent::PRESS;
+				child.sendInput(event);
+
+				REQUIRE(child.received.size() == 1);
+				REQUIRE(parent.received.size() == 1);
+				REQUIRE(parent.received[0] == InputEvent::PRESS);
+				REQUIRE(child.hovers == 0);
+			}
+
+			SECTION("Bubbling can be stopped") {
+				child.stopsInput = true;
+
+				event.type = InputEvent::RELEASE;
+				child.sendInput(event);
+
+				REQUIRE(child.received.size() == 1);
+				REQUIRE(parent.received.empty());
+			}
+
+			SECTION("Entering calls onHover() and Component::hover()") {
+				event.type = InputEvent::ENTER;
+				event.bubbles = false;
+				child.sendInput(event);
+
+				REQUIRE(child.hovers == 1);
+				REQUIRE(component->hovers == 1);
+				REQUIRE(parent.hovers == 0);
+				REQUIRE(parent.received.empty());
+			}
+		}
+
 		TEST_CASE("Testing the getParent() function", "[entity][graphics]") {
 
 			DummyEntity e = DummyEntity();
@@ -232,6 +492,77 @@ namespace mc {
 			c.reset();
 		}
 
+		TEST_CASE("Testing child orders", "[entity][graphics]") {
+			DummyEntity children[5];
+			for (DummyEntity& child : children) {
+				c.addChild(child);
+			}
+
+			REQUIRE(c.getChildOrder() == Entity::ChildOrder::ORDERED);
+			REQUIRE(c.indexOf(children[3]) == 3);
+
+			SECTION("Ordered children shift down") {
+				c.removeChild(children[1]);
+
+				REQUIRE(c.size() == 4);
+				REQUIRE_FALSE(c.hasChild(children[1]));
+				REQUIRE(&c[1] == &children[2]);
+				REQUIRE(c.indexOf(children[4]) == 3);
+			}
+
+			SECTION("Unordered children swap with the last one") {
+				c.setChildOrder(Entity::ChildOrder::UNORDERED);
+				c.removeChild(children[1]);
+
+				REQUIRE(c.size() == 4);
+				REQUIRE_FALSE(c.hasChild(children[1]));
+				REQUIRE(&c[1] == &children[4]);
+				REQUIRE(c.indexOf(children[4]) == 1);
+				REQUIRE(c.indexOf(children[2]) == 2);
+			}
+
+			SECTION("Deferred children leave holes until they are compacted") {
+				c.setChildOrder(Entity::ChildOrder::DEFERRED);
+				c.removeChild(children[1]);
+				c.removeChild(children[3]);
+
+				REQUIRE(c.size() == 5);
+				REQUIRE(c.getChildren()[1] == nullptr);
+				REQUIRE_FALSE(c.hasChild(children[3]));
+				REQUIRE(c.indexOf(children[4]) == 4);
+
+				c.compactChildren();
+
+				REQUIRE(c.size() == 3);
+				REQUIRE(&c[1] == &children[2]);
+				REQUIRE(c.indexOf(children[4]) == 2);
+			}
+
+			SECTION("Killing many children at once") {
+				std::vector<DummyEntity> many = std::vector<DummyEntity>(10000);
+				for (DummyEntity& child : many) {
+					c.addChild(child);
+				}
+
+				c.init();
+				for (Index i = 0; i < many.size(); i += 2) {
+					many[i].setProperty(Entity::DEAD, true);
+				}
+				c.update();
+
+				REQUIRE(c.size() == 5 + many.size() / 2);
+				REQUIRE_FALSE(c.hasChild(many[0]));
+				REQUIRE(c.indexOf(many[1]) == 5);
+				REQUIRE(c.indexOf(many.back()) == c.size() - 1);
+
+				//the children have to be removed before they go out of scope
+				c.reset();
+			}
+
+			c.reset();
+			c.setChildOrder(Entity::ChildOrder::ORDERED);
+		}
+
 		TEST_CASE("Testing actions", "[entity][graphics]") {
 			DummyComponent a = DummyComponent();
 			DummyEntity e = DummyEntity();
@@ -0,0 +1,93 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <catch2/catch.hpp>
+#include <MACE/Graphics/Particles.h>
+
+namespace mc {
+	namespace gfx {
+		TEST_CASE("Testing ParticleCurve", "[particles][graphics]") {
+			SECTION("Constant curves") {
+				const ParticleCurve<float> curve = ParticleCurve<float>(2.0f);
+
+				REQUIRE(curve.get(0.0f) == 2.0f);
+				REQUIRE(curve.get(0.5f) == 2.0f);
+				REQUIRE(curve.get(1.0f) == 2.0f);
+			}
+
+			SECTION("Interpolating between unsorted keys") {
+				const ParticleCurve<float> curve = ParticleCurve<float>({{1.0f, 0.0f}, {0.0f, 1.0f}});
+
+				REQUIRE(curve.get(0.0f) == 1.0f);
+				REQUIRE(curve.get(0.5f) == Approx(0.5f).margin(0.02f));
+				REQUIRE(curve.get(1.0f) == 0.0f);
+				REQUIRE(curve.get(2.0f) == 0.0f);
+			}
+
+			SECTION("Color curves") {
+				const ParticleCurve<Color> curve = ParticleCurve<Color>({{0.0f, Color(1.0f, 0.0f, 0.0f, 1.0f)}, {1.0f, Color(0.0f, 0.0f, 1.0f, 0.0f)}});
+
+				REQUIRE(curve.get(0.5f).r == Approx(0.5f).margin(0.02f));
+				REQUIRE(curve.get(0.5f).b == Approx(0.5f).margin(0.02f));
+				REQUIRE(curve.get(1.0f).a == 0.0f);
+			}
+		}
+
+		TEST_CASE("Testing ParticleSystem simulation", "[particles][graphics]") {
+			ParticleSystem system = ParticleSystem(100);
+
+			ParticleEmitter emitter = ParticleEmitter();
+			emitter.rate = 0.0f;
+			emitter.burst = 10;
+			emitter.minLifetime = 0.5f;
+			emitter.maxLifetime = 0.5f;
+			system.addEmitter(emitter);
+
+			REQUIRE(system.getParticleCount() == 0);
+
+			system.simulate(0.0f);
+			REQUIRE(system.getParticleCount() == 10);
+
+			SECTION("Particles die after their lifetime") {
+				system.simulate(0.1f);
+				REQUIRE(system.getParticleCount() == 10);
+
+				for (unsigned int i = 0; i < 5; ++i) {
+					system.simulate(0.1f);
+				}
+				REQUIRE(system.getParticleCount() == 0);
+			}
+
+			SECTION("The particle limit is respected") {
+				system.getEmitter(0).burst = 1000;
+				system.simulate(0.0f);
+				REQUIRE(system.getParticleCount() == 100);
+
+				system.setMaxParticles(20);
+				REQUIRE(system.getParticleCount() == 20);
+			}
+
+			SECTION("Rate based emission") {
+				system.clearParticles();
+				system.getEmitter(0).rate = 50.0f;
+
+				system.simulate(0.1f);
+				REQUIRE(system.getParticleCount() == 5);
+			}
+
+			SECTION("Copies simulate independently") {
+				ParticleSystem copy = system;
+				REQUIRE(copy.getParticleCount() == 10);
+
+				copy.clearParticles();
+				REQUIRE(copy.getParticleCount() == 0);
+				REQUIRE(system.getParticleCount() == 10);
+
+				copy = system;
+				REQUIRE(copy.getParticleCount() == 10);
+			}
+		}
+	}//gfx
+}//mc
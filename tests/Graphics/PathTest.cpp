@@ -0,0 +1,93 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <catch2/catch.hpp>
+#include <MACE/Graphics/Path.h>
+
+namespace mc {
+	namespace gfx {
+		TEST_CASE("Testing Path hashing", "[path][graphics]") {
+			Path a = Path::rect(-1.0f, -1.0f, 2.0f, 2.0f);
+			Path b = Path::rect(-1.0f, -1.0f, 2.0f, 2.0f);
+
+			REQUIRE(a == b);
+			REQUIRE(a.getHash() == b.getHash());
+
+			b.lineTo(0.0f, 0.0f);
+			REQUIRE(a != b);
+			REQUIRE(a.getHash() != b.getHash());
+
+			b.clear();
+			REQUIRE(b.isEmpty());
+		}
+
+		TEST_CASE("Testing Path flattening", "[path][graphics]") {
+			std::vector<bool> closed;
+
+			SECTION("Lines are kept as-is") {
+				const auto contours = Path::rect(0.0f, 0.0f, 1.0f, 1.0f).flatten(0.01f, closed);
+
+				REQUIRE(contours.size() == 1);
+				REQUIRE(contours[0].size() == 4);
+				REQUIRE(closed.size() == 1);
+				REQUIRE(closed[0]);
+			}
+
+			SECTION("Curves stay within the tolerance") {
+				const auto contours = Path::circle(0.0f, 0.0f, 1.0f).flatten(0.001f, closed);
+
+				REQUIRE(contours.size() == 1);
+				REQUIRE(contours[0].size() > 16);
+				for (const auto& p : contours[0]) {
+					REQUIRE(std::sqrt(p[0] * p[0] + p[1] * p[1]) == Approx(1.0f).epsilon(0.01f));
+				}
+			}
+
+			SECTION("A smaller tolerance creates more points") {
+				const Path p = Path().moveTo(0.0f, 0.0f).quadraticTo(1.0f, 2.0f, 2.0f, 0.0f);
+
+				REQUIRE(p.flatten(0.1f, closed)[0].size() < p.flatten(0.001f, closed)[0].size());
+				REQUIRE_FALSE(closed[0]);
+			}
+		}
+
+		TEST_CASE("Testing Path tessellation", "[path][graphics]") {
+			PathMesh mesh = PathMesh();
+
+			SECTION("Filling without anti-aliasing") {
+				Path::rect(0.0f, 0.0f, 1.0f, 1.0f).tessellateFill(0.0f, mesh);
+
+				REQUIRE(mesh.getVertexCount() == 4);
+				REQUIRE(mesh.indices.size() == 6);
+				REQUIRE(mesh.textureCoordinates.size() == mesh.getVertexCount() * 2);
+			}
+
+			SECTION("Filling a concave shape") {
+				Path p = Path();
+				p.moveTo(0.0f, 0.0f).lineTo(2.0f, 0.0f).lineTo(2.0f, 2.0f).lineTo(1.0f, 1.0f).lineTo(0.0f, 2.0f).close();
+				p.tessellateFill(0.0f, mesh);
+
+				REQUIRE(mesh.indices.size() == 9);
+			}
+
+			SECTION("Filling with anti-aliasing adds a fringe") {
+				Path::rect(0.0f, 0.0f, 1.0f, 1.0f).tessellateFill(0.1f, mesh);
+
+				REQUIRE(mesh.getVertexCount() == 8);
+				REQUIRE(mesh.indices.size() == 6 + 4 * 6);
+			}
+
+			SECTION("Stroking an open path") {
+				Path().moveTo(0.0f, 0.0f).lineTo(1.0f, 0.0f).lineTo(1.0f, 1.0f).tessellateStroke(0.1f, 0.01f, mesh);
+
+				REQUIRE(mesh.getVertexCount() == 3 * 4);
+				REQUIRE(mesh.indices.size() == 2 * 3 * 6);
+				for (const unsigned int i : mesh.indices) {
+					REQUIRE(i < mesh.getVertexCount());
+				}
+			}
+		}
+	}//gfx
+}//mc
@@ -0,0 +1,61 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <catch2/catch.hpp>
+#include <MACE/Graphics/Context.h>
+
+#include <map>
+
+namespace mc {
+	namespace gfx {
+		TEST_CASE("Testing ResourceTable", "[context][graphics]") {
+			ResourceTable<int> table = ResourceTable<int>();
+
+			const ResourceID first = table.intern("first");
+			const ResourceID empty = table.intern("empty");
+			const ResourceID second = table.intern("second");
+
+			REQUIRE(table.intern("first") == first);
+			REQUIRE(table.find("second") == second);
+
+			table.set(first, 1);
+			table.set(second, 2);
+
+			REQUIRE(table.has(first));
+			REQUIRE_FALSE(table.has(empty));
+			REQUIRE(table.count("second") == 1);
+			REQUIRE(table.count("empty") == 0);
+			REQUIRE(table.at("second") == 2);
+
+			REQUIRE_THROWS_AS(table.get(empty), ObjectNotFoundError);
+			REQUIRE_THROWS_AS(table.at("missing"), ObjectNotFoundError);
+			REQUIRE_THROWS_AS(table.set(static_cast<ResourceID>(100), 3), ObjectNotFoundError);
+
+			SECTION("Iterating skips names without a resource") {
+				std::map<std::string, int> visited = std::map<std::string, int>();
+				for (const auto& resource : table) {
+					visited[resource.first] = resource.second;
+				}
+
+				REQUIRE(visited.size() == 2);
+				REQUIRE(visited["first"] == 1);
+				REQUIRE(visited["second"] == 2);
+
+				for (auto& resource : table) {
+					resource.second *= 10;
+				}
+				REQUIRE(table.get(second) == 20);
+			}
+
+			SECTION("Clearing forgets every name") {
+				table.clear();
+
+				REQUIRE(table.size() == 0);
+				REQUIRE(table.begin() == table.end());
+				REQUIRE(table.count("first") == 0);
+			}
+		}
+	}//gfx
+}//mc
@@ -0,0 +1,127 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <catch2/catch.hpp>
+#include <MACE/Graphics/SpatialIndex.h>
+#include <MACE/Graphics/Renderer.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace mc {
+	namespace gfx {
+		namespace {
+			class QuadEntity: public GraphicsEntity {
+			protected:
+				void onUpdate() override {}
+				void onInit() override {}
+				void onDestroy() override {}
+				void onRender(Painter&) override {}
+			};//QuadEntity
+
+			Bounds makeBounds(const float left, const float bottom, const float right, const float top) {
+				Bounds out = Bounds();
+				out.left = left;
+				out.bottom = bottom;
+				out.right = right;
+				out.top = top;
+				return out;
+			}
+
+			bool contains(const std::vector<SpatialIndex::Proxy>& proxies, const SpatialIndex::Proxy proxy) {
+				return std::find(proxies.begin(), proxies.end(), proxy) != proxies.end();
+			}
+		}//anon namespace
+
+		TEST_CASE("Testing SpatialIndex", "[spatialindex][graphics]") {
+			SpatialIndex index = SpatialIndex();
+			QuadEntity entities[3];
+
+			const SpatialIndex::Proxy a = index.insert(&entities[0], makeBounds(-1.0f, -1.0f, 0.0f, 0.0f));
+			const SpatialIndex::Proxy b = index.insert(&entities[1], makeBounds(-0.5f, -0.5f, 0.5f, 0.5f));
+			const SpatialIndex::Proxy c = index.insert(&entities[2], makeBounds(0.6f, 0.6f, 0.9f, 0.9f));
+
+			REQUIRE(index.size() == 3);
+			REQUIRE(index.getEntity(b) == &entities[1]);
+
+			std::vector<SpatialIndex::Proxy> hits = std::vector<SpatialIndex::Proxy>();
+
+			SECTION("Querying points") {
+				index.query(-0.25f, -0.25f, hits);
+				REQUIRE(hits.size() == 2);
+				REQUIRE(contains(hits, a));
+				REQUIRE(contains(hits, b));
+
+				hits.clear();
+				//inside the margin of c, but not its bounds
+				index.query(0.58f, 0.58f, hits);
+				REQUIRE(hits.empty());
+			}
+
+			SECTION("Querying areas") {
+				index.query(makeBounds(0.4f, 0.4f, 0.7f, 0.7f), hits);
+				REQUIRE(hits.size() == 2);
+				REQUIRE(contains(hits, b));
+				REQUIRE(contains(hits, c));
+			}
+
+			SECTION("Moving and removing proxies") {
+				REQUIRE_FALSE(index.move(c, makeBounds(0.61f, 0.61f, 0.91f, 0.91f)));
+				REQUIRE(index.move(c, makeBounds(-0.9f, 0.6f, -0.6f, 0.9f)));
+
+				index.query(0.75f, 0.75f, hits);
+				REQUIRE(hits.empty());
+				index.query(-0.75f, 0.75f, hits);
+				REQUIRE(hits.size() == 1);
+				REQUIRE(hits[0] == c);
+
+				index.remove(a);
+				REQUIRE(index.size() == 2);
+				REQUIRE(index.getEntity(a) == nullptr);
+
+				hits.clear();
+				index.query(-0.75f, -0.75f, hits);
+				REQUIRE(hits.empty());
+			}
+
+			SECTION("The tree stays balanced") {
+				index.clear();
+				REQUIRE(index.size() == 0);
+				REQUIRE(index.getHeight() == 0);
+
+				//inserting in order is the worst case for a tree that isn't balanced
+				for (Index i = 0; i < 1024; ++i) {
+					const float x = static_cast<float>(i) / 1024.0f;
+					index.insert(&entities[i % 3], makeBounds(x, 0.0f, x + 0.0005f, 0.0005f));
+				}
+
+				REQUIRE(index.size() == 1024);
+				REQUIRE(index.getHeight() <= 20);
+
+				index.query(512.0f / 1024.0f, 0.0f, hits);
+				REQUIRE(hits.size() == 1);
+			}
+
+			SECTION("Bounds from metrics") {
+				Metrics metrics = Metrics();
+				metrics.transform.translation[0] = 0.5f;
+				metrics.transform.scaler[0] = 0.25f;
+				metrics.transform.scaler[1] = 0.5f;
+
+				Bounds bounds = SpatialIndex::getBounds(metrics);
+				REQUIRE(bounds.left == Approx(0.25f));
+				REQUIRE(bounds.right == Approx(0.75f));
+				REQUIRE(bounds.bottom == Approx(-0.5f));
+				REQUIRE(bounds.top == Approx(0.5f));
+
+				//the parent scales the translation as well
+				metrics.inherited.scaler[0] = 2.0f;
+				bounds = SpatialIndex::getBounds(metrics);
+				REQUIRE(bounds.left == Approx(0.5f));
+				REQUIRE(bounds.right == Approx(1.5f));
+			}
+		}
+	}//gfx
+}//mc
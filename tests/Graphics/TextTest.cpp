@@ -0,0 +1,273 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <catch2/catch.hpp>
+#include <MACE/Graphics/Entity2D.h>
+
+#include <chrono>
+#include <thread>
+
+namespace mc {
+	namespace gfx {
+		TEST_CASE("Testing GlyphAtlas", "[text][graphics]") {
+			GlyphAtlas atlas = GlyphAtlas(64);
+
+			REQUIRE(atlas.getWidth() == 64);
+			REQUIRE(atlas.getHeight() == 16);
+			REQUIRE(atlas.getGlyphCount() == 0);
+			REQUIRE(atlas.getGlyph('a') == nullptr);
+
+			const std::vector<Byte> pixels = std::vector<Byte>(10 * 10 * 3, 255);
+
+			SECTION("Glyphs are packed into rows without overlapping") {
+				for (unsigned int i = 0; i < 5; ++i) {
+					atlas.addGlyph('a' + i, GlyphMetrics(), pixels.data(), 10, 10, 30);
+				}
+
+				REQUIRE(atlas.getGlyphCount() == 5);
+
+				const Glyph* first = atlas.getGlyph('a');
+				const Glyph* last = atlas.getGlyph('e');
+				REQUIRE(first != nullptr);
+				REQUIRE(last != nullptr);
+
+				REQUIRE(first->x == 0);
+				REQUIRE(first->y == 0);
+				REQUIRE(first->width == 10);
+				REQUIRE(atlas.getGlyph('b')->x == 11);
+
+				//only 5 padded glyphs fit in a row
+				REQUIRE(last->x == 44);
+				REQUIRE(last->y == 0);
+
+				atlas.addGlyph('f', GlyphMetrics(), pixels.data(), 10, 10, 30);
+				REQUIRE(atlas.getGlyph('f')->x == 0);
+				REQUIRE(atlas.getGlyph('f')->y == 11);
+			}
+
+			SECTION("The atlas grows when it runs out of room") {
+				const Index generation = atlas.getGeneration();
+
+				atlas.addGlyph('a', GlyphMetrics(), pixels.data(), 10, 10, 30);
+				REQUIRE(atlas.getGeneration() == generation);
+
+				atlas.addGlyph('b', GlyphMetrics(), pixels.data(), 60, 1, 180);
+				atlas.addGlyph('c', GlyphMetrics(), pixels.data(), 10, 10, 30);
+
+				REQUIRE(atlas.getHeight() == 32);
+				REQUIRE(atlas.getWidth() == 64);
+				REQUIRE(atlas.getGeneration() != generation);
+				REQUIRE(atlas.getGlyph('a')->y == 0);
+			}
+
+			SECTION("Empty glyphs only store metrics") {
+				GlyphMetrics metrics = GlyphMetrics();
+				metrics.advanceX = 5;
+
+				const Glyph& space = atlas.addGlyph(' ', metrics, nullptr, 0, 0, 0);
+				REQUIRE(space.width == 0);
+				REQUIRE(space.metrics.advanceX == 5);
+
+				atlas.addGlyph('a', GlyphMetrics(), pixels.data(), 10, 10, 30);
+				REQUIRE(atlas.getGlyph('a')->x == 0);
+			}
+
+			SECTION("Replacing a glyph") {
+				atlas.addGlyph('a', GlyphMetrics(), nullptr, 0, 0, 0);
+
+				const Index generation = atlas.getGeneration();
+
+				atlas.addGlyph('a', GlyphMetrics(), pixels.data(), 10, 10, 30);
+				REQUIRE(atlas.getGlyphCount() == 1);
+				REQUIRE(atlas.getGlyph('a')->width == 10);
+				REQUIRE(atlas.getGeneration() != generation);
+			}
+
+			SECTION("Glyphs wider than the atlas") {
+				const std::vector<Byte> wide = std::vector<Byte>(100 * 3, 0);
+
+				REQUIRE_THROWS(atlas.addGlyph('w', GlyphMetrics(), wide.data(), 100, 1, 300));
+			}
+		}
+
+		TEST_CASE("Testing distance field glyphs", "[text][graphics]") {
+			const Font font = Font(Fonts::SANS, 12);
+
+			const Glyph& glyph = font.getDistanceFieldGlyph('A');
+			REQUIRE(glyph.metrics.width > 0);
+			REQUIRE(glyph.metrics.height > 0);
+			//the spread is added to every side
+			REQUIRE(glyph.width > MACE__DISTANCE_FIELD_SPREAD * 2);
+			REQUIRE(glyph.height > MACE__DISTANCE_FIELD_SPREAD * 2);
+
+			REQUIRE(&font.getDistanceFieldGlyph('A') == &glyph);
+
+			const Glyph& space = font.getDistanceFieldGlyph(' ');
+			REQUIRE(space.width == 0);
+			REQUIRE(space.metrics.advanceX > 0);
+
+			//every size of a face shares the same distance field glyphs
+			REQUIRE(&Font(Fonts::SANS, 40).getDistanceFieldAtlas() == &font.getDistanceFieldAtlas());
+			REQUIRE(font.getDistanceFieldAtlas().getChannels() == 1);
+		}
+
+		TEST_CASE("Testing rasterizing glyphs in the background", "[text][graphics]") {
+			const Font font = Font(Fonts::SERIF, 12);
+			const GlyphAtlas& atlas = font.getDistanceFieldAtlas();
+
+			font.prepareDistanceFieldGlyphs('a', 'e');
+
+			//requested glyphs have metrics right away, but no pixels until they are rasterized
+			const Glyph requested = font.requestDistanceFieldGlyph('x');
+			REQUIRE(requested.metrics.width > 0);
+			REQUIRE(requested.width == 0);
+
+			REQUIRE(Font::getPendingGlyphCount() == 6);
+
+			for (unsigned int i = 0; i < 1000 && Font::getPendingGlyphCount() > 0; ++i) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+				Font::updateGlyphs();
+			}
+
+			REQUIRE(Font::getPendingGlyphCount() == 0);
+			REQUIRE(atlas.getGlyphCount() == 6);
+
+			const Glyph* prepared = atlas.getGlyph('c');
+			REQUIRE(prepared != nullptr);
+			REQUIRE(prepared->metrics.width > 0);
+			REQUIRE(prepared->width > MACE__DISTANCE_FIELD_SPREAD * 2);
+
+			REQUIRE(atlas.getGlyph('x')->width > MACE__DISTANCE_FIELD_SPREAD * 2);
+			REQUIRE(atlas.getGlyph('x')->metrics == requested.metrics);
+		}
+
+		TEST_CASE("Testing shared font faces", "[text][graphics]") {
+			//both hold a reference to the face, which is only destroyed once both are
+			Font first = Font(Fonts::CODE, 12);
+			Font second = Font(Fonts::CODE, 20);
+			REQUIRE(first.getID() == second.getID());
+
+			first.destroy();
+			REQUIRE(second.getDistanceFieldGlyph('a').width > MACE__DISTANCE_FIELD_SPREAD * 2);
+
+			second.destroy();
+
+			//a destroyed embedded font is loaded again the next time it is used
+			Font reloaded = Font(Fonts::CODE, 12);
+			REQUIRE(reloaded.getID() != first.getID());
+			REQUIRE(reloaded.getDistanceFieldGlyph('a').width > MACE__DISTANCE_FIELD_SPREAD * 2);
+
+			reloaded.destroy();
+		}
+
+		TEST_CASE("Testing destroying a font with glyphs in the background", "[text][graphics]") {
+			//no other test uses this face, and destroying it releases its decompressed data
+			Font font = Font(Fonts::CODE, 12);
+			font.prepareDistanceFieldGlyphs('!', '~');
+			REQUIRE(Font::getPendingGlyphCount() > 0);
+
+			//the rasterizer is most likely in the middle of one of its glyphs
+			font.destroy();
+			REQUIRE(Font::getPendingGlyphCount() == 0);
+
+			//glyphs that were already rasterized are thrown away, and the rasterizer keeps working for other faces
+			const Font other = Font(Fonts::SERIF, 12);
+			other.prepareDistanceFieldGlyphs('f', 'h');
+
+			for (unsigned int i = 0; i < 1000 && Font::getPendingGlyphCount() > 0; ++i) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+				Font::updateGlyphs();
+			}
+
+			REQUIRE(Font::getPendingGlyphCount() == 0);
+			REQUIRE(other.getDistanceFieldAtlas().getGlyph('g')->width > MACE__DISTANCE_FIELD_SPREAD * 2);
+		}
+
+		TEST_CASE("Testing TextLayout keys", "[text][graphics]") {
+			TextLayout::Key first = TextLayout::Key();
+			first.text = "label";
+			first.fontID = 2;
+			first.fontSize = 12;
+			first.dpi = {96, 96};
+			first.windowSize = {800, 600};
+
+			TextLayout::Key second = first;
+			REQUIRE(first == second);
+
+			second.fontSize = 13;
+			REQUIRE(first != second);
+
+			second = first;
+			second.windowSize = {800, 601};
+			REQUIRE(first != second);
+
+			second = first;
+			second.text = "labels";
+			REQUIRE(first != second);
+		}
+
+		TEST_CASE("Testing editing Text", "[text][graphics]") {
+			Text text = Text(L"first\nsecond");
+
+			text.append(L"\nthird");
+			REQUIRE(text.getText() == "first\nsecond\nthird");
+
+			text.insert(0, "zeroth\n");
+			REQUIRE(text.getText() == "zeroth\nfirst\nsecond\nthird");
+
+			text.erase(7, 6);
+			REQUIRE(text.getText() == "zeroth\nsecond\nthird");
+
+			text.append(L"");
+			text.erase(0, 0);
+			REQUIRE(text.getText() == "zeroth\nsecond\nthird");
+
+			SECTION("Positions are in bytes") {
+				text.setText("caf\xc3\xa9");
+				text.append(L"\u20ac");
+				REQUIRE(text.getText() == "caf\xc3\xa9\xe2\x82\xac");
+				REQUIRE(text.getWideText() == L"caf\u00e9\u20ac");
+
+				text.erase(3, 2);
+				REQUIRE(text.getText() == "caf\xe2\x82\xac");
+
+				//invalid UTF-8 is replaced instead of being laid out
+				text.insert(0, "\xff");
+				REQUIRE(text.getText() == "\xef\xbf\xbd" "caf\xe2\x82\xac");
+
+#ifdef MACE_DEBUG_CHECK_ARGS
+				REQUIRE_THROWS(text.insert(7, "!"));
+				REQUIRE_THROWS(text.erase(6, 1));
+#endif
+			}
+
+#ifdef MACE_DEBUG_CHECK_ARGS
+			REQUIRE_THROWS(text.insert(text.getText().length() + 1, L"!"));
+			REQUIRE_THROWS(text.erase(1, text.getText().length()));
+#endif
+		}
+
+		TEST_CASE("Testing wrapping Text", "[text][graphics]") {
+			Text text = Text("a long label that has to wrap");
+
+			REQUIRE(text.getMaxWidth() == 0.0f);
+			REQUIRE(text.getOverflow() == TextOverflow::WRAP);
+
+			text.setMaxWidth(0.25f);
+			text.setOverflow(TextOverflow::ELLIPSIS);
+			REQUIRE(text.getMaxWidth() == 0.25f);
+			REQUIRE(text.getOverflow() == TextOverflow::ELLIPSIS);
+
+			//changing how lines are broken doesn't change the text
+			REQUIRE(text.getText() == "a long label that has to wrap");
+
+#ifdef MACE_DEBUG_CHECK_ARGS
+			REQUIRE_THROWS(text.setMaxWidth(-1.0f));
+#endif
+		}
+	}//gfx
+}//mc
@@ -0,0 +1,57 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <catch2/catch.hpp>
+#include <MACE/Graphics/TileMap.h>
+
+namespace mc {
+	namespace gfx {
+		TEST_CASE("Testing TileMap", "[tilemap][graphics]") {
+			TileMap map = TileMap(100, 70, 4, 4);
+
+			REQUIRE(map.getColumns() == 100);
+			REQUIRE(map.getRows() == 70);
+			REQUIRE(map.getChunkCount() == 4);
+
+			SECTION("Maps start empty") {
+				REQUIRE(map.getTile(0, 0) == TileMap::EMPTY);
+				REQUIRE(map.getTile(99, 69) == TileMap::EMPTY);
+			}
+
+			SECTION("Setting and getting tiles") {
+				map.setTile(3, 5, 7);
+				map.setTile(70, 65, 2);
+
+				REQUIRE(map.getTile(3, 5) == 7);
+				REQUIRE(map.getTile(70, 65) == 2);
+				REQUIRE(map.getTile(5, 3) == TileMap::EMPTY);
+
+				map.setTile(3, 5, TileMap::EMPTY);
+				REQUIRE(map.getTile(3, 5) == TileMap::EMPTY);
+			}
+
+			SECTION("Filling the map") {
+				map.fill(1);
+
+				REQUIRE(map.getTile(0, 0) == 1);
+				REQUIRE(map.getTile(99, 69) == 1);
+				REQUIRE(map.getTile(64, 64) == 1);
+			}
+
+			SECTION("Atlas layout") {
+				map.setAtlasLayout(8, 2);
+
+				REQUIRE(map.getAtlasColumns() == 8);
+				REQUIRE(map.getAtlasRows() == 2);
+			}
+
+			SECTION("Out of bounds tiles") {
+				REQUIRE_THROWS(map.getTile(100, 0));
+				REQUIRE_THROWS(map.setTile(0, 70, 1));
+				REQUIRE_THROWS(map.setAtlasLayout(0, 1));
+			}
+		}
+	}//gfx
+}//mc
@@ -0,0 +1,80 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <catch2/catch.hpp>
+#include <MACE/Utility/Pool.h>
+
+namespace mc {
+	namespace {
+		struct Counted {
+			static int alive;
+
+			int value;
+
+			Counted(const int v) : value(v) {
+				++alive;
+			}
+
+			~Counted() {
+				--alive;
+			}
+		};
+
+		int Counted::alive = 0;
+	}
+
+	TEST_CASE("Testing Pool", "[utility][pool]") {
+		Pool<Counted, 4> pool;
+
+		const PoolHandle first = pool.create(1);
+		const PoolHandle second = pool.create(2);
+
+		REQUIRE(pool.size() == 2);
+		REQUIRE(Counted::alive == 2);
+		REQUIRE(pool.get(first)->value == 1);
+		REQUIRE(pool.get(second)->value == 2);
+
+		SECTION("Destroyed handles are invalid, even when their slot is reused") {
+			pool.destroy(first);
+
+			REQUIRE(Counted::alive == 1);
+			REQUIRE_FALSE(pool.isValid(first));
+			REQUIRE(pool.get(first) == nullptr);
+
+			const PoolHandle third = pool.create(3);
+			REQUIRE(third.index == first.index);
+			REQUIRE(third != first);
+			REQUIRE(pool.get(first) == nullptr);
+			REQUIRE(pool.get(third)->value == 3);
+
+			REQUIRE_THROWS(pool.destroy(first));
+		}
+
+		SECTION("Objects don't move when the pool grows") {
+			const Counted* address = pool.get(first);
+
+			for (int i = 0; i < 100; ++i) {
+				pool.create(i);
+			}
+
+			REQUIRE(pool.get(first) == address);
+			REQUIRE(pool.capacity() >= pool.size());
+
+			int sum = 0;
+			pool.forEach([&sum](Counted& c) {
+				sum += c.value;
+			});
+			REQUIRE(sum == 1 + 2 + 4950);
+		}
+
+		SECTION("Clearing") {
+			pool.clear();
+
+			REQUIRE(pool.size() == 0);
+			REQUIRE(Counted::alive == 0);
+			REQUIRE_FALSE(pool.isValid(second));
+		}
+	}
+}//mc
@@ -0,0 +1,54 @@
+/*
+Copyright (c) 2016-2019 Liav Turkia
+
+See LICENSE.md for full copyright information
+*/
+#include <catch2/catch.hpp>
+#include <MACE/Utility/Unicode.h>
+
+namespace mc {
+	TEST_CASE("Testing UTF-8 validation", "[utility][unicode]") {
+		REQUIRE(utf8::isValid(""));
+		REQUIRE(utf8::isValid("plain ascii that is longer than one sixteen byte chunk"));
+		REQUIRE(utf8::isValid("caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x8e"));
+
+		SECTION("Invalid sequences") {
+			//a continuation byte on its own
+			REQUIRE(utf8::validate(std::string("abc\x80")) == 3);
+			//truncated at the end of the string
+			REQUIRE(utf8::validate(std::string("0123456789abcdefghij\xe2\x82")) == 20);
+			//overlong encoding of '/'
+			REQUIRE(utf8::validate(std::string("\xc0\xaf")) == 0);
+			//surrogate
+			REQUIRE(utf8::validate(std::string("\xed\xa0\x80")) == 0);
+			//past U+10FFFF
+			REQUIRE(utf8::validate(std::string("\xf4\x90\x80\x80")) == 0);
+		}
+
+		SECTION("Sanitizing") {
+			REQUIRE(utf8::sanitize("caf\xc3\xa9") == "caf\xc3\xa9");
+			REQUIRE(utf8::sanitize("a\x80" "b\xe2\x82") == "a\xef\xbf\xbd" "b\xef\xbf\xbd");
+		}
+	}
+
+	TEST_CASE("Testing UTF-8 conversions", "[utility][unicode]") {
+		const std::string str = "A\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x8e";
+
+		REQUIRE(utf8::countCodepoints(str) == 4);
+
+		Index position = 0;
+		REQUIRE(utf8::decode(str.data(), position) == U'A');
+		REQUIRE(utf8::decode(str.data(), position) == U'é');
+		REQUIRE(utf8::decode(str.data(), position) == U'€');
+		REQUIRE(utf8::decode(str.data(), position) == U'\U0001F60E');
+		REQUIRE(position == str.length());
+
+		std::string encoded = std::string();
+		utf8::append(encoded, U'\U0001F60E');
+		REQUIRE(encoded == "\xf0\x9f\x98\x8e");
+
+		const std::wstring wide = L"Aé€\U0001F60E";
+		REQUIRE(utf8::fromWideString(wide) == str);
+		REQUIRE(utf8::toWideString(str) == wide);
+	}
+}//mc